@@ -2,16 +2,13 @@
 
 #include <SDL3/SDL.h>
 
+// Plain data base for hand-placed objects such as the player ship.
+// No virtual dispatch: subclasses provide their own update/render,
+// and bulk entities live in the ECS (Engine/ECS.hpp) instead.
 class Actor {
 public:
     Actor() = default;
-    virtual ~Actor() = default;
-
-    // default no-op; subclasses can override
-    virtual void update(float /*dt*/) {}
-
-    // must be implemented by subclasses
-    virtual void render(SDL_Renderer* renderer) = 0;
+    ~Actor() = default;
 
     void setPosition(float x, float y) { m_rect.x = x; m_rect.y = y; }
     void setSize(float w, float h)     { m_rect.w = w; m_rect.h = h; }
@@ -20,6 +17,7 @@ public:
 
     bool isAlive() const { return m_alive; }
     void kill()          { m_alive = false; }
+    void revive()        { m_alive = true; }
 
 protected:
     SDL_FRect m_rect{0.f, 0.f, 0.f, 0.f};
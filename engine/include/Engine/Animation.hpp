@@ -0,0 +1,120 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <vector>
+
+#include "Engine/SpriteSheet.hpp"
+
+namespace anim {
+
+// ------------------------------------------------------------
+// Animation clips
+//
+// A clip is a run of cells on a sprite sheet's frame grid,
+// numbered row-major, played at a fixed number of simulation
+// ticks per frame. The source rect of every frame is computed
+// once in define(); entities only keep a clip id and the tick
+// they started on, and the current frame is derived from the
+// global tick when it is needed.
+//
+// trim() cuts the frames of a clip down to the pixels they draw,
+// measured by a SpriteSheet; renderers that go through trimmed()
+// then fill only those.
+// ------------------------------------------------------------
+using ClipId = uint16_t;
+
+struct Clip {
+    uint32_t firstRect     = 0;   // index into the library's rect table
+    uint16_t frameCount    = 1;
+    uint16_t ticksPerFrame = 1;
+    bool     loop          = true;
+};
+
+class ClipLibrary {
+public:
+    // Frames [firstFrame, firstFrame + frameCount) of a sheet cut into
+    // frameWidth x frameHeight cells. frameCount is clamped to the
+    // cells the sheet actually has.
+    ClipId define(int sheetWidth, int sheetHeight, int frameWidth, int frameHeight,
+                  int firstFrame, int frameCount, uint32_t ticksPerFrame, bool loop);
+
+    // Same, reading the sheet size from the texture. Without a texture
+    // the clip is a single frameWidth x frameHeight cell.
+    ClipId define(SDL_Texture* sheet, int frameWidth, int frameHeight,
+                  int firstFrame, int frameCount, uint32_t ticksPerFrame, bool loop);
+
+    // One fixed rect; a zero-sized rect means "the whole texture"
+    ClipId still(const SDL_FRect& src);
+
+    // Frame of the clip 'now - startTick' ticks in. Looping clips wrap,
+    // others hold their last frame.
+    int frameIndex(ClipId clip, uint64_t startTick, uint64_t now) const
+    {
+        const Clip&    c       = m_clips[clip];
+        const uint64_t elapsed = now > startTick ? now - startTick : 0;
+        const uint64_t frame   = elapsed / c.ticksPerFrame;
+        if (c.loop) return static_cast<int>(frame % c.frameCount);
+        return frame < c.frameCount ? static_cast<int>(frame) : c.frameCount - 1;
+    }
+
+    // Source rect for SDL_RenderTexture; nullptr draws the whole texture
+    const SDL_FRect* src(ClipId clip, uint64_t startTick, uint64_t now) const
+    {
+        const SDL_FRect& r = m_rects[m_clips[clip].firstRect + frameIndex(clip, startTick, now)];
+        return r.w > 0.0f ? &r : nullptr;
+    }
+
+    // Cuts every frame of 'clip' down to what 'sheet' measured for it;
+    // frames that are not one cell of the sheet's grid stay whole
+    void trim(ClipId clip, const SpriteSheet& sheet);
+
+    // The current frame as trim() left it: the source rect (nullptr
+    // for the whole texture) and where it lands inside 'dst'. False
+    // when the frame draws nothing.
+    bool trimmed(ClipId clip, uint64_t startTick, uint64_t now, const SDL_FRect& dst,
+                 const SDL_FRect*& src, SDL_FRect& at) const
+    {
+        const size_t i = m_clips[clip].firstRect + frameIndex(clip, startTick, now);
+        const Trim&  t = m_trims[i];
+        if (t.cellWidth <= 0.0f) {
+            src = m_rects[i].w > 0.0f ? &m_rects[i] : nullptr;
+            at  = dst;
+            return true;
+        }
+        if (t.place.w <= 0.0f) return false;
+        // multiply before dividing: an unscaled draw moves by whole pixels exactly
+        src = &t.src;
+        at  = SDL_FRect{dst.x + t.place.x * dst.w / t.cellWidth, dst.y + t.place.y * dst.h / t.cellHeight,
+                        t.place.w * dst.w / t.cellWidth, t.place.h * dst.h / t.cellHeight};
+        return true;
+    }
+
+    // Ticks until a non-looping clip has shown its last frame
+    uint64_t duration(ClipId clip) const
+    {
+        const Clip& c = m_clips[clip];
+        return static_cast<uint64_t>(c.frameCount) * c.ticksPerFrame;
+    }
+
+    const Clip& clip(ClipId id) const { return m_clips[id]; }
+    size_t      clipCount() const     { return m_clips.size(); }
+
+    void clear();
+
+private:
+    // One per rect: the trimmed source, and its place inside a cell of
+    // cellWidth x cellHeight (0: not trimmed; an empty place: nothing drawn)
+    struct Trim {
+        SDL_FRect src{};
+        SDL_FRect place{};
+        float     cellWidth  = 0.0f;
+        float     cellHeight = 0.0f;
+    };
+
+    std::vector<Clip>      m_clips;
+    std::vector<SDL_FRect> m_rects;
+    std::vector<Trim>      m_trims;
+};
+
+} // namespace anim
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Engine/Cpu.hpp"
+
+#include <SDL3/SDL.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace audio {
+
+// ------------------------------------------------------------
+// Sound effects
+//
+// Sounds are decoded once when they are added: mono float samples
+// at SAMPLE_RATE, so mixing is a multiply-add per sample and never
+// converts or allocates. SDL pulls stereo float frames from an audio
+// stream whose callback runs mix() on SDL's audio thread.
+//
+// The game thread never touches mixer state. play() writes a command
+// into a single-producer single-consumer ring and the callback picks
+// the commands up at the start of its next block; a full ring drops
+// the command instead of waiting. When every voice is busy a new
+// sound takes over the voice with the lowest priority, oldest first,
+// unless all of them outrank it.
+//
+// Until the mixer is open play() does nothing, so a game without an
+// audio device does not need to check.
+// ------------------------------------------------------------
+
+using SoundId = uint16_t;
+inline constexpr SoundId NoSound = 0xFFFF;
+
+struct MixerStats {
+    uint64_t callbacks       = 0;
+    uint64_t frames          = 0;     // mixed by the callback
+    double   averageUs       = 0.0;   // callback time
+    double   maxUs           = 0.0;
+    uint64_t voicesStolen    = 0;
+    uint64_t soundsDropped   = 0;     // lost to voices of higher priority
+    uint64_t commandsDropped = 0;     // ring full
+    int      activeVoices    = 0;
+};
+
+class Mixer {
+public:
+    static constexpr int    SAMPLE_RATE = 48000;
+    static constexpr int    MAX_VOICES  = 32;
+    static constexpr size_t MAX_SOUNDS  = 256;
+
+    Mixer();
+    ~Mixer();
+
+    Mixer(const Mixer&)            = delete;
+    Mixer& operator=(const Mixer&) = delete;
+
+    // Opens the default playback device; needs SDL_INIT_AUDIO. False
+    // when there is no device, and the mixer stays silent.
+    bool open();
+
+    // Takes commands without a device; the caller runs mix() itself
+    void openOffline();
+
+    void close();
+    bool isOpen() const { return m_accepting.load(std::memory_order_relaxed); }
+
+    // WAV file, any format SDL reads; channels are averaged to mono.
+    // NoSound when it cannot be read or the table is full.
+    SoundId load(const char* path);
+
+    // Mono samples at SAMPLE_RATE, copied
+    SoundId add(const float* samples, size_t count);
+
+    size_t soundCount() const { return m_soundCount.load(std::memory_order_acquire); }
+
+    // Game thread only. 'pan' runs from -1 (left) to 1 (right); a higher
+    // 'priority' keeps the voice from being stolen by lower ones.
+    // False when the command was not queued.
+    bool play(SoundId sound, float volume = 1.0f, float pan = 0.0f, uint8_t priority = 0);
+    void stopAll();
+
+    // Applies pending commands and writes 'frames' interleaved stereo
+    // frames to 'out', with the widest kernel cpu::simd() allows.
+    // Called by the audio callback; after openOffline() the caller does.
+    void mix(float* out, int frames);
+
+    // Same, one voice at a time without SIMD; the reference for mix()
+    void mixScalar(float* out, int frames);
+
+    MixerStats stats() const;
+
+private:
+    struct Sound {
+        std::vector<float> samples;
+    };
+
+    enum class CommandType : uint8_t { Play, StopAll };
+
+    struct Command {
+        CommandType type;
+        uint8_t     priority;
+        SoundId     sound;
+        float       volume;
+        float       pan;
+    };
+
+    struct Voice {
+        const float* samples  = nullptr;   // nullptr: free
+        uint32_t     length   = 0;
+        uint32_t     position = 0;
+        float        gainLeft  = 0.0f;
+        float        gainRight = 0.0f;
+        uint64_t     started  = 0;         // order of play commands
+        uint8_t      priority = 0;
+    };
+
+    static constexpr uint32_t s_ringCapacity = 256;
+    static constexpr int      s_blockFrames  = 512;   // callback mixes in blocks of this
+
+    static void SDLCALL callback(void* userdata, SDL_AudioStream* stream, int additional, int total);
+
+    bool    post(const Command& c);
+    void    applyCommands();
+    void    start(const Command& c);
+    void    mixVoices(float* out, int frames, cpu::Simd level);
+
+    // written by add()/load() on the game thread before the count is
+    // published, then read only
+    std::array<Sound, MAX_SOUNDS> m_sounds;
+    std::atomic<size_t>           m_soundCount{0};
+
+    // command ring: head written by play(), tail by the mixer
+    std::unique_ptr<Command[]> m_ring;
+    std::atomic<uint32_t>      m_head{0};
+    std::atomic<uint32_t>      m_tail{0};
+
+    // mixer thread only
+    std::array<Voice, MAX_VOICES> m_voices{};
+    uint64_t                      m_started = 0;
+    std::vector<float>            m_block;   // one callback block, allocated once
+
+    SDL_AudioStream*  m_stream = nullptr;
+    std::atomic<bool> m_accepting{false};   // play() queues commands
+
+    // stats, written by the mixer thread and the producer
+    std::atomic<uint64_t> m_callbacks{0};
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<uint64_t> m_callbackNs{0};
+    std::atomic<uint64_t> m_maxCallbackNs{0};
+    std::atomic<uint64_t> m_stolen{0};
+    std::atomic<uint64_t> m_soundsDropped{0};
+    std::atomic<uint64_t> m_commandsDropped{0};
+    std::atomic<int>      m_active{0};
+};
+
+} // namespace audio
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// ------------------------------------------------------------
+// Minimal timing helpers for the --bench modes of the game.
+// ------------------------------------------------------------
+namespace bench {
+
+// Keeps a result alive so the optimiser cannot drop the work
+inline volatile uint64_t g_sink = 0;
+
+inline void keep(uint64_t value) { g_sink = g_sink + value; }
+
+// Average nanoseconds per call of fn(i) over 'iterations' calls
+template <typename Fn>
+double nsPerOp(uint64_t iterations, Fn&& fn)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / static_cast<double>(iterations);
+}
+
+inline void report(const char* name, double ns)
+{
+    std::printf("%-40s %10.1f ns/op\n", name, ns);
+}
+
+} // namespace bench
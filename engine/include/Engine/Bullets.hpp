@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Engine/Snapshot.hpp"
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bullet {
+
+// ------------------------------------------------------------
+// Bullet patterns
+//
+// Bullets are not entities. They live in one structure-of-arrays
+// pool holding position, velocity and pattern only; size, colour,
+// hit radius and what a bullet bursts into come from the pattern
+// table. Movement, culling and the hit test against the player are
+// flat loops over the pool, and the whole pool is drawn with one
+// SDL_RenderGeometry call.
+//
+// Emitters fire volleys of a pattern on a tick schedule. A ring
+// spreads its bullets over the full circle, a fan over 'spread'
+// degrees around its direction; 'spin' turns every volley a bit
+// further, which makes spirals. A pattern with a child makes each
+// of its bullets burst into an emitter of the child pattern
+// 'childDelay' ticks after it was fired.
+// ------------------------------------------------------------
+
+using PatternId = uint16_t;
+inline constexpr PatternId NoPattern = 0xFFFF;
+
+enum class Shape : uint8_t { Ring, Fan };
+
+struct Pattern {
+    Shape      shape      = Shape::Ring;
+    bool       aimed      = false;     // direction points at the target
+    uint16_t   count      = 8;         // bullets per volley
+    float      speed      = 200.0f;    // pixels per second
+    float      angle      = 90.0f;     // degrees, 0 = right, 90 = down
+    float      spread     = 60.0f;     // fan width in degrees
+    float      spin       = 0.0f;      // degrees added after each volley
+    uint32_t   interval   = 60;        // ticks between volleys, at least 1
+    uint32_t   volleys    = 1;         // 0 = until stopped
+    float      size       = 8.0f;      // drawn square, pixels
+    float      radius     = 3.0f;      // hit circle
+    SDL_FColor color{1.0f, 1.0f, 1.0f, 1.0f};
+    PatternId  child      = NoPattern;
+    uint32_t   childDelay = 0;         // ticks
+};
+
+struct EmitterId {
+    uint32_t index      = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool operator==(const EmitterId&) const = default;
+};
+
+class BulletSystem {
+public:
+    // Bullets beyond 'capacity' are not spawned (see dropped()), so
+    // the pool never reallocates once it is full
+    explicit BulletSystem(size_t capacity = 20000);
+
+    PatternId      define(const Pattern& p);
+    const Pattern& pattern(PatternId id) const { return m_patterns[id]; }
+
+    // First volley on the next update at or after 'now'. Emitters with
+    // a volley limit stop by themselves; their ids then go stale.
+    EmitterId start(PatternId pattern, float x, float y, uint64_t now);
+    void      moveEmitter(EmitterId id, float x, float y);
+    void      stop(EmitterId id);
+    bool      running(EmitterId id) const;
+
+    // Moves every bullet, drops those that left 'bounds', bursts the
+    // due ones and fires due volleys at 'target'
+    void update(float dt, uint64_t now, SDL_FPoint target, const SDL_FRect& bounds);
+
+    // Removes the bullets whose hit circle touches 'box'; returns how many
+    size_t collide(const SDL_FRect& box);
+
+    // Every bullet as a quad of 'src' within 'texture', tinted with
+    // its pattern's colour, in one draw call
+    void render(SDL_Renderer* r, SDL_Texture* texture, const SDL_FRect& src);
+
+    // Calls fn(rect) with the drawn square of every bullet
+    template <typename Fn>
+    void forEachRect(Fn&& fn) const
+    {
+        for (size_t i = 0; i < m_x.size(); ++i) {
+            const float size = m_patterns[m_pattern[i]].size;
+            fn(SDL_FRect{m_x[i] - size * 0.5f, m_y[i] - size * 0.5f, size, size});
+        }
+    }
+
+    void clearBullets();
+    void clear();   // bullets and emitters; patterns stay
+
+    size_t   size() const      { return m_x.size(); }
+    size_t   capacity() const  { return m_capacity; }
+    size_t   emitterCount() const;
+    uint64_t dropped() const   { return m_dropped; }
+
+    // Bullets and emitters; patterns are definitions and not saved
+    void save(snapshot::Writer& out) const;
+    bool load(snapshot::Reader& in);
+
+private:
+    struct Emitter {
+        float     x           = 0.0f;
+        float     y           = 0.0f;
+        float     turn        = 0.0f;   // accumulated spin, degrees
+        uint64_t  nextTick    = 0;
+        uint32_t  volleysLeft = 0;      // unused when the pattern repeats forever
+        uint32_t  generation  = 0;
+        PatternId pattern     = NoPattern;
+        bool      active      = false;
+    };
+
+    struct Burst {
+        float     x;
+        float     y;
+        PatternId pattern;
+    };
+
+    void fire(Emitter& e, SDL_FPoint target);
+    void spawn(float x, float y, float angle, const Pattern& p, PatternId id);
+    void retire(Emitter& e);
+    void removeAt(size_t i);
+    void resizePool(size_t n);
+
+    std::vector<Pattern>  m_patterns;
+    std::vector<Emitter>  m_emitters;
+    std::vector<uint32_t> m_freeEmitters;   // retired slots, reused first
+
+    // bullet pool, structure of arrays
+    std::vector<float>     m_x;
+    std::vector<float>     m_y;
+    std::vector<float>     m_vx;
+    std::vector<float>     m_vy;
+    std::vector<uint64_t>  m_burstTick;   // UINT64_MAX for patterns without a child
+    std::vector<PatternId> m_pattern;
+
+    size_t   m_capacity;
+    float    m_maxRadius = 0.0f;   // over all patterns
+    uint64_t m_now       = 0;      // tick of the update in progress
+    uint64_t m_dropped   = 0;
+
+    // scratch, reused every frame
+    std::vector<uint8_t>    m_flags;   // per bullet
+    std::vector<Burst>      m_bursts;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int>        m_indices;
+};
+
+} // namespace bullet
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace capture {
+
+// ------------------------------------------------------------
+// Frame capture to disk for QA recordings and bug reports
+//
+// The frame thread copies each finished frame into one of a few
+// RGBA buffers allocated when the capture starts and queues it; a
+// writer thread converts it and appends it to the file, then hands
+// the buffer back. The frame thread never waits for the disk: when
+// every buffer is still queued, the frame is dropped and counted.
+//
+// Y4M files are 4:2:0 BT.601 limited range, the conversion done on
+// the writer thread with SSE2 or NEON; any video tool reads them.
+// Raw files are the RGBA bytes of each frame back to back, for
+// pixel-exact comparisons; the size is in the log.
+//
+// Frames are written as they are presented, so the nominal frame
+// rate in the Y4M header is only right while the game keeps it.
+// ------------------------------------------------------------
+
+enum class Format : uint8_t {
+    Y4M,
+    RawRGBA
+};
+
+struct CaptureConfig {
+    std::string path;
+    Format      format  = Format::Y4M;
+    int         fps     = 60;   // written into the Y4M header
+    size_t      buffers = 6;    // frames that may wait for the writer
+};
+
+struct CaptureStats {
+    uint64_t captured = 0;   // handed to the writer
+    uint64_t written  = 0;
+    uint64_t dropped  = 0;   // no free buffer, or the frame changed size
+};
+
+// Y4M for paths ending in .y4m, raw RGBA otherwise
+Format formatFor(const std::string& path);
+
+// RGBA (bytes R, G, B, A) to I420 planes. Odd widths and heights
+// repeat the last column or row into the chroma average.
+void rgbaToI420(const uint8_t* rgba, size_t pitch, int width, int height,
+                uint8_t* y, uint8_t* u, uint8_t* v);
+
+// Same, one pixel at a time; the reference for rgbaToI420()
+void rgbaToI420Scalar(const uint8_t* rgba, size_t pitch, int width, int height,
+                      uint8_t* y, uint8_t* u, uint8_t* v);
+
+class Recorder {
+public:
+    Recorder() = default;
+    ~Recorder();
+
+    Recorder(const Recorder&)            = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // Opens the file and allocates every buffer; frames must then be
+    // width x height. False when the file cannot be created.
+    bool start(const CaptureConfig& config, int width, int height);
+
+    // Writes what is queued, then closes the file
+    void stop();
+
+    bool active() const { return m_file != nullptr; }
+
+    // Captures the renderer's current target; call before presenting.
+    // A no-op when the capture is not active.
+    void captureRenderer(SDL_Renderer* renderer);
+
+    // Captures a surface of any pixel format
+    void captureSurface(SDL_Surface* surface);
+
+    CaptureStats stats() const;
+    const CaptureConfig& config() const { return m_config; }
+
+private:
+    // Free buffer for the frame thread, or nullptr when the writer is behind
+    uint8_t* acquire();
+    void     submit(uint8_t* frame);
+    void     release(uint8_t* frame);   // back unwritten: the frame is dropped
+    bool     fill(uint8_t* frame, SDL_Surface* surface);
+
+    void writerLoop();
+    bool writeFrame(const uint8_t* frame);
+
+    CaptureConfig m_config;
+    int           m_width  = 0;
+    int           m_height = 0;
+    size_t        m_frameBytes = 0;
+    std::FILE*    m_file   = nullptr;
+
+    // one block of 'buffers' frames; a frame is free, being filled,
+    // queued or being written
+    std::unique_ptr<uint8_t[]> m_buffers;
+    std::vector<uint8_t*>      m_free;
+    std::vector<uint8_t*>      m_queued;    // oldest first
+    std::vector<uint8_t>       m_planes;    // writer thread: the converted frame
+
+    std::thread             m_writer;
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_wake;
+    bool                    m_stop = false;
+    bool                    m_failed = false;   // a write failed; later frames are dropped
+
+    CaptureStats m_stats;
+};
+
+} // namespace capture
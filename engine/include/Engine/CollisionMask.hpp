@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// ------------------------------------------------------------
+// 1-bit collision mask for every frame of a sprite sheet.
+//
+// Frames are laid out on a grid, row-major, like the sheets in
+// graphics/. Each frame row is packed into 64-bit words, bit 0
+// being the leftmost pixel. Words are stored block-major: for a
+// 64 pixel wide column block all rows of a frame are contiguous,
+// so the narrow-phase can load several rows with one SIMD load.
+// ------------------------------------------------------------
+class CollisionMask {
+public:
+    CollisionMask() = default;
+
+    // Builds masks from RGBA32 pixels; magenta (255, 0, 255) and
+    // fully transparent pixels are empty
+    static CollisionMask fromRGBA(const uint8_t* pixels, int pitch,
+                                  int sheetWidth, int sheetHeight,
+                                  int frameWidth, int frameHeight);
+
+    // Nearest-neighbour copy of one frame scaled to width x height,
+    // for sprites that are drawn stretched (e.g. the boss)
+    CollisionMask resampled(int frame, int width, int height) const;
+
+    bool empty() const { return m_frameCount == 0; }
+
+    int frameWidth()  const { return m_frameWidth; }
+    int frameHeight() const { return m_frameHeight; }
+    int frameCount()  const { return m_frameCount; }
+
+    // Frame index of a source rect taken from the sheet
+    int frameAt(const SDL_FRect& src) const;
+
+    bool testPixel(int frame, int x, int y) const;
+
+    // Words of one 64 pixel column block, one per frame row
+    const uint64_t* block(int frame, int blockIndex) const
+    {
+        return m_bits.data() + (static_cast<size_t>(frame) * m_blocks + blockIndex) * m_frameHeight;
+    }
+    int blocks() const { return m_blocks; }
+
+private:
+    int m_frameWidth  = 0;
+    int m_frameHeight = 0;
+    int m_frameCount  = 0;
+    int m_columns     = 0;   // frames per sheet row
+    int m_blocks      = 0;   // 64 pixel words per frame row
+
+    std::vector<uint64_t> m_bits;
+};
+
+// Pixel-accurate overlap of two mask frames placed at integer
+// positions. Callers run their AABB test first; this only walks
+// the intersection rows. Uses AVX2 on CPUs that have it
+// (cpu::simd()), otherwise SSE2 or NEON.
+bool masksOverlap(const CollisionMask& a, int frameA, int ax, int ay,
+                  const CollisionMask& b, int frameB, int bx, int by);
+
+// Portable reference of masksOverlap, used by the benchmark
+bool masksOverlapScalar(const CollisionMask& a, int frameA, int ax, int ay,
+                        const CollisionMask& b, int frameB, int bx, int by);
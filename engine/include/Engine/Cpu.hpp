@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Which vector kernels this CPU runs
+//
+// SSE2 and NEON are part of the x86-64 and AArch64 baselines and
+// are picked at compile time. AVX2 is not: the engine is built for
+// the baseline, so AVX2 kernels are compiled for it one function at
+// a time (CPU_AVX2_FN) and chosen at run time through simd().
+// ------------------------------------------------------------
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CPU_AVX2    1
+#define CPU_AVX2_FN __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define CPU_AVX2    1   // e.g. MSVC with /arch:AVX2
+#define CPU_AVX2_FN
+#else
+#define CPU_AVX2    0
+#endif
+
+namespace cpu {
+
+enum class Simd : uint8_t {
+    Scalar,
+    Vector128,   // SSE2 or NEON
+    Avx2
+};
+
+const char* simdName(Simd level);
+
+// The widest kernels this CPU and build can run
+Simd detected();
+
+// What the kernels use: detected(), capped by limitSimd()
+Simd simd();
+
+// Caps simd() so benchmarks can run the narrower paths on the same
+// input; kernels already running finish on the old level
+void limitSimd(Simd most);
+
+} // namespace cpu
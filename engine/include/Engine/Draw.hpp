@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Thin wrappers over the SDL draw calls that count what gets
+// submitted. Game code draws through these so the offscreen
+// benchmark (and anything else that cares) can report draw
+// calls and covered pixels per frame.
+// ------------------------------------------------------------
+namespace draw {
+
+struct Counters {
+    uint64_t drawCalls = 0;
+    uint64_t pixels    = 0;   // destination area submitted, before clipping
+};
+
+// one set per rendering thread
+inline thread_local Counters t_counters;
+
+inline Counters& counters()  { return t_counters; }
+inline void resetCounters()  { t_counters = Counters{}; }
+
+inline uint64_t area(SDL_Renderer* r, const SDL_FRect* dst)
+{
+    if (dst) return static_cast<uint64_t>(dst->w > 0.0f && dst->h > 0.0f ? dst->w * dst->h : 0.0f);
+    int w = 0, h = 0;
+    SDL_GetCurrentRenderOutputSize(r, &w, &h);
+    return static_cast<uint64_t>(w) * static_cast<uint64_t>(h);
+}
+
+inline bool texture(SDL_Renderer* r, SDL_Texture* tex, const SDL_FRect* src, const SDL_FRect* dst)
+{
+    ++t_counters.drawCalls;
+    t_counters.pixels += area(r, dst);
+    return SDL_RenderTexture(r, tex, src, dst);
+}
+
+inline bool fillRect(SDL_Renderer* r, const SDL_FRect* rect)
+{
+    ++t_counters.drawCalls;
+    t_counters.pixels += area(r, rect);
+    return SDL_RenderFillRect(r, rect);
+}
+
+// One call for a whole mesh; 'pixels' is the area it covers, which
+// only the caller knows
+inline bool geometry(SDL_Renderer* r, SDL_Texture* tex, const SDL_Vertex* vertices, int vertexCount,
+                     const int* indices, int indexCount, uint64_t pixels)
+{
+    ++t_counters.drawCalls;
+    t_counters.pixels += pixels;
+    return SDL_RenderGeometry(r, tex, vertices, vertexCount, indices, indexCount);
+}
+
+} // namespace draw
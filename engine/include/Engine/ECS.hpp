@@ -0,0 +1,384 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Snapshot.hpp"
+
+// ------------------------------------------------------------
+// Archetype ECS
+//
+// Entities with the same set of components share an archetype.
+// An archetype stores its rows in fixed-size chunks, one column
+// per component (structure of arrays), so a query walks plain
+// arrays with no virtual calls. Components must be trivially
+// copyable: rows are moved between chunks with memcpy. Empty
+// (tag) components take no column space.
+// ------------------------------------------------------------
+namespace ecs {
+
+using ComponentId   = uint32_t;
+using ComponentMask = uint64_t;
+
+static constexpr ComponentId MAX_COMPONENTS = 64;
+static constexpr size_t      CHUNK_BYTES    = 16 * 1024;
+
+struct Entity {
+    uint32_t index      = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity&) const = default;
+};
+
+inline constexpr Entity NullEntity{};
+
+namespace detail {
+    ComponentId registerComponent(size_t size, size_t align);
+    size_t      componentSize(ComponentId id);
+    ComponentId componentCount();
+
+    // bytes a component occupies in its column; tags have none
+    template <typename T>
+    inline constexpr size_t storedSize = std::is_empty_v<T> ? 0 : sizeof(T);
+
+    template <typename T>
+    struct ComponentType {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "ECS components are moved with memcpy and must be trivially copyable");
+
+        static ComponentId id()
+        {
+            static const ComponentId s_id = registerComponent(storedSize<T>, alignof(T));
+            return s_id;
+        }
+    };
+}
+
+// const T and T share one id; constness only matters for system access
+template <typename T>
+ComponentId componentId()
+{
+    return detail::ComponentType<std::remove_cv_t<T>>::id();
+}
+
+template <typename... Ts>
+ComponentMask maskOf()
+{
+    return (ComponentMask{0} | ... | (ComponentMask{1} << componentId<Ts>()));
+}
+
+struct Chunk {
+    std::byte* data  = nullptr;
+    uint32_t   count = 0;
+};
+
+struct Archetype {
+    ComponentMask mask     = 0;
+    uint32_t      capacity = 0;   // rows per chunk
+    uint32_t      size     = 0;   // live rows over all chunks
+
+    // byte offset of each column inside a chunk, -1 when absent;
+    // the entity column always sits at offset 0, and so do tag
+    // columns, which have a stride of 0
+    std::array<int32_t, MAX_COMPONENTS>  offset{};
+    std::array<uint32_t, MAX_COMPONENTS> stride{};
+
+    std::pmr::vector<ComponentId> components;
+    std::pmr::vector<Chunk>       chunks;   // every chunk but the last is full
+
+    explicit Archetype(std::pmr::memory_resource* resource)
+        : components(resource)
+        , chunks(resource)
+    {
+    }
+
+    Entity* entities(const Chunk& chunk) const
+    {
+        return reinterpret_cast<Entity*>(chunk.data);
+    }
+
+    template <typename T>
+    T* column(const Chunk& chunk) const
+    {
+        return reinterpret_cast<T*>(chunk.data + offset[componentId<T>()]);
+    }
+
+    std::byte* at(const Chunk& chunk, ComponentId id, uint32_t row) const
+    {
+        return chunk.data + offset[id] + static_cast<size_t>(stride[id]) * row;
+    }
+};
+
+// ------------------------------------------------------------
+// World: owns entities, archetypes and their chunks. Chunks and
+// bookkeeping come from 'resource', typically a level-lifetime
+// pool; it must outlive the world.
+// ------------------------------------------------------------
+class World {
+public:
+    explicit World(std::pmr::memory_resource* resource = std::pmr::new_delete_resource());
+    ~World();
+
+    World(const World&)            = delete;
+    World& operator=(const World&) = delete;
+
+    template <typename... Ts>
+    Entity create(const Ts&... components);
+
+    void destroy(Entity e);
+    bool isAlive(Entity e) const;
+
+    template <typename T> T*   get(Entity e);
+    template <typename T> bool has(Entity e) const;
+    template <typename T> void add(Entity e, const T& component);
+    template <typename T> void remove(Entity e);
+
+    // Structural changes are not allowed while a query iterates.
+    // Systems queue them here instead; flush() applies the queue.
+    template <typename... Ts>
+    void createDeferred(const Ts&... components);
+    void destroyDeferred(Entity e);
+    void flush();
+
+    // Destroys every entity but keeps archetypes, so cached queries stay valid
+    void clear();
+
+    // Every entity, generation and component as raw bytes. Deferred
+    // commands are not included; flush() first. Rows keep their order,
+    // so a loaded world iterates and allocates exactly like the saved one.
+    void save(snapshot::Writer& out) const;
+
+    // Replaces the contents with a save() from this process. On
+    // malformed data the world is left cleared and false is returned.
+    bool load(snapshot::Reader& in);
+
+    size_t entityCount() const { return m_liveCount; }
+
+    size_t     archetypeCount() const       { return m_archetypes.size(); }
+    Archetype& archetype(uint32_t index)    { return m_archetypes[index]; }
+
+private:
+    struct Record {
+        uint32_t archetype  = 0;
+        uint32_t chunk      = 0;
+        uint32_t row        = 0;
+        uint32_t generation = 0;
+        bool     alive      = false;
+    };
+
+    Entity     allocateEntity();
+    uint32_t   archetypeFor(ComponentMask mask);
+    void       insertRow(uint32_t archetype, Entity e);
+    void       removeRow(const Record& rec);
+    void       moveEntity(Entity e, ComponentMask newMask);
+    std::byte* componentPtr(const Record& rec, ComponentId id);
+    std::byte* allocateChunk();
+    void       releaseChunk(std::byte* data);
+
+    std::pmr::memory_resource* m_resource;
+
+    std::pmr::vector<Archetype>                       m_archetypes;
+    std::pmr::unordered_map<ComponentMask, uint32_t>  m_archetypeLookup;
+
+    std::pmr::vector<Record>   m_records;
+    std::pmr::vector<uint32_t> m_freeIndices;
+    size_t                     m_liveCount = 0;
+
+    std::pmr::vector<std::byte*> m_spareChunks;
+
+    // deferred commands: creates are a byte stream of
+    // [mask][componentCount] followed by [id][size][bytes] per component
+    std::pmr::vector<std::byte> m_pendingCreates;
+    std::pmr::vector<Entity>    m_pendingDestroys;
+};
+
+// ------------------------------------------------------------
+// Query: cached list of archetypes that contain all of Ts.
+// Only archetypes added since the last call are inspected.
+// ------------------------------------------------------------
+template <typename... Ts>
+class Query {
+public:
+    explicit Query(World& world)
+        : m_world(&world)
+        , m_mask(maskOf<Ts...>())
+    {
+    }
+
+    // fn(uint32_t count, const Entity* entities, Ts*... columns)
+    template <typename Fn>
+    void eachChunk(Fn&& fn)
+    {
+        refresh();
+        for (uint32_t index : m_matches) {
+            Archetype& arch = m_world->archetype(index);
+            for (const Chunk& chunk : arch.chunks) {
+                if (chunk.count == 0) continue;
+                fn(chunk.count, arch.entities(chunk), arch.template column<Ts>(chunk)...);
+            }
+        }
+    }
+
+    // fn(Entity, Ts&...)
+    template <typename Fn>
+    void each(Fn&& fn)
+    {
+        eachChunk([&fn](uint32_t count, const Entity* entities, Ts*... columns) {
+            for (uint32_t i = 0; i < count; ++i) {
+                fn(entities[i], columns[i]...);
+            }
+        });
+    }
+
+    size_t count()
+    {
+        refresh();
+        size_t n = 0;
+        for (uint32_t index : m_matches) n += m_world->archetype(index).size;
+        return n;
+    }
+
+private:
+    void refresh()
+    {
+        const size_t total = m_world->archetypeCount();
+        for (; m_seen < total; ++m_seen) {
+            const Archetype& arch = m_world->archetype(static_cast<uint32_t>(m_seen));
+            if ((arch.mask & m_mask) == m_mask) {
+                m_matches.push_back(static_cast<uint32_t>(m_seen));
+            }
+        }
+    }
+
+    World*                m_world;
+    ComponentMask         m_mask;
+    std::vector<uint32_t> m_matches;
+    size_t                m_seen = 0;
+};
+
+// ------------------------------------------------------------
+// Scheduler: systems declare which components they read and
+// write. Consecutive systems without conflicting access share a
+// stage; deferred commands are flushed between stages, so a
+// system always sees the structural changes of earlier stages.
+// ------------------------------------------------------------
+struct SystemAccess {
+    ComponentMask reads  = 0;
+    ComponentMask writes = 0;
+};
+
+// const T is a read, T is a write
+template <typename... Ts>
+SystemAccess accessOf()
+{
+    SystemAccess access;
+    (((std::is_const_v<Ts> ? access.reads : access.writes) |= (ComponentMask{1} << componentId<Ts>())), ...);
+    return access;
+}
+
+class Scheduler {
+public:
+    using SystemFn = std::function<void(World&, float)>;
+
+    void add(std::string name, SystemAccess access, SystemFn fn);
+
+    template <typename... Ts>
+    void add(std::string name, SystemFn fn)
+    {
+        add(std::move(name), accessOf<Ts...>(), std::move(fn));
+    }
+
+    void run(World& world, float dt);
+
+    size_t stageCount() const { return m_stages.size(); }
+
+private:
+    struct System {
+        std::string  name;
+        SystemAccess access;
+        SystemFn     fn;
+    };
+
+    static bool conflicts(const SystemAccess& a, const SystemAccess& b);
+
+    std::vector<System>                m_systems;
+    std::vector<std::vector<uint32_t>> m_stages;
+};
+
+// ------------------------------------------------------------
+// World template members
+// ------------------------------------------------------------
+template <typename... Ts>
+Entity World::create(const Ts&... components)
+{
+    const Entity e = allocateEntity();
+    insertRow(archetypeFor(maskOf<Ts...>()), e);
+
+    const Record& rec = m_records[e.index];
+    (std::memcpy(componentPtr(rec, componentId<Ts>()), &components, detail::storedSize<Ts>), ...);
+    return e;
+}
+
+template <typename T>
+T* World::get(Entity e)
+{
+    if (!isAlive(e)) return nullptr;
+    const Record& rec = m_records[e.index];
+    if (!(m_archetypes[rec.archetype].mask & maskOf<T>())) return nullptr;
+    return reinterpret_cast<T*>(componentPtr(rec, componentId<T>()));
+}
+
+template <typename T>
+bool World::has(Entity e) const
+{
+    return isAlive(e) && (m_archetypes[m_records[e.index].archetype].mask & maskOf<T>());
+}
+
+template <typename T>
+void World::add(Entity e, const T& component)
+{
+    if (!isAlive(e)) return;
+    const Record& rec = m_records[e.index];
+    moveEntity(e, m_archetypes[rec.archetype].mask | maskOf<T>());
+    std::memcpy(componentPtr(m_records[e.index], componentId<T>()), &component, detail::storedSize<T>);
+}
+
+template <typename T>
+void World::remove(Entity e)
+{
+    if (!isAlive(e)) return;
+    const Record& rec = m_records[e.index];
+    moveEntity(e, m_archetypes[rec.archetype].mask & ~maskOf<T>());
+}
+
+template <typename... Ts>
+void World::createDeferred(const Ts&... components)
+{
+    auto append = [this](const void* src, size_t bytes) {
+        const size_t at = m_pendingCreates.size();
+        m_pendingCreates.resize(at + bytes);
+        std::memcpy(m_pendingCreates.data() + at, src, bytes);
+    };
+
+    const ComponentMask mask  = maskOf<Ts...>();
+    const uint32_t      count = sizeof...(Ts);
+    append(&mask, sizeof(mask));
+    append(&count, sizeof(count));
+
+    auto appendComponent = [&append](ComponentId id, const void* data, uint32_t size) {
+        append(&id, sizeof(id));
+        append(&size, sizeof(size));
+        append(data, size);
+    };
+    (appendComponent(componentId<Ts>(), &components, static_cast<uint32_t>(detail::storedSize<Ts>)), ...);
+}
+
+} // namespace ecs
@@ -5,9 +5,31 @@
 #include <SDL3/SDL.h>
 #include <box2d/box2d.h>
 
+#include "Engine/Audio.hpp"
+#include "Engine/Capture.hpp"
+#include "Engine/FlightRecorder.hpp"
+#include "Engine/FrameGovernor.hpp"
+#include "Engine/Memory.hpp"
+#include "Engine/PhysicsScheduler.hpp"
+#include "Engine/SharedFrames.hpp"
 #include "Engine/TextureManager.hpp"
 
 
+// Numbers the engine publishes about the last completed frame
+struct FrameStats {
+    uint64_t frameIndex     = 0;
+    uint64_t allocations    = 0;   // system allocator calls (operator new + SDL)
+    uint64_t allocatedBytes = 0;
+    size_t   arenaBytes     = 0;   // FrameArena use at the end of the frame
+    uint64_t drawCalls      = 0;   // through the draw:: wrappers
+    double   workMs         = 0.0; // events + update + render, without the present wait
+    int      quality        = 0;   // FrameGovernor level; 0 = full, scale optional work down as it rises
+    double   physicsMs      = 0.0; // b2World_Step time of the batch that completed this frame
+    int      physicsSteps   = 0;   // Box2D steps in it; due steps with nothing awake are skipped
+    int      subSteps       = 0;   // of its last step
+    double   captureMs      = 0.0; // frame read-back while capturing or exporting; not part of workMs
+};
+
 // Info the engine gives to the game during init
 struct EngineContext {
     SDL_Window*    window   = nullptr;
@@ -16,9 +38,29 @@ struct EngineContext {
     int            width    = 0;
     int            height   = 0;
     TextureManager* textures = nullptr;
+
+    // sound effects; silent (but safe to call) without a device
+    audio::Mixer*   audio    = nullptr;
+
+    // hitch recorder; the game can publish a few counters per frame
+    flight::Recorder* recorder = nullptr;
+
+    // scratch memory that is reset after every frame
+    memory::FrameArena* frameArena = nullptr;
+    const FrameStats*   stats      = nullptr;
+
+    // fixed simulation steps (Engine::s_fixedTimeStep) since start
+    const uint64_t*     tick       = nullptr;
 };
 
 
+// What the game needs from the frame loop at the moment
+struct FramePacing {
+    bool  simulate  = true;   // fixed steps advance: engine tick, Box2D
+    float refreshHz = 0.0f;   // 0 = every display refresh; otherwise the engine
+                              // sleeps between frames and wakes early for input
+};
+
 // Interface that the game must implement
 class IGame {
 public:
@@ -36,6 +78,14 @@ public:
 
     // Called every frame to draw
     virtual void render(SDL_Renderer* renderer) = 0;
+
+    // Asked before every frame; a paused or finished game can let the
+    // engine idle instead of redrawing the same scene at full rate
+    virtual FramePacing pacing() { return {}; }
+
+    // Asked for every frame published to shared memory
+    // (Engine::startExport); 'out.tick' comes set to the engine tick
+    virtual void exportState(shm::GameState& out) { (void)out; }
 };
 
 // ------------------------------------------------------------
@@ -43,6 +93,8 @@ public:
 // ------------------------------------------------------------
 class Engine {
 public:
+    static constexpr float s_fixedTimeStep = 1.0f / 60.0f;
+
     Engine(int width, int height, const std::string& title, IGame& game);
     ~Engine();
 
@@ -50,27 +102,104 @@ public:
     void run();
     void shutdown();
 
+    // Steps Box2D on a worker thread, overlapped with rendering; the
+    // game then sees physics results one frame late. See physics::Scheduler.
+    void setAsyncPhysics(bool async) { m_physics.setAsync(async); }
+
+    // Frames longer than 'ms' dump the recent history into 'directory';
+    // 0 turns dumping off. See flight::Recorder.
+    void setHitchThreshold(float ms, const std::string& directory) { m_recorder.configure(ms, directory); }
+
+    // Records every presented frame to 'path' (.y4m, otherwise raw
+    // RGBA) until stopCapture(), shutdown or F10. See capture::Recorder.
+    bool startCapture(const std::string& path);
+    void stopCapture();
+
+    // Publishes every presented frame and IGame::exportState to the
+    // POSIX shared memory object 'name' (e.g. "/xenon") until
+    // stopExport() or shutdown; frames are drawn even while the window
+    // is hidden. See shm::Publisher; tools/export_reader reads it.
+    bool startExport(const std::string& name, int slots = 4);
+    void stopExport();
+
+    // Offscreen mode: SDL's software renderer drawing into a surface.
+    // Needs no window, display or GPU; used by the render benchmark.
+    bool initOffscreen();
+
+    struct OffscreenFrame {
+        double   submitMs  = 0.0;   // IGame::render + SDL_RenderPresent
+        uint64_t drawCalls = 0;
+        uint64_t pixels    = 0;     // destination area submitted
+        uint64_t checksum  = 0;     // FNV-1a over the finished framebuffer
+    };
+
+    // Advances the engine tick by one and renders a frame into the
+    // offscreen surface. Only valid after initOffscreen().
+    OffscreenFrame renderOffscreenFrame();
+
+    // Advances the engine tick by one and runs one fixed IGame::update
+    // with no events, physics or drawing: scripted simulation for
+    // benchmarks. Only valid after initOffscreen().
+    void stepOffscreen();
+
 private:
     bool initSDL();
+    bool initSoftwareRenderer();
     bool initBox2D();
+    bool initGame();
+    uint64_t framebufferChecksum();
 
+    bool windowHidden() const;
+    void waitForFrame(uint64_t lastFrameTicks);
     void processEvents(bool& running);
     void update(float dt);
     void render();
+    void present();
+    void syncPhysics();
+    void publishPhysics();
+    void governFrame(double workMs);
+    void endFrame(const memory::AllocationCounters& frameStart);
+    void toggleTrace();   // F9
+    void toggleCapture(); // F10
+    void captureFrame();
+    void exportFrame(SDL_Surface* frame);
 
     int         m_width;
     int         m_height;
     std::string m_title;
 
-    SDL_Window*   m_window   = nullptr;
-    SDL_Renderer* m_renderer = nullptr;
+    SDL_Window*   m_window    = nullptr;
+    SDL_Renderer* m_renderer  = nullptr;
+    SDL_Surface*  m_offscreen = nullptr;   // render target in offscreen mode
 
     b2WorldId m_world = b2_nullWorldId;
 
-    float                    m_accumulator    = 0.0f;
-    static constexpr float   s_fixedTimeStep  = 1.0f / 60.0f;
+    physics::Scheduler m_physics{physics::SchedulerConfig{s_fixedTimeStep}};
+    uint64_t           m_tick           = 0;
+    uint64_t           m_reportedDrops  = 0;   // catch-up steps already warned about
+    bool               m_simulating     = true;   // FramePacing::simulate of the last frame
+
+    // longest sleep while the window is hidden; events end it sooner
+    static constexpr int32_t s_hiddenWaitMs = 250;
 
     EngineContext  m_ctx{};
     IGame&         m_game;
     TextureManager m_textureManager;
+    audio::Mixer   m_audio;
+    flight::Recorder m_recorder;
+    capture::Recorder m_capture;
+    shm::Publisher    m_export;
+
+    memory::FrameArena m_frameArena;
+    FrameStats         m_stats{};
+    FrameGovernor      m_governor{s_fixedTimeStep * 1000.0};
+
+    // rolling allocation report, printed every s_allocReportFrames
+    static constexpr uint64_t s_allocReportFrames = 300;
+    uint64_t m_reportAllocations = 0;
+    uint64_t m_reportBytes       = 0;
+    uint64_t m_reportPeak        = 0;
+
+    unsigned m_traceCaptures = 0;
+    unsigned m_videoCaptures = 0;
 };
\ No newline at end of file
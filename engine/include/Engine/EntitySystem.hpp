@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Engine/ECS.hpp"
+
+// ------------------------------------------------------------
+// EntitySystem: a chunk loop put together from policies at
+// compile time.
+//
+// Components<Ts...> names the columns the system walks, const for
+// read-only as in Query. A policy is a small struct with
+//
+//     template <typename View> void run(const View& chunk, float dt);
+//
+// that works on whole columns: chunk.column<T>() is a plain T* of
+// chunk.count rows. Every policy runs on a chunk before the system
+// moves to the next one, so later policies find the chunk in cache.
+// The policies are template parameters, so their loops inline into
+// the system with no call per entity and the compiler is free to
+// vectorize them. The usual order is motion, animation, bounds,
+// render; a stage that is not needed is simply not listed.
+//
+// New kinds of entity need no new loop: anything with the
+// components is picked up by the query.
+// ------------------------------------------------------------
+namespace ecs {
+
+template <typename... Ts>
+struct Components {};
+
+template <typename... Ts>
+struct ChunkView {
+    uint32_t           count    = 0;
+    const Entity*      entities = nullptr;
+    std::tuple<Ts*...> columns;
+
+    // T or const T, whichever the system declared
+    template <typename T>
+    auto column() const
+    {
+        if constexpr ((std::is_same_v<T, Ts> || ...)) {
+            return std::get<T*>(columns);
+        } else {
+            return static_cast<const T*>(std::get<const T*>(columns));
+        }
+    }
+};
+
+template <typename Columns, typename... Policies>
+class EntitySystem;
+
+template <typename... Ts, typename... Policies>
+class EntitySystem<Components<Ts...>, Policies...> {
+public:
+    using View = ChunkView<Ts...>;
+
+    explicit EntitySystem(World& world, Policies... policies)
+        : m_query(world)
+        , m_policies(std::move(policies)...)
+    {
+    }
+
+    void run(float dt)
+    {
+        m_query.eachChunk([this, dt](uint32_t count, const Entity* entities, Ts*... columns) {
+            const View view{count, entities, std::tuple<Ts*...>{columns...}};
+            std::apply([&view, dt](Policies&... policies) { (policies.run(view, dt), ...); }, m_policies);
+        });
+    }
+
+    // Adds run() to a scheduler with the access of Ts; the system
+    // must outlive the scheduler
+    void addTo(Scheduler& scheduler, std::string name)
+    {
+        scheduler.add(std::move(name), accessOf<Ts...>(), [this](World&, float dt) { run(dt); });
+    }
+
+    template <typename P>
+    P& policy() { return std::get<P>(m_policies); }
+
+    size_t count() { return m_query.count(); }
+
+private:
+    Query<Ts...>            m_query;
+    std::tuple<Policies...> m_policies;
+};
+
+} // namespace ecs
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace flight {
+
+// ------------------------------------------------------------
+// Hitch flight recorder
+//
+// Always on. Keeps the last 'capacity' frames in a ring allocated
+// once: section timings, engine counters (allocations, draw calls,
+// physics), up to MAX_COUNTERS values the game publishes, and the
+// first input events of each frame. Recording a frame is a few
+// stores.
+//
+// When a frame takes longer than the threshold, the ring is copied
+// into a second buffer, also allocated up front, and a background
+// thread writes it to '<directory>/hitch-<frame>.xfr'. The hitch is
+// the last frame in the dump. A dump that comes while the previous
+// one is still being written, or within 'cooldownFrames' of it, is
+// skipped and counted. Frames before 'warmupFrames' never dump, as
+// start-up loading is slow on purpose.
+//
+// The file is a DumpHeader, the counter names, then the frames
+// oldest first, all little-endian PODs; readDump() loads one and
+// tools/hitch_report summarises them. The magic changes whenever
+// FrameRecord's layout does: "XFR2" added the capture section, and
+// readDump() converts "XFR1" dumps, which have no capture time.
+// ------------------------------------------------------------
+
+enum class Section : uint8_t {
+    Events,    // SDL_PollEvent + IGame::handleEvent
+    Update,    // fixed steps + IGame::update, inline physics included
+    Physics,   // b2World_Step of the batch that completed this frame
+    Render,    // IGame::render
+    Present,   // SDL_RenderPresent, vsync wait included
+    Capture,   // frame read-back for capture::Recorder and shm::Publisher
+    Count
+};
+
+inline constexpr size_t SECTION_COUNT = static_cast<size_t>(Section::Count);
+inline constexpr size_t MAX_COUNTERS  = 8;
+inline constexpr size_t MAX_EVENTS    = 4;   // per frame; the rest are only counted
+inline constexpr size_t NAME_LENGTH   = 24;
+
+const char* sectionName(Section s);
+
+using CounterId = uint8_t;
+
+struct InputEvent {
+    uint32_t type = 0;   // SDL_EventType
+    int32_t  code = 0;   // key, mouse or gamepad button
+};
+
+struct FrameRecord {
+    uint64_t   frameIndex     = 0;
+    uint64_t   tick           = 0;
+    uint64_t   startUs        = 0;   // since the recorder was created
+    uint64_t   allocations    = 0;
+    uint64_t   allocatedBytes = 0;
+    float      totalMs        = 0.0f;
+    float      sectionMs[SECTION_COUNT]{};
+    uint32_t   drawCalls      = 0;
+    uint32_t   arenaBytes     = 0;
+    uint16_t   physicsSteps   = 0;
+    uint8_t    quality        = 0;
+    uint8_t    eventCount     = 0;   // all of the frame's input events, saturating
+    uint32_t   counters[MAX_COUNTERS]{};
+    InputEvent events[MAX_EVENTS]{};
+};
+
+struct DumpHeader {
+    char     magic[4]     = {'X', 'F', 'R', '2'};
+    uint32_t frameCount   = 0;
+    uint32_t counterCount = 0;
+    float    thresholdMs  = 0.0f;
+    uint64_t hitchFrame   = 0;
+};
+
+static_assert(sizeof(FrameRecord) == 144, "FrameRecord is written raw and must not change size silently");
+static_assert(sizeof(DumpHeader) == 24);
+
+struct Dump {
+    DumpHeader               header;
+    std::vector<std::string> counterNames;
+    std::vector<FrameRecord> frames;   // oldest first; the last one is the hitch
+};
+
+// False when the file is missing, truncated or not a dump
+bool readDump(const std::string& path, Dump& out);
+
+struct RecorderConfig {
+    size_t      capacity       = 600;    // frames, 10 s at 60 Hz
+    float       thresholdMs    = 50.0f;  // 0 turns dumping off
+    uint64_t    warmupFrames   = 120;
+    uint64_t    cooldownFrames = 60;
+    std::string directory      = ".";
+};
+
+class Recorder {
+public:
+    explicit Recorder(const RecorderConfig& config = {});
+    ~Recorder();
+
+    Recorder(const Recorder&)            = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    void configure(float thresholdMs, const std::string& directory);
+    const RecorderConfig& config() const { return m_config; }
+
+    // Game counters, by name; the same name gives the same id.
+    // Set values stay until changed.
+    CounterId defineCounter(const char* name);
+    void      setCounter(CounterId id, uint32_t value);
+
+    // One frame: begin, then sections and events in any order, then end
+    void beginFrame(uint64_t frameIndex, uint64_t tick);
+    void section(Section s, double ms);
+    void event(const SDL_Event& e);   // keeps keyboard, mouse button and gamepad events
+
+    // Fills in the engine counters and dumps when the frame is long
+    void endFrame(double totalMs, uint64_t allocations, uint64_t allocatedBytes, uint64_t drawCalls,
+                  size_t arenaBytes, int physicsSteps, int quality);
+
+    size_t   recordedFrames() const { return m_count; }
+    uint64_t dumpsWritten() const;
+    uint64_t dumpsSkipped() const   { return m_skipped; }
+
+    // Blocks until a dump in progress is on disk
+    void waitForWriter();
+
+private:
+    void requestDump(uint64_t hitchFrame);
+    void writerLoop();
+    void writeDump();
+
+    RecorderConfig m_config;
+    std::chrono::steady_clock::time_point m_epoch;
+
+    std::unique_ptr<FrameRecord[]> m_ring;
+    size_t                         m_next  = 0;   // slot of the frame being recorded
+    size_t                         m_count = 0;   // valid frames, up to capacity
+    FrameRecord*                   m_frame = nullptr;
+
+    std::array<char[NAME_LENGTH], MAX_COUNTERS> m_counterNames{};
+    uint32_t                                    m_counterValues[MAX_COUNTERS]{};
+    size_t                                      m_counterCount = 0;
+
+    uint64_t m_lastDumpFrame = 0;
+    bool     m_dumped        = false;
+    uint64_t m_skipped       = 0;
+
+    // writer thread; the dump buffer belongs to it while m_writing is set
+    std::unique_ptr<FrameRecord[]> m_dumpFrames;
+    DumpHeader                     m_dumpHeader{};
+    std::string                    m_dumpPath;
+    std::thread                    m_writer;
+    mutable std::mutex             m_mutex;
+    std::condition_variable        m_wake;
+    std::condition_variable        m_idle;
+    bool                           m_writing = false;
+    bool                           m_stop    = false;
+    uint64_t                       m_written = 0;
+};
+
+} // namespace flight
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+// ------------------------------------------------------------
+// FrameGovernor: turns recent frame times into a quality level
+// that game systems use to scale optional work (background
+// layers, particles, effect caps). Level 0 is full quality;
+// each step up cuts more.
+//
+// The input is the frame's work time, without the vsync wait,
+// smoothed over recent frames. The level drops one step when the
+// average stays near the budget, and comes back only when it has
+// been well under the budget for longer. A restore that has to
+// be taken back soon after makes the next one wait twice as long,
+// so a box that is just at the edge settles instead of flip-flopping.
+// ------------------------------------------------------------
+class FrameGovernor {
+public:
+    static constexpr int LEVEL_COUNT = 4;
+
+    explicit FrameGovernor(double budgetMs);
+
+    // Feeds one frame; returns true if the level changed
+    bool addFrame(double workMs);
+
+    int    level() const     { return m_level; }
+    double averageMs() const { return m_averageMs; }
+    double budgetMs() const  { return m_budgetMs; }
+
+    static const char* levelName(int level);   // "full", "reduced", ...
+
+private:
+    static constexpr double   s_smoothing     = 0.1;    // weight of the newest frame
+    static constexpr double   s_degradeAt     = 0.9;    // of the budget
+    static constexpr double   s_restoreAt     = 0.6;
+    static constexpr uint32_t s_degradeFrames = 30;     // sustained, ~0.5 s at 60 Hz
+    static constexpr uint32_t s_restoreFrames = 180;    // ~3 s
+    static constexpr uint32_t s_maxRestore    = 7200;   // backoff ceiling, ~2 min
+
+    double   m_budgetMs;
+    double   m_averageMs = 0.0;
+    int      m_level     = 0;
+
+    uint32_t m_overFrames    = 0;
+    uint32_t m_underFrames   = 0;
+    uint32_t m_restoreAfter  = s_restoreFrames;
+    uint32_t m_sinceRestore  = UINT32_MAX;   // frames since the last step back up
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace logging {
+
+// ------------------------------------------------------------
+// Asynchronous logging
+//
+// LOG_INFO("[Engine] %d frames", n) formats straight into a slot
+// of a lock-free ring owned by the calling thread; a background
+// writer drains the rings to stderr or a file. Callers never wait
+// on I/O: when a ring is full the message is dropped and counted.
+//
+// Levels below XENON_LOG_LEVEL are compiled out, arguments and
+// all: 0 debug, 1 info, 2 warn, 3 error, 4 nothing. The default is
+// debug in debug builds and info otherwise.
+// ------------------------------------------------------------
+enum class Level : uint8_t { Debug, Info, Warn, Error };
+
+// Sends output to 'path' instead of stderr; an empty path goes
+// back to stderr. Messages already queued are written first.
+bool setOutput(const std::string& path);
+
+// Blocks until every message queued so far is written
+void flush();
+
+// Flushes, stops the writer thread and goes back to stderr; logging
+// afterwards starts the writer again. Also runs at exit.
+void shutdown();
+
+// Messages thrown away because a thread's ring was full
+uint64_t droppedMessages();
+
+namespace detail {
+    void write(Level level, const char* fmt, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+}
+
+} // namespace logging
+
+#if !defined(XENON_LOG_LEVEL)
+#if defined(NDEBUG)
+#define XENON_LOG_LEVEL 1
+#else
+#define XENON_LOG_LEVEL 0
+#endif
+#endif
+
+#if XENON_LOG_LEVEL <= 0
+#define LOG_DEBUG(...) ::logging::detail::write(::logging::Level::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if XENON_LOG_LEVEL <= 1
+#define LOG_INFO(...) ::logging::detail::write(::logging::Level::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if XENON_LOG_LEVEL <= 2
+#define LOG_WARN(...) ::logging::detail::write(::logging::Level::Warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if XENON_LOG_LEVEL <= 3
+#define LOG_ERROR(...) ::logging::detail::write(::logging::Level::Error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace memory {
+
+// ------------------------------------------------------------
+// Allocation tracking
+//
+// The engine replaces the global operator new/delete and hooks
+// SDL's allocator, so every trip to the system allocator is
+// counted. Engine::run diffs the totals once per frame.
+// ------------------------------------------------------------
+struct AllocationCounters {
+    uint64_t allocations = 0;
+    uint64_t bytes       = 0;   // requested by those allocations
+    uint64_t frees       = 0;
+    uint64_t resizes     = 0;   // SDL_realloc of a live block; the old size is unknown, so not in bytes
+};
+
+// Process-wide totals since startup
+AllocationCounters allocationCounters();
+
+// Routes SDL_malloc & co. through the counters.
+// Must run before SDL allocates anything, i.e. before SDL_Init.
+void installSDLAllocationHooks();
+
+// ------------------------------------------------------------
+// FrameArena: monotonic bump allocator for data that only lives
+// until the end of the current frame. Engine::run resets it after
+// every iteration. If a frame outgrows the buffer, the overflow
+// comes from the system allocator (and shows up in the counters)
+// until the next reset.
+// ------------------------------------------------------------
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t capacity = 256 * 1024);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Drops everything allocated since the last reset
+    void reset();
+
+    // printf into the arena; valid until the next reset()
+    std::string_view format(const char* fmt, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    size_t used() const      { return m_offset; }
+    size_t highWater() const { return m_highWater; }
+    size_t capacity() const  { return m_capacity; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void  do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    struct Overflow {
+        void*  ptr;
+        size_t alignment;
+    };
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t                       m_capacity  = 0;
+    size_t                       m_offset    = 0;
+    size_t                       m_highWater = 0;
+    std::vector<Overflow>        m_overflow;
+};
+
+} // namespace memory
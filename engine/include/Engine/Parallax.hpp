@@ -0,0 +1,75 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Snapshot.hpp"
+
+class TextureManager;
+
+namespace parallax {
+
+// ------------------------------------------------------------
+// Parallax background: layers of scattered sprites scrolling down
+// at constant speeds, each baked once into a screen-sized texture.
+//
+// A layer's particles never move relative to each other, so
+// scrolling is only a source offset into the tile: the layer is
+// drawn as two strips (one when the offset is zero), whatever its
+// density. Particles that cross an edge are baked on the opposite
+// side as well, so the tile repeats without a seam.
+//
+// Layers are drawn in the order they were added; add the deepest
+// (slowest) first.
+// ------------------------------------------------------------
+
+struct LayerDesc {
+    SDL_Texture* sprite = nullptr;
+    int          count  = 20;      // particles baked into the tile
+    float        size   = 32.0f;   // drawn width and height of each
+    float        speed  = 50.0f;   // pixels per second, downwards
+    uint8_t      alpha  = 255;     // of the whole layer
+    uint32_t     seed   = 1;       // placement; the same seed bakes the same tile
+};
+
+class Background {
+public:
+    // Tiles are width x height and owned by 'textures'
+    void init(TextureManager& textures, SDL_Renderer* renderer, int width, int height);
+
+    // Bakes a layer; false when the sprite is missing or the tile
+    // cannot be created
+    bool addLayer(const LayerDesc& desc);
+
+    void scroll(float dt);
+    void resetScroll();
+
+    // Draws the last 'layers' layers added, i.e. the nearest ones;
+    // the deepest are the first to go when fewer are asked for
+    void render(SDL_Renderer* renderer, size_t layers = SIZE_MAX) const;
+
+    size_t layerCount() const { return m_layers.size(); }
+
+    // Scroll offsets only; the tiles are baked from the descriptions
+    void save(snapshot::Writer& out) const;
+    bool load(snapshot::Reader& in);
+
+private:
+    struct Layer {
+        SDL_Texture* tile   = nullptr;
+        float        speed  = 0.0f;
+        float        offset = 0.0f;   // [0, height): screen row of the tile's first row
+    };
+
+    void bake(SDL_Texture* tile, const LayerDesc& desc);
+
+    TextureManager*    m_textures = nullptr;
+    SDL_Renderer*      m_renderer = nullptr;
+    int                m_width    = 0;
+    int                m_height   = 0;
+    std::vector<Layer> m_layers;
+};
+
+} // namespace parallax
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace path {
+
+// ------------------------------------------------------------
+// Movement paths
+//
+// A path is a curve (line, sine sweep, spline) sampled once per
+// simulation tick when it is defined, and stored as offsets from
+// the follower's origin in one structure-of-arrays table. Moving
+// an entity is then a table lookup at 'now - startTick', so every
+// follower of every path goes through the same short loop at the
+// same cost, whatever the curve was.
+//
+// Followers whose start tick lies in the future wait at the start
+// of the path, so formations are the same path with staggered
+// start ticks and origins.
+// ------------------------------------------------------------
+using PathId = uint16_t;
+
+struct Path {
+    uint32_t firstSample = 0;   // index into the library's sample tables
+    uint32_t ticks       = 1;   // samples - 1, at least 1
+    bool     loop        = false;
+};
+
+// Plain data, usable as an ECS component
+struct Follower {
+    float    originX   = 0.0f;
+    float    originY   = 0.0f;
+    uint64_t startTick = 0;
+    PathId   path      = 0;
+    uint8_t  reserved[6]{};   // explicit, so no padding bytes
+};
+
+// Straight move from one point to another between two ticks, for
+// moves decided at run time (scripts). Plain data like Follower;
+// holds the end point once it is reached.
+struct Glide {
+    float    fromX     = 0.0f;
+    float    fromY     = 0.0f;
+    float    toX       = 0.0f;
+    float    toY       = 0.0f;
+    uint64_t startTick = 0;
+    uint64_t endTick   = 0;
+
+    SDL_FPoint position(uint64_t now) const
+    {
+        if (now >= endTick) return SDL_FPoint{toX, toY};
+        if (now <= startTick) return SDL_FPoint{fromX, fromY};
+        const float t = static_cast<float>(now - startTick) / static_cast<float>(endTick - startTick);
+        return SDL_FPoint{fromX + (toX - fromX) * t, fromY + (toY - fromY) * t};
+    }
+};
+
+class PathLibrary {
+public:
+    // Straight line to (dx, dy)
+    PathId line(float dx, float dy, uint32_t ticks, bool loop = false);
+
+    // Travels to (dx, dy) while swinging 'amplitude' pixels to either
+    // side of the line, 'cycles' full periods over the path
+    PathId sineSweep(float dx, float dy, float amplitude, float cycles, uint32_t ticks, bool loop = false);
+
+    // Catmull-Rom spline through 'points' (offsets, the first usually
+    // 0,0), each segment getting an equal share of the ticks
+    PathId spline(const SDL_FPoint* points, size_t count, uint32_t ticks, bool loop = false);
+
+    // Offset 'now - startTick' ticks in. Non-looping paths hold their
+    // last point.
+    SDL_FPoint offset(PathId path, uint64_t startTick, uint64_t now) const
+    {
+        const size_t i = sampleIndex(m_paths[path], startTick, now);
+        return SDL_FPoint{m_x[i], m_y[i]};
+    }
+
+    // Position of one follower; the reference for evaluate()
+    SDL_FPoint position(const Follower& f, uint64_t now) const
+    {
+        const SDL_FPoint o = offset(f.path, f.startTick, now);
+        return SDL_FPoint{f.originX + o.x, f.originY + o.y};
+    }
+
+    // Positions of 'count' followers in one pass, e.g. an ECS chunk
+    void evaluate(size_t count, const Follower* followers, uint64_t now, SDL_FPoint* out) const;
+
+    uint32_t ticks(PathId path) const  { return m_paths[path].ticks; }
+    size_t   pathCount() const         { return m_paths.size(); }
+    size_t   sampleCount() const       { return m_x.size(); }
+
+    void clear();
+
+private:
+    static size_t sampleIndex(const Path& p, uint64_t startTick, uint64_t now)
+    {
+        // a looping path's last sample is its first again, so it wraps at 'ticks'
+        const uint64_t elapsed = now > startTick ? now - startTick : 0;
+        const uint64_t t       = p.loop ? elapsed % p.ticks : (elapsed < p.ticks ? elapsed : p.ticks);
+        return p.firstSample + static_cast<size_t>(t);
+    }
+
+    PathId add(const Path& p);
+
+    std::vector<Path>  m_paths;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+};
+
+} // namespace path
@@ -5,13 +5,13 @@
 class Pawn : public Actor {
 public:
     Pawn() = default;
-    ~Pawn() override = default;
+    ~Pawn() = default;
 
     void setVelocity(float vx, float vy) { m_velocity.x = vx; m_velocity.y = vy; }
     SDL_FPoint getVelocity() const { return m_velocity; }
 
     // default behaviour: move according to velocity
-    void update(float dt) override {
+    void update(float dt) {
         m_rect.x += m_velocity.x * dt;
         m_rect.y += m_velocity.y * dt;
     }
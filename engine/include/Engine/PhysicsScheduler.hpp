@@ -0,0 +1,106 @@
+#pragma once
+
+#include <box2d/box2d.h>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace physics {
+
+// ------------------------------------------------------------
+// Decides when and how Box2D steps.
+//
+// Fixed steps come out of an accumulator, but at most
+// maxStepsPerFrame per frame: after a stall the rest of the backlog
+// is dropped instead of being simulated in one burst. A step is
+// skipped when no body is awake, which covers an empty world. The
+// substep count rises with the fastest moving body, so that nothing
+// moves more than travelPerSubStep within a substep, and drops when
+// the awake bodies times substeps would exceed the budget.
+//
+// In async mode launch() hands the frame's steps to a worker thread
+// and returns; the world belongs to that thread until sync(). The
+// engine syncs at the start of every frame and launches after
+// IGame::update, so the step overlaps rendering and presenting and
+// the game sees its results one frame later. Nothing may touch the
+// world between launch() and sync().
+// ------------------------------------------------------------
+
+struct SchedulerConfig {
+    float timeStep          = 1.0f / 60.0f;
+    int   maxStepsPerFrame  = 4;
+    int   subSteps          = 4;        // Box2D's recommendation, when nothing calls for more or less
+    int   minSubSteps       = 2;        // floor for big crowds
+    int   maxSubSteps       = 8;        // ceiling for fast bodies
+    float travelPerSubStep  = 0.25f;    // world units
+    int   subStepBudget     = 16384;    // awake bodies x substeps per step
+};
+
+// One batch of steps: a frame's worth in sync mode, the batch that
+// finished at the sync point in async mode
+struct StepReport {
+    int    steps      = 0;     // Box2D steps run
+    int    skipped    = 0;     // due, but nothing was awake
+    int    subSteps   = 0;     // of the last step run
+    int    awake      = 0;     // bodies, before the last step
+    double ms         = 0.0;   // spent in b2World_Step, on whichever thread
+};
+
+class Scheduler {
+public:
+    explicit Scheduler(const SchedulerConfig& config = {});
+    ~Scheduler();
+
+    Scheduler(const Scheduler&)            = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    void setWorld(b2WorldId world);
+
+    // Starts or stops the worker; syncs first
+    void setAsync(bool async);
+    bool async() const { return m_worker.joinable(); }
+
+    // Adds dt and returns the fixed steps due this frame, capped
+    int advance(float dt);
+
+    // Runs 'steps' steps on the calling thread
+    void step(int steps);
+
+    // Async mode: runs 'steps' steps on the worker. Falls back to
+    // step() when there is no worker.
+    void launch(int steps);
+
+    // Waits for the launched batch; the world is the caller's again
+    void sync();
+
+    // Substeps for a step with these awake bodies and top speed
+    int subStepsFor(int awake, float maxSpeed) const;
+
+    const SchedulerConfig& config() const { return m_config; }
+    const StepReport&      report() const { return m_report; }   // valid after step() or sync()
+    uint64_t               droppedSteps() const { return m_droppedSteps; }
+
+private:
+    void runBatch(int steps);
+    void workerLoop();
+
+    SchedulerConfig m_config;
+    b2WorldId       m_world = b2_nullWorldId;
+
+    float    m_accumulator  = 0.0f;
+    uint64_t m_droppedSteps = 0;
+    float    m_maxSpeed     = 0.0f;   // fastest moved body after the last step
+
+    StepReport m_report{};
+
+    // worker; m_pending is -1 when idle
+    std::thread             m_worker;
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    int                     m_pending = -1;
+    bool                    m_stop    = false;
+};
+
+} // namespace physics
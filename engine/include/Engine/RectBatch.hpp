@@ -0,0 +1,94 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ------------------------------------------------------------
+// Broad-phase box tests
+//
+// All tests here follow SDL_HasRectIntersectionFloat exactly:
+// rects with a negative width or height never intersect, and
+// rects that only touch along an edge or corner do.
+// ------------------------------------------------------------
+
+// Inline equivalent of SDL_HasRectIntersectionFloat, same operations
+// in the same order so the results agree bit for bit
+inline bool rectsIntersect(const SDL_FRect& a, const SDL_FRect& b)
+{
+    if (a.w < 0.0f || a.h < 0.0f || b.w < 0.0f || b.h < 0.0f) return false;
+
+    float amin = a.x, amax = a.x + a.w;
+    float bmin = b.x, bmax = b.x + b.w;
+    if (bmin > amin) amin = bmin;
+    if (bmax < amax) amax = bmax;
+    if (amax < amin) return false;
+
+    amin = a.y; amax = a.y + a.h;
+    bmin = b.y; bmax = b.y + b.h;
+    if (bmin > amin) amin = bmin;
+    if (bmax < amax) amax = bmax;
+    if (amax < amin) return false;
+
+    return true;
+}
+
+// Sets bit i of 'hits' when 'a' intersects rect i of the SoA arrays
+// and clears it otherwise. 'hits' must hold (n + 63) / 64 words.
+// Runs 8 rects per step with AVX2 on CPUs that have it (cpu::simd()),
+// 4 with SSE2 or NEON.
+void rectOverlapMask(const SDL_FRect& a,
+                     const float* x, const float* y, const float* w, const float* h,
+                     size_t n, uint64_t* hits);
+
+// Reference version, one rect at a time
+void rectOverlapMaskScalar(const SDL_FRect& a,
+                           const float* x, const float* y, const float* w, const float* h,
+                           size_t n, uint64_t* hits);
+
+// Packed structure-of-arrays of rects for one-vs-many tests
+class RectBatch {
+public:
+    void clear()          { m_x.clear(); m_y.clear(); m_w.clear(); m_h.clear(); }
+    size_t size() const   { return m_x.size(); }
+    bool empty() const    { return m_x.empty(); }
+    size_t words() const  { return (size() + 63) / 64; }
+
+    void push(const SDL_FRect& r)
+    {
+        m_x.push_back(r.x);
+        m_y.push_back(r.y);
+        m_w.push_back(r.w);
+        m_h.push_back(r.h);
+    }
+
+    // Bitmask of the rects 'a' intersects; resizes 'hits' to words()
+    void overlaps(const SDL_FRect& a, std::vector<uint64_t>& hits) const
+    {
+        hits.resize(words());
+        rectOverlapMask(a, m_x.data(), m_y.data(), m_w.data(), m_h.data(), size(), hits.data());
+    }
+
+private:
+    std::vector<float> m_x, m_y, m_w, m_h;
+};
+
+// Calls fn(index) for every set bit, lowest index first
+template <typename Fn>
+void forEachHit(const std::vector<uint64_t>& hits, Fn&& fn)
+{
+    for (size_t word = 0; word < hits.size(); ++word) {
+        uint64_t bits = hits[word];
+        while (bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long bit;
+            _BitScanForward64(&bit, bits);
+#else
+            const int bit = __builtin_ctzll(bits);
+#endif
+            fn(word * 64 + static_cast<size_t>(bit));
+            bits &= bits - 1;
+        }
+    }
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Engine/Snapshot.hpp"
+#include "Engine/TimerWheel.hpp"
+
+namespace script {
+
+// ------------------------------------------------------------
+// Behaviour scripts as C++20 coroutines
+//
+//     script::Task XenonGame::lonerFire(ecs::Entity self)
+//     {
+//         while (alive(self)) {
+//             fire(...);
+//             co_await script::wait(1.5f);
+//         }
+//     }
+//
+// A Task does nothing until Runtime::start() gives it a wake tick.
+// Sleeping scripts wait on a timer::Wheel, so run(now) touches only
+// the scripts that are due, in the order they went to sleep; the
+// rest cost nothing per tick. A script sleeps from the tick it woke
+// on, so one run() that covers several ticks loses no time.
+//
+// Frames come from a pool owned by the runtime instead of the heap,
+// and a resume allocates nothing, so thousands of scripted entities
+// cost no allocations once the pool has warmed up. A frame goes back
+// to the pool it came from, whichever thread frees it, so a runtime
+// can move between threads (VecEnv sessions do) as long as one
+// thread uses it at a time. Only frames made inside start(make),
+// load() or a script's own resume come from the pool; a Task made
+// anywhere else lives on the heap.
+//
+// Snapshots cannot hold a coroutine, so a script is saved as its
+// Tag and wake tick, and load() asks the game to start it again
+// from the top. Scripts are written to allow that: at every co_await
+// they keep nothing in locals that the world does not also hold, and
+// they find out where they are from the world when they start.
+// ------------------------------------------------------------
+
+class Runtime;
+
+struct ScriptId {
+    uint32_t index      = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool operator==(const ScriptId&) const = default;
+};
+
+// What a script is, for snapshots: a game-defined kind and argument
+// (e.g. an entity) that together start it again
+struct Tag {
+    uint16_t kind = 0;
+    uint64_t arg  = 0;
+};
+
+class Task {
+public:
+    struct promise_type {
+        Runtime* runtime = nullptr;
+        uint32_t slot    = 0;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void* operator new(size_t size);
+        static void  operator delete(void* frame, size_t size);
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    ~Task()
+    {
+        if (m_handle) m_handle.destroy();
+    }
+
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+
+    explicit operator bool() const { return static_cast<bool>(m_handle); }
+    Handle   release()             { return std::exchange(m_handle, {}); }
+
+private:
+    Handle m_handle;
+};
+
+// co_await: sleeps at least one tick, then resumes in the run() that
+// reaches the wake tick
+struct Wait {
+    float    seconds = 0.0f;
+    uint64_t ticks   = 0;       // used when 'inTicks' is set
+    bool     inTicks = false;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Task::Handle handle) const;
+    void await_resume() const noexcept {}
+};
+
+inline Wait wait(float seconds)      { return Wait{seconds, 0, false}; }
+inline Wait waitTicks(uint64_t ticks) { return Wait{0.0f, ticks, true}; }
+
+class Runtime {
+public:
+    // 'capacity' scripts fit without growing the tables
+    explicit Runtime(float tickSeconds, size_t capacity = 1024);
+    ~Runtime();
+
+    Runtime(const Runtime&)            = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    // First resume in the run() that reaches 'wakeTick'
+    ScriptId start(Task task, uint64_t wakeTick, Tag tag = {});
+
+    // The same for make(), whose frame comes from this runtime's pool:
+    //     runtime.start([&] { return lonerFire(e); }, wakeTick, tag);
+    template <typename Make>
+        requires std::invocable<Make&>
+    ScriptId start(Make&& make, uint64_t wakeTick, Tag tag = {})
+    {
+        FrameSource source(*this);
+        return start(make(), wakeTick, tag);
+    }
+
+    // Destroys the script; one that stops itself ends when it next suspends
+    void stop(ScriptId id);
+    void stopAll();
+    bool running(ScriptId id) const;
+
+    // Resumes every script whose wake tick is <= now
+    void run(uint64_t now);
+
+    uint64_t now() const      { return m_wakes.now(); }
+    size_t   count() const    { return m_count; }
+    uint64_t resumes() const  { return m_resumes; }
+    uint64_t ticksFor(float seconds) const;
+
+    // Bytes the frame pool holds: live frames and free blocks
+    size_t poolBytes() const;
+
+    // The clock, then tags and wake ticks in wake order
+    void save(snapshot::Writer& out) const;
+
+    // Stops everything and starts make(tag) for every saved script
+    template <typename Make>
+    bool load(snapshot::Reader& in, Make&& make);
+
+private:
+    friend struct Wait;
+    friend struct Task::promise_type;
+    struct FramePool;
+
+    static thread_local FramePool* s_framePool;   // set by FrameSource
+
+    // Frames allocated while one is alive come from the runtime's pool
+    class FrameSource {
+    public:
+        explicit FrameSource(Runtime& runtime);
+        ~FrameSource();
+
+        FrameSource(const FrameSource&)            = delete;
+        FrameSource& operator=(const FrameSource&) = delete;
+
+    private:
+        FramePool* m_previous;
+    };
+
+    struct Slot {
+        Task::Handle   handle;
+        Tag            tag;
+        timer::TimerId wake;       // the timer's argument is the slot
+        uint32_t       generation = 0;
+        bool           stopping   = false;
+    };
+
+    void sleep(uint32_t slot, uint64_t ticks);
+    void resume(uint32_t slot);
+    void finish(uint32_t slot);
+
+    std::unique_ptr<FramePool>            m_pool;   // before anything holding frames
+    float                                 m_tickSeconds;
+    std::vector<Slot>                     m_slots;
+    std::vector<uint32_t>                 m_freeSlots;
+    timer::Wheel                          m_wakes;
+    mutable std::vector<timer::Wheel::Pending> m_saveOrder;   // reused by save()
+    uint64_t                              m_resumes = 0;
+    size_t                                m_count   = 0;
+    uint32_t                              m_current = 0xFFFFFFFFu;   // slot being resumed
+};
+
+template <typename Make>
+bool Runtime::load(snapshot::Reader& in, Make&& make)
+{
+    stopAll();
+
+    uint64_t now   = 0;
+    uint32_t count = 0;
+    in.get(now);
+    in.get(count);
+    m_wakes.reset(now);
+    FrameSource source(*this);
+    for (uint32_t i = 0; i < count && in.ok(); ++i) {
+        Tag      tag;
+        uint64_t wakeTick = 0;
+        in.get(tag.kind);
+        in.get(tag.arg);
+        in.get(wakeTick);
+        if (!in.ok()) break;
+
+        Task task = make(tag);
+        if (task) start(std::move(task), wakeTick, tag);
+    }
+    return in.ok();
+}
+
+} // namespace script
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace shm {
+
+// ------------------------------------------------------------
+// Frames and game state in POSIX shared memory for local tools
+//
+// The engine publishes every presented frame, RGBA32, with a small
+// state block from the game into a ring of 'slots' frames in a
+// shm_open() object; bots, dashboards and recorders map the same
+// object and read the pixels where they are. There is no socket and
+// no copy on the consumer side.
+//
+// The game never waits for a reader. Each slot carries its frame's
+// sequence number, set to WRITING while the slot is rewritten, and
+// the header the sequence of the newest finished frame. A reader
+// takes the newest frame, uses it in place, then asks whether it is
+// still valid: with N slots the game needs N - 1 more frames to
+// come round to it again, and a reader that fell that far behind
+// has read a torn frame and drops it. Frames a slow reader never
+// got to are skipped, not queued; the sequence numbers show how
+// many.
+//
+// The layout below is the protocol: fixed-size fields only, and
+// VERSION goes up when it changes.
+// ------------------------------------------------------------
+
+inline constexpr uint32_t MAGIC   = 0x4D485358u;   // "XSHM"
+inline constexpr uint32_t VERSION = 1;
+inline constexpr uint64_t WRITING = ~uint64_t{0};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring needs address-free atomics");
+
+// What the game reports with each frame (IGame::exportState)
+struct GameState {
+    uint64_t tick       = 0;   // simulation tick the frame shows
+    int32_t  phase      = 0;   // game-defined, e.g. playing or game over
+    int32_t  score      = 0;
+    int32_t  lives      = 0;
+    float    shipX      = 0.0f;
+    float    shipY      = 0.0f;
+    float    shipW      = 0.0f;
+    float    shipH      = 0.0f;
+    uint32_t entities   = 0;
+    uint32_t enemies    = 0;
+    uint32_t bullets    = 0;
+};
+static_assert(sizeof(GameState) == 48);
+
+// At offset 0 of the shared object
+struct RingHeader {
+    uint32_t magic     = MAGIC;
+    uint32_t version   = VERSION;
+    uint32_t width     = 0;
+    uint32_t height    = 0;    // frames are width * 4 bytes a row, no padding
+    uint32_t slotCount = 0;
+    uint32_t slotBytes = 0;    // from one SlotHeader to the next
+    std::atomic<uint64_t> latest{0};   // sequence of the newest finished frame; 0 before the first
+    std::atomic<uint64_t> closed{0};   // 1 once the game has stopped publishing
+};
+
+// Before the pixels of every slot
+struct SlotHeader {
+    std::atomic<uint64_t> sequence{0};   // of the frame held, WRITING, or 0 when never written
+    uint64_t  frameIndex = 0;            // FrameStats::frameIndex
+    GameState state;
+};
+
+inline constexpr size_t SLOT_HEADER_BYTES = 64;   // pixels start a cache line in
+static_assert(sizeof(SlotHeader) <= SLOT_HEADER_BYTES);
+
+// ------------------------------------------------------------
+// Game side
+// ------------------------------------------------------------
+
+class Publisher {
+public:
+    Publisher() = default;
+    ~Publisher();
+
+    Publisher(const Publisher&)            = delete;
+    Publisher& operator=(const Publisher&) = delete;
+
+    // Creates (or replaces) the shared object 'name', e.g. "/xenon",
+    // sized for 'slots' width x height frames. False when shared
+    // memory is unavailable.
+    bool start(const std::string& name, int width, int height, int slots = 4);
+
+    // Marks the ring closed and removes the name; mapped readers keep
+    // what they have
+    void stop();
+
+    bool active() const { return m_header != nullptr; }
+
+    // Copies 'surface' (any pixel format, the ring's size) into the
+    // next slot with 'state' and publishes it. False, and nothing
+    // published, when the surface does not fit.
+    bool publish(SDL_Surface* surface, uint64_t frameIndex, const GameState& state);
+
+    uint64_t published() const { return m_sequence; }
+
+private:
+    std::string m_name;
+    RingHeader* m_header   = nullptr;
+    size_t      m_bytes    = 0;
+    uint64_t    m_sequence = 0;   // of the last frame published
+};
+
+// ------------------------------------------------------------
+// Consumer side
+// ------------------------------------------------------------
+
+// A frame in the ring, read in place
+struct FrameView {
+    uint64_t       sequence   = 0;
+    uint64_t       frameIndex = 0;
+    GameState      state;            // copied: valid even if the pixels are not
+    const uint8_t* pixels     = nullptr;
+    int            width      = 0;
+    int            height     = 0;
+    int            pitch      = 0;
+};
+
+class Reader {
+public:
+    Reader() = default;
+    ~Reader();
+
+    Reader(const Reader&)            = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    // Maps an existing ring read-only. False when there is none or it
+    // speaks another version.
+    bool open(const std::string& name);
+    void close();
+
+    bool isOpen() const { return m_header != nullptr; }
+    bool closed() const;   // the game has stopped publishing
+
+    // The newest frame after 'after' (a sequence; 0 for any), or false
+    // when there is none yet
+    bool latest(FrameView& out, uint64_t after = 0) const;
+
+    // Whether the pixels of 'frame' are still the ones it was taken
+    // with; check after using them
+    bool valid(const FrameView& frame) const;
+
+    int width() const;
+    int height() const;
+
+private:
+    const SlotHeader* slot(uint64_t sequence) const;
+
+    const RingHeader* m_header = nullptr;
+    size_t            m_bytes  = 0;
+};
+
+} // namespace shm
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------
+// Snapshots: game state written as plain bytes, for rollback,
+// instant restart and save states within one running process.
+// Values are copied raw, so pointers stay valid only inside the
+// process that wrote them; this is not a file format.
+//
+// Write padding-free values (scalars, or structs without holes):
+// hash() covers every byte, and padding would make equal states
+// hash differently.
+// ------------------------------------------------------------
+namespace snapshot {
+
+// 64-bit hash of a byte range. Four independent lanes of eight
+// bytes each, so the multiplies overlap instead of forming one chain.
+inline uint64_t hash(const void* data, size_t size)
+{
+    constexpr uint64_t K0 = 0x9E3779B97F4A7C15ull;
+    constexpr uint64_t K1 = 0xFF51AFD7ED558CCDull;
+    constexpr uint64_t K2 = 0xC4CEB9FE1A85EC53ull;
+
+    auto load = [](const unsigned char* p) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        return w;
+    };
+    auto mix = [](uint64_t h, uint64_t w) {
+        h = (h ^ w) * K1;
+        return h ^ (h >> 29);
+    };
+
+    const auto* p = static_cast<const unsigned char*>(data);
+    uint64_t lane[4] = {K0 ^ size, K1, K2, K0 + K1};
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        lane[0] = mix(lane[0], load(p + i));
+        lane[1] = mix(lane[1], load(p + i + 8));
+        lane[2] = mix(lane[2], load(p + i + 16));
+        lane[3] = mix(lane[3], load(p + i + 24));
+    }
+    uint64_t h = lane[0] ^ (lane[1] * K2) ^ (lane[2] * K0) ^ (lane[3] * K1);
+    for (; i + 8 <= size; i += 8) {
+        h = mix(h, load(p + i));
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p + i, size - i);
+    h = mix(h, tail) * K2;
+
+    h ^= h >> 33;
+    h *= K1;
+    h ^= h >> 33;
+    return h;
+}
+
+// Allocator that leaves grown storage uninitialised: the writer
+// overwrites every byte anyway, and zeroing first would double the
+// memory traffic of a save.
+template <typename T>
+struct UninitializedAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind { using other = UninitializedAllocator<U>; };
+
+    UninitializedAllocator() = default;
+    template <typename U>
+    UninitializedAllocator(const UninitializedAllocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+using Buffer = std::vector<std::byte, UninitializedAllocator<std::byte>>;
+
+class Writer {
+public:
+    explicit Writer(Buffer& out) : m_out(out) {}
+
+    void bytes(const void* data, size_t size)
+    {
+        if (size == 0) return;
+        const size_t at = m_out.size();
+        m_out.resize(at + size);
+        std::memcpy(m_out.data() + at, data, size);
+    }
+
+    template <typename T>
+    void put(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes(&value, sizeof(T));
+    }
+
+    // Space for 'size' bytes the caller fills in place
+    std::byte* reserve(size_t size)
+    {
+        const size_t at = m_out.size();
+        m_out.resize(at + size);
+        return m_out.data() + at;
+    }
+
+private:
+    Buffer& m_out;
+};
+
+class Reader {
+public:
+    Reader(const std::byte* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+    bool bytes(void* out, size_t size)
+    {
+        if (!m_ok || static_cast<size_t>(m_end - m_cursor) < size) return m_ok = false;
+        if (size > 0) std::memcpy(out, m_cursor, size);
+        m_cursor += size;
+        return true;
+    }
+
+    template <typename T>
+    bool get(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return bytes(&value, sizeof(T));
+    }
+
+    // Borrow 'size' bytes without copying; nullptr when short
+    const std::byte* take(size_t size)
+    {
+        if (!m_ok || static_cast<size_t>(m_end - m_cursor) < size) {
+            m_ok = false;
+            return nullptr;
+        }
+        const std::byte* at = m_cursor;
+        m_cursor += size;
+        return at;
+    }
+
+    bool ok() const        { return m_ok; }
+    bool finished() const  { return m_cursor == m_end; }
+
+private:
+    const std::byte* m_cursor;
+    const std::byte* m_end;
+    bool             m_ok = true;
+};
+
+} // namespace snapshot
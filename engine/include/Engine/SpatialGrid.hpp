@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Engine/ECS.hpp"
+
+#include <SDL3/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace spatial {
+
+// ------------------------------------------------------------
+// Spatial index for gameplay queries: nearest entities, everything
+// within a radius, first entity along a segment.
+//
+// A hashed uniform grid. Each entity sits in the one cell that holds
+// the centre of its rect, linked into that cell's bucket, so moving
+// it is O(1) and usually just a rect store. Queries widen their cell
+// range by the largest half extent seen, which keeps big rects
+// findable from the cells they overlap without storing them twice.
+// Cells hash into a fixed bucket table, so the world is unbounded.
+//
+// Distances are from the query point to the nearest point of the
+// rect, 0 inside it. Results are ordered by distance (or segment
+// position), then by entity index, so they do not depend on
+// insertion order. The *Linear functions are brute-force
+// references with the same results.
+// ------------------------------------------------------------
+
+struct Neighbour {
+    ecs::Entity entity;
+    float       distance = 0.0f;
+};
+
+struct SegmentHit {
+    ecs::Entity entity;
+    float       t = 0.0f;   // 0 at the start, 1 at the end
+    SDL_FPoint  point{};    // where the segment enters the rect
+};
+
+class Grid {
+public:
+    // 'cellSize' around the typical entity size works best
+    explicit Grid(float cellSize = 64.0f, size_t buckets = 4096);
+
+    // Adds the entity, or moves it if it is already in the grid
+    void update(ecs::Entity e, const SDL_FRect& rect);
+    void remove(ecs::Entity e);
+    bool contains(ecs::Entity e) const;
+    void clear();
+
+    // Removes every entity for which pred(entity) is true
+    template <typename Pred>
+    void removeIf(Pred&& pred)
+    {
+        for (size_t i = m_items.size(); i-- > 0;) {
+            if (pred(m_items[i].entity)) removeSlot(static_cast<uint32_t>(i));
+        }
+    }
+
+    size_t size() const      { return m_items.size(); }
+    float  cellSize() const  { return m_cellSize; }
+
+    // Entities whose rect is within 'radius' of (x, y), in no particular order
+    void radius(float x, float y, float radius, std::vector<ecs::Entity>& out) const;
+
+    // Up to k entities nearest to (x, y), closest first
+    void nearest(float x, float y, size_t k, std::vector<Neighbour>& out) const;
+
+    // First rect the segment from (x0, y0) to (x1, y1) enters; a start
+    // point inside a rect hits it at t = 0
+    bool segment(float x0, float y0, float x1, float y1, SegmentHit& out) const;
+
+    void radiusLinear(float x, float y, float radius, std::vector<ecs::Entity>& out) const;
+    void nearestLinear(float x, float y, size_t k, std::vector<Neighbour>& out) const;
+    bool segmentLinear(float x0, float y0, float x1, float y1, SegmentHit& out) const;
+
+private:
+    static constexpr uint32_t s_none = 0xFFFFFFFFu;
+
+    struct Item {
+        ecs::Entity entity;
+        SDL_FRect   rect;
+        int32_t     cellX;
+        int32_t     cellY;
+        uint32_t    bucket;
+        uint32_t    prev;     // within the bucket, s_none at the ends
+        uint32_t    next;
+    };
+
+    int32_t  cellOf(float v) const;
+    uint32_t bucketOf(int32_t cx, int32_t cy) const;
+    void     link(uint32_t slot);
+    void     unlink(uint32_t slot);
+    void     removeSlot(uint32_t slot);
+
+    // Calls fn(item) for every item whose centre lies in cell (cx, cy)
+    template <typename Fn>
+    void forEachInCell(int32_t cx, int32_t cy, Fn&& fn) const
+    {
+        for (uint32_t i = m_heads[bucketOf(cx, cy)]; i != s_none; i = m_items[i].next) {
+            const Item& item = m_items[i];
+            if (item.cellX == cx && item.cellY == cy) fn(item);
+        }
+    }
+
+    float    m_cellSize;
+    float    m_invCellSize;
+    uint32_t m_bucketMask;
+    float    m_maxHalfExtent = 0.0f;   // grows only; reset by clear()
+
+    std::vector<Item>     m_items;
+    std::vector<uint32_t> m_heads;     // first slot of each bucket
+    std::vector<uint32_t> m_slotOf;    // by entity index
+};
+
+} // namespace spatial
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// ------------------------------------------------------------
+// What every frame of a sprite sheet actually draws.
+//
+// Measured once at load time from the same magenta key as the
+// collision masks: the smallest rect around each frame's drawn
+// pixels, and whether they need blending. Drawing only the
+// trimmed rect, with the destination moved and shrunk to match,
+// puts the same pixels on screen and fills none of the keyed
+// border; an opaque texture can skip blending altogether.
+// ------------------------------------------------------------
+
+// Ordered by how much blending a draw needs
+enum class Coverage : uint8_t {
+    Empty,         // nothing drawn
+    Opaque,        // every pixel drawn at full alpha
+    Keyed,         // magenta or alpha 0 holes, the rest at full alpha
+    Translucent    // some pixels at partial alpha
+};
+
+const char* coverageName(Coverage coverage);
+
+class SpriteSheet {
+public:
+    SpriteSheet() = default;
+
+    // Frames on a frameWidth x frameHeight grid, row-major, like
+    // CollisionMask::fromRGBA; a zero size is the whole sheet
+    static SpriteSheet fromRGBA(const uint8_t* pixels, int pitch,
+                                int sheetWidth, int sheetHeight,
+                                int frameWidth, int frameHeight);
+
+    bool empty() const { return m_frames.empty(); }
+
+    int sheetWidth()  const { return m_sheetWidth; }
+    int sheetHeight() const { return m_sheetHeight; }
+    int frameWidth()  const { return m_frameWidth; }
+    int frameHeight() const { return m_frameHeight; }
+    int frameCount()  const { return static_cast<int>(m_frames.size()); }
+
+    // The most blending any frame needs
+    Coverage coverage() const { return m_coverage; }
+    Coverage coverage(int frame) const { return m_frames[frame].coverage; }
+
+    // Drawn pixels of a frame relative to its cell; 0x0 when empty
+    const SDL_Rect& bounds(int frame) const { return m_frames[frame].bounds; }
+
+    // Frame index of a source rect taken from the sheet
+    int frameAt(const SDL_FRect& src) const;
+
+    // A draw of cell 'src' (nullptr: the whole sheet, when it is one
+    // frame) at 'dst', cut down to the frame's bounds. A source that
+    // is not one frame comes back as it was. False when the frame
+    // draws nothing.
+    bool trim(const SDL_FRect* src, const SDL_FRect& dst, SDL_FRect& trimmedSrc, SDL_FRect& trimmedDst) const;
+
+    // Cell area against trimmed area over every frame, for the logs
+    uint64_t cellPixels() const;
+    uint64_t trimmedPixels() const;
+
+private:
+    struct Frame {
+        SDL_Rect bounds{0, 0, 0, 0};
+        Coverage coverage = Coverage::Empty;
+    };
+
+    int m_sheetWidth  = 0;
+    int m_sheetHeight = 0;
+    int m_frameWidth  = 0;
+    int m_frameHeight = 0;
+    int m_columns     = 0;   // frames per sheet row
+    Coverage m_coverage = Coverage::Empty;
+
+    std::vector<Frame> m_frames;
+};
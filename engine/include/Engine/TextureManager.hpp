@@ -4,6 +4,9 @@
 #include <string>
 #include <unordered_map>
 
+#include "Engine/CollisionMask.hpp"
+#include "Engine/SpriteSheet.hpp"
+
 class TextureManager {
 public:
     TextureManager() = default;
@@ -12,13 +15,34 @@ public:
     // Must be called once after the renderer is created
     void setRenderer(SDL_Renderer* renderer);
 
-    // Load or fetch from cache
+    // Load or fetch from cache. Textures with no keyed or translucent
+    // pixel are drawn without blending.
     SDL_Texture* load(const std::string& path);
 
+    // Same as load(), and also builds a collision mask for every
+    // frameWidth x frameHeight frame of the sheet from the magenta key
+    SDL_Texture* load(const std::string& path, int frameWidth, int frameHeight);
+
+    // Blank render-target texture, transparent, kept under 'name' like
+    // a loaded one; a second call with the same name replaces it
+    SDL_Texture* createTarget(const std::string& name, int width, int height);
+
+    // Mask built by the frame-size overload of load(), or nullptr
+    const CollisionMask* getMask(SDL_Texture* texture) const;
+
+    // Frame bounds and coverage of a loaded texture, on the grid of the
+    // frame-size overload of load() or as one frame; nullptr for targets
+    const SpriteSheet* getSheet(SDL_Texture* texture) const;
+
     // Destroy all cached textures (called by Engine on shutdown)
     void clear();
 
 private:
+    SDL_Texture* loadTexture(const std::string& path, int frameWidth, int frameHeight, bool buildMask);
+    void inspect(SDL_Texture* texture, SDL_Surface* surface, int frameWidth, int frameHeight, bool buildMask);
+
     SDL_Renderer* m_renderer = nullptr;
     std::unordered_map<std::string, SDL_Texture*> m_cache;
+    std::unordered_map<SDL_Texture*, CollisionMask> m_masks;
+    std::unordered_map<SDL_Texture*, SpriteSheet>   m_sheets;
 };
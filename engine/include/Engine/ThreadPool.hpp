@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ------------------------------------------------------------
+// ThreadPool: fixed set of workers for fork/join loops.
+// parallelFor hands out indices through one atomic counter,
+// so uneven items balance themselves. The calling thread
+// works too and the call returns when every index is done.
+// ------------------------------------------------------------
+class ThreadPool {
+public:
+    // 'threads' counts the caller; 0 uses every hardware thread
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned threadCount() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+    // Runs fn(i) for every i in [0, count). Not reentrant.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+private:
+    void workerLoop();
+    void runItems();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t                m_generation = 0;
+    unsigned                m_busy       = 0;   // workers still inside the current job
+    bool                    m_stop       = false;
+
+    const std::function<void(size_t)>* m_fn    = nullptr;
+    size_t                             m_count = 0;
+    std::atomic<size_t>                m_next{0};
+};
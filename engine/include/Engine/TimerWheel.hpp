@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Engine/Snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace timer {
+
+// ------------------------------------------------------------
+// Hierarchical timing wheel on simulation ticks
+//
+// Four levels of 64 slots. Level 0 holds the timers due in the
+// current block of 64 ticks, one slot per tick; level 1 those due in
+// the current block of 4096, one slot per 64 ticks; and so on up to
+// 2^24 ticks (three days at 60 Hz), past which timers wait in a
+// list of their own. When the tick reaches the start of a block, the
+// slot of the next level that covers it is spread over the level
+// below ("cascading"), so a timer moves at most three times.
+//
+// Scheduling and cancelling unlink and link one node: O(1). A tick
+// costs the timers due on it; ticks with nothing due are skipped by
+// a bit scan of level 0, so advance() over a long quiet stretch only
+// stops once per 64 ticks. Timers due on the same tick fire in the
+// order they were scheduled.
+//
+// A timer carries a game-defined kind and argument instead of a
+// callback, so the whole wheel can go into a snapshot and fire the
+// same way after it is restored; ids survive the round trip.
+// ------------------------------------------------------------
+
+struct TimerId {
+    uint32_t index      = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool operator==(const TimerId&) const = default;
+};
+
+struct Timer {
+    uint16_t kind = 0;
+    uint64_t arg  = 0;
+};
+
+class Wheel {
+public:
+    // 'capacity' timers fit without growing the node table
+    explicit Wheel(size_t capacity = 64);
+
+    // Drops every timer and moves the clock to 'now'
+    void reset(uint64_t now);
+
+    // Fires in the advance() that reaches 'tick'; a tick already
+    // reached fires in the next advance()
+    TimerId schedule(uint64_t tick, Timer timer);
+
+    // False when the timer has fired or was cancelled already
+    bool cancel(TimerId id);
+    bool pending(TimerId id) const;
+    uint64_t dueTick(TimerId id) const;   // 0 when not pending
+
+    // Fires every timer due up to 'now' as fire(TimerId, const Timer&),
+    // tick by tick. A callback may schedule and cancel timers, but not
+    // advance, save or reset the wheel.
+    template <typename Fire>
+    void advance(uint64_t now, Fire&& fire);
+
+    uint64_t now() const  { return m_now; }
+    size_t   size() const { return m_count; }
+
+    struct Pending {
+        TimerId  id;
+        uint64_t tick;
+        Timer    timer;
+    };
+
+    // Every pending timer in firing order; 'out' is reused
+    void list(std::vector<Pending>& out) const;
+
+    void save(snapshot::Writer& out) const;
+    bool load(snapshot::Reader& in);
+
+private:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr unsigned SLOTS     = 1u << SLOT_BITS;
+    static constexpr unsigned LEVELS    = 4;
+
+    // the lists a node can be in, after the LEVELS * SLOTS slots
+    static constexpr uint16_t DISTANT  = LEVELS * SLOTS;
+    static constexpr uint16_t OVERDUE  = DISTANT + 1;
+    static constexpr uint16_t LISTS    = OVERDUE + 1;
+    static constexpr uint16_t FIRING   = LISTS;     // taken out, about to fire
+    static constexpr uint16_t FREE     = 0xFFFF;
+
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        uint64_t tick       = 0;
+        uint64_t order      = 0;   // schedule sequence: ties fire in this order
+        Timer    timer;
+        uint32_t prev       = NIL;
+        uint32_t next       = NIL;
+        uint32_t generation = 0;
+        uint16_t list       = FREE;
+    };
+
+    bool valid(TimerId id) const;
+    void place(uint32_t node);          // by tick, relative to m_now
+    void link(uint32_t node, uint16_t list);
+    void unlink(uint32_t node);
+    void release(uint32_t node);
+    void cascade(uint16_t list);
+
+    uint64_t nextTick() const;          // first tick worth stopping at
+    bool takeOverdue();                 // into m_firing; false when empty
+    void takeTick(uint64_t tick);       // moves the clock, cascades, fills m_firing
+    void sortFiring();
+
+    std::vector<Node>     m_nodes;
+    std::vector<uint32_t> m_free;
+    std::vector<uint32_t> m_firing;      // reused by advance()
+    uint32_t              m_heads[LISTS];
+    uint64_t              m_occupied = 0;   // level-0 slots with a timer, one bit each
+    uint64_t              m_now      = 0;
+    uint64_t              m_order    = 0;
+    size_t                m_count    = 0;
+};
+
+template <typename Fire>
+void Wheel::advance(uint64_t now, Fire&& fire)
+{
+    for (;;) {
+        if (!takeOverdue()) {
+            if (m_count == 0) break;
+            const uint64_t next = nextTick();
+            if (next > now) break;
+            takeTick(next);
+        }
+
+        // no references across fire(): it may grow m_nodes
+        for (const uint32_t index : m_firing) {
+            if (m_nodes[index].list != FIRING) continue;   // cancelled by an earlier timer
+            const TimerId id{index, m_nodes[index].generation};
+            const Timer   timer = m_nodes[index].timer;
+            release(index);
+            fire(id, timer);
+        }
+        m_firing.clear();
+    }
+    if (m_now < now) m_now = now;
+}
+
+} // namespace timer
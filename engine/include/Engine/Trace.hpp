@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace trace {
+
+// ------------------------------------------------------------
+// Timeline tracing
+//
+// Zones are recorded into a lock-free ring owned by the calling
+// thread. A background writer drains the rings and streams them
+// into a Chrome Trace Event JSON file (chrome://tracing, Perfetto
+// UI, speedscope). Names must be string literals: only the
+// pointer is stored.
+//
+// When no session is running a zone costs one relaxed load.
+// ------------------------------------------------------------
+
+// Opens 'path' and starts recording. Returns false if a session is
+// already running or the file cannot be created.
+bool start(const std::string& path);
+
+// Flushes everything recorded so far and closes the file
+void stop();
+
+bool isActive();
+
+// Shows up as the thread's label in the viewer
+void setThreadName(const char* name);
+
+// Events thrown away because a thread's ring was full
+uint64_t droppedEvents();
+
+namespace detail {
+    extern std::atomic<bool> g_active;
+
+    uint64_t now();
+    void     record(const char* name, const char* category, uint64_t begin, uint64_t end);
+}
+
+// Records the scope it lives in as one complete event
+class Zone {
+public:
+    Zone(const char* name, const char* category)
+        : m_name(name)
+        , m_category(category)
+        , m_begin(detail::g_active.load(std::memory_order_relaxed) ? detail::now() : 0)
+    {
+    }
+
+    ~Zone()
+    {
+        if (m_begin != 0) {
+            detail::record(m_name, m_category, m_begin, detail::now());
+        }
+    }
+
+    Zone(const Zone&)            = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+    uint64_t    m_begin;
+};
+
+} // namespace trace
+
+#define XENON_TRACE_CONCAT2(a, b) a##b
+#define XENON_TRACE_CONCAT(a, b)  XENON_TRACE_CONCAT2(a, b)
+
+// Build with -DXENON_DISABLE_TRACE to compile every zone out
+#if defined(XENON_DISABLE_TRACE)
+#define TRACE_ZONE(name, category) ((void)0)
+#else
+#define TRACE_ZONE(name, category) \
+    ::trace::Zone XENON_TRACE_CONCAT(traceZone_, __LINE__)(name, category)
+#endif
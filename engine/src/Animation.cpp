@@ -0,0 +1,88 @@
+#include "Engine/Animation.hpp"
+#include "Engine/Log.hpp"
+
+#include <algorithm>
+
+namespace anim {
+
+ClipId ClipLibrary::define(int sheetWidth, int sheetHeight, int frameWidth, int frameHeight,
+                           int firstFrame, int frameCount, uint32_t ticksPerFrame, bool loop)
+{
+    if (frameWidth <= 0 || frameWidth > sheetWidth)    frameWidth  = sheetWidth;
+    if (frameHeight <= 0 || frameHeight > sheetHeight) frameHeight = sheetHeight;
+
+    const int columns = frameWidth > 0 ? sheetWidth / frameWidth : 0;
+    const int cells   = frameHeight > 0 ? columns * (sheetHeight / frameHeight) : 0;
+    if (cells <= 0) {
+        LOG_WARN("[Animation] Empty frame grid (%dx%d)", sheetWidth, sheetHeight);
+        return still(SDL_FRect{});
+    }
+
+    firstFrame = std::clamp(firstFrame, 0, cells - 1);
+    frameCount = std::clamp(frameCount, 1, cells - firstFrame);
+
+    Clip c;
+    c.firstRect     = static_cast<uint32_t>(m_rects.size());
+    c.frameCount    = static_cast<uint16_t>(frameCount);
+    c.ticksPerFrame = static_cast<uint16_t>(std::max<uint32_t>(ticksPerFrame, 1));
+    c.loop          = loop;
+
+    for (int i = 0; i < frameCount; ++i) {
+        const int cell = firstFrame + i;
+        m_rects.push_back(SDL_FRect{
+            static_cast<float>((cell % columns) * frameWidth),
+            static_cast<float>((cell / columns) * frameHeight),
+            static_cast<float>(frameWidth),
+            static_cast<float>(frameHeight)});
+    }
+    m_trims.resize(m_rects.size());
+
+    m_clips.push_back(c);
+    return static_cast<ClipId>(m_clips.size() - 1);
+}
+
+ClipId ClipLibrary::define(SDL_Texture* sheet, int frameWidth, int frameHeight,
+                           int firstFrame, int frameCount, uint32_t ticksPerFrame, bool loop)
+{
+    float w = static_cast<float>(frameWidth);
+    float h = static_cast<float>(frameHeight);
+    if (sheet) SDL_GetTextureSize(sheet, &w, &h);
+    return define(static_cast<int>(w), static_cast<int>(h), frameWidth, frameHeight,
+                  firstFrame, frameCount, ticksPerFrame, loop);
+}
+
+ClipId ClipLibrary::still(const SDL_FRect& src)
+{
+    Clip c;
+    c.firstRect = static_cast<uint32_t>(m_rects.size());
+    m_rects.push_back(src);
+    m_trims.emplace_back();
+    m_clips.push_back(c);
+    return static_cast<ClipId>(m_clips.size() - 1);
+}
+
+void ClipLibrary::trim(ClipId clip, const SpriteSheet& sheet)
+{
+    const Clip& c = m_clips[clip];
+    for (uint32_t i = c.firstRect; i < c.firstRect + c.frameCount; ++i) {
+        const SDL_FRect* src  = m_rects[i].w > 0.0f ? &m_rects[i] : nullptr;
+        const float      w    = src ? src->w : static_cast<float>(sheet.sheetWidth());
+        const float      h    = src ? src->h : static_cast<float>(sheet.sheetHeight());
+        Trim&            trim = m_trims[i];
+
+        // the place comes back in the cell's pixels, drawn where the cell starts
+        trim = Trim{};
+        if (!sheet.trim(src, SDL_FRect{0.0f, 0.0f, w, h}, trim.src, trim.place)) trim.place = SDL_FRect{};
+        trim.cellWidth  = w;
+        trim.cellHeight = h;
+    }
+}
+
+void ClipLibrary::clear()
+{
+    m_clips.clear();
+    m_rects.clear();
+    m_trims.clear();
+}
+
+} // namespace anim
@@ -0,0 +1,348 @@
+#include "Engine/Audio.hpp"
+#include "Engine/Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || CPU_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace audio {
+
+namespace {
+
+    constexpr int CHANNELS = 2;
+
+#if CPU_AVX2
+    // 8 samples a step from 0; returns where it stopped
+    CPU_AVX2_FN uint32_t addVoiceAvx2(float* out, const float* s, uint32_t n, float left, float right)
+    {
+        const __m256 gl = _mm256_set1_ps(left), gr = _mm256_set1_ps(right);
+        uint32_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const __m256 v = _mm256_loadu_ps(s + i);
+            const __m256 l = _mm256_mul_ps(v, gl);
+            const __m256 r = _mm256_mul_ps(v, gr);
+
+            // unpack works within 128-bit halves: lo = l0 r0 l1 r1 | l4 r4 l5 r5
+            const __m256 lo = _mm256_unpacklo_ps(l, r);
+            const __m256 hi = _mm256_unpackhi_ps(l, r);
+            float* o = out + 2 * i;
+            _mm256_storeu_ps(o,     _mm256_add_ps(_mm256_loadu_ps(o),     _mm256_permute2f128_ps(lo, hi, 0x20)));
+            _mm256_storeu_ps(o + 8, _mm256_add_ps(_mm256_loadu_ps(o + 8), _mm256_permute2f128_ps(lo, hi, 0x31)));
+        }
+        return i;
+    }
+#endif
+
+    // out[2i] += s[i] * left, out[2i + 1] += s[i] * right
+    void addVoice(float* out, const float* s, uint32_t n, float left, float right, [[maybe_unused]] cpu::Simd level)
+    {
+        uint32_t i = 0;
+
+#if CPU_AVX2
+        if (level >= cpu::Simd::Avx2) i = addVoiceAvx2(out, s, n, left, right);
+#endif
+
+#if defined(__SSE2__)
+        if (level >= cpu::Simd::Vector128) {
+            const __m128 gl = _mm_set1_ps(left), gr = _mm_set1_ps(right);
+            for (; i + 4 <= n; i += 4) {
+                const __m128 v = _mm_loadu_ps(s + i);
+                const __m128 l = _mm_mul_ps(v, gl);
+                const __m128 r = _mm_mul_ps(v, gr);
+                float* o = out + 2 * i;
+                _mm_storeu_ps(o,     _mm_add_ps(_mm_loadu_ps(o),     _mm_unpacklo_ps(l, r)));
+                _mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_unpackhi_ps(l, r)));
+            }
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        if (level >= cpu::Simd::Vector128) {
+            for (; i + 4 <= n; i += 4) {
+                const float32x4_t v = vld1q_f32(s + i);
+                float32x4x2_t     o = vld2q_f32(out + 2 * i);   // deinterleaves
+                o.val[0] = vaddq_f32(o.val[0], vmulq_n_f32(v, left));
+                o.val[1] = vaddq_f32(o.val[1], vmulq_n_f32(v, right));
+                vst2q_f32(out + 2 * i, o);
+            }
+        }
+#endif
+
+        for (; i < n; ++i) {
+            out[2 * i]     += s[i] * left;
+            out[2 * i + 1] += s[i] * right;
+        }
+    }
+
+    void storeMax(std::atomic<uint64_t>& max, uint64_t v)
+    {
+        // single writer: no compare-exchange needed
+        if (v > max.load(std::memory_order_relaxed)) max.store(v, std::memory_order_relaxed);
+    }
+}
+
+Mixer::Mixer()
+    : m_ring(new Command[s_ringCapacity])
+    , m_block(static_cast<size_t>(s_blockFrames) * CHANNELS)
+{
+}
+
+Mixer::~Mixer()
+{
+    close();
+}
+
+// ------------------------------------------------------------
+// Device
+// ------------------------------------------------------------
+
+bool Mixer::open()
+{
+    if (m_stream) return true;
+
+    const SDL_AudioSpec spec{SDL_AUDIO_F32, CHANNELS, SAMPLE_RATE};
+    m_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, &Mixer::callback, this);
+    if (!m_stream) {
+        LOG_WARN("[Audio] No playback device, sound is off: %s", SDL_GetError());
+        return false;
+    }
+
+    m_accepting.store(true, std::memory_order_release);
+
+    // streams from SDL_OpenAudioDeviceStream start paused
+    if (!SDL_ResumeAudioStreamDevice(m_stream)) {
+        LOG_WARN("[Audio] SDL_ResumeAudioStreamDevice failed: %s", SDL_GetError());
+    }
+
+    LOG_INFO("[Audio] Mixing %d voices at %d Hz", MAX_VOICES, SAMPLE_RATE);
+    return true;
+}
+
+void Mixer::openOffline()
+{
+    m_accepting.store(true, std::memory_order_release);
+}
+
+void Mixer::close()
+{
+    m_accepting.store(false, std::memory_order_release);
+    if (m_stream) {
+        // waits for a callback in progress
+        SDL_DestroyAudioStream(m_stream);
+        m_stream = nullptr;
+    }
+}
+
+void SDLCALL Mixer::callback(void* userdata, SDL_AudioStream* stream, int additional, int /*total*/)
+{
+    Mixer* self = static_cast<Mixer*>(userdata);
+    const auto start = std::chrono::steady_clock::now();
+
+    int frames = additional / static_cast<int>(CHANNELS * sizeof(float));
+    const int requested = frames;
+    while (frames > 0) {
+        const int n = std::min(frames, s_blockFrames);
+        self->mix(self->m_block.data(), n);
+        SDL_PutAudioStreamData(stream, self->m_block.data(), n * CHANNELS * static_cast<int>(sizeof(float)));
+        frames -= n;
+    }
+
+    const auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    self->m_callbacks.fetch_add(1, std::memory_order_relaxed);
+    self->m_frames.fetch_add(static_cast<uint64_t>(requested), std::memory_order_relaxed);
+    self->m_callbackNs.fetch_add(ns, std::memory_order_relaxed);
+    storeMax(self->m_maxCallbackNs, ns);
+}
+
+// ------------------------------------------------------------
+// Sounds
+// ------------------------------------------------------------
+
+SoundId Mixer::load(const char* path)
+{
+    SDL_AudioSpec source{};
+    Uint8*        data   = nullptr;
+    Uint32        length = 0;
+    if (!SDL_LoadWAV(path, &source, &data, &length)) {
+        LOG_WARN("[Audio] Cannot load %s: %s", path, SDL_GetError());
+        return NoSound;
+    }
+
+    const SDL_AudioSpec target{SDL_AUDIO_F32, 1, SAMPLE_RATE};
+    Uint8* converted = nullptr;
+    int    bytes     = 0;
+    const bool ok = SDL_ConvertAudioSamples(&source, data, static_cast<int>(length),
+                                            &target, &converted, &bytes);
+    SDL_free(data);
+    if (!ok) {
+        LOG_WARN("[Audio] Cannot convert %s: %s", path, SDL_GetError());
+        return NoSound;
+    }
+
+    const SoundId id = add(reinterpret_cast<const float*>(converted), static_cast<size_t>(bytes) / sizeof(float));
+    SDL_free(converted);
+    return id;
+}
+
+SoundId Mixer::add(const float* samples, size_t count)
+{
+    const size_t index = m_soundCount.load(std::memory_order_relaxed);
+    if (index >= MAX_SOUNDS) {
+        LOG_WARN("[Audio] Sound table full (%zu)", MAX_SOUNDS);
+        return NoSound;
+    }
+    if (count > UINT32_MAX) count = UINT32_MAX;
+
+    m_sounds[index].samples.assign(samples, samples + count);
+
+    // the mixer reads sounds below the count without locking
+    m_soundCount.store(index + 1, std::memory_order_release);
+    return static_cast<SoundId>(index);
+}
+
+// ------------------------------------------------------------
+// Commands
+// ------------------------------------------------------------
+
+bool Mixer::play(SoundId sound, float volume, float pan, uint8_t priority)
+{
+    return post(Command{CommandType::Play, priority, sound, volume, pan});
+}
+
+void Mixer::stopAll()
+{
+    post(Command{CommandType::StopAll, 0, NoSound, 0.0f, 0.0f});
+}
+
+bool Mixer::post(const Command& c)
+{
+    if (!m_accepting.load(std::memory_order_relaxed)) return false;
+
+    const uint32_t head = m_head.load(std::memory_order_relaxed);
+    const uint32_t tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail >= s_ringCapacity) {
+        m_commandsDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_ring[head % s_ringCapacity] = c;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void Mixer::applyCommands()
+{
+    const uint32_t head = m_head.load(std::memory_order_acquire);
+    uint32_t       tail = m_tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail) {
+        const Command& c = m_ring[tail % s_ringCapacity];
+        switch (c.type) {
+        case CommandType::Play:
+            start(c);
+            break;
+        case CommandType::StopAll:
+            for (Voice& v : m_voices) v.samples = nullptr;
+            break;
+        }
+    }
+    m_tail.store(tail, std::memory_order_release);
+}
+
+void Mixer::start(const Command& c)
+{
+    if (c.sound >= m_soundCount.load(std::memory_order_acquire)) return;
+    const std::vector<float>& samples = m_sounds[c.sound].samples;
+    if (samples.empty()) return;
+
+    // a free voice, or the least important one: lowest priority, then oldest
+    Voice* voice = nullptr;
+    for (Voice& v : m_voices) {
+        if (!v.samples) { voice = &v; break; }
+        if (!voice || v.priority < voice->priority ||
+            (v.priority == voice->priority && v.started < voice->started)) {
+            voice = &v;
+        }
+    }
+    if (voice->samples) {
+        if (voice->priority > c.priority) {
+            m_soundsDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_stolen.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // constant power: the sound is as loud in the middle as at the sides
+    const float pan   = std::clamp(c.pan, -1.0f, 1.0f);
+    const float angle = (pan + 1.0f) * 0.25f * 3.14159265f;
+
+    voice->samples   = samples.data();
+    voice->length    = static_cast<uint32_t>(samples.size());
+    voice->position  = 0;
+    voice->gainLeft  = c.volume * std::cos(angle);
+    voice->gainRight = c.volume * std::sin(angle);
+    voice->started   = m_started++;
+    voice->priority  = c.priority;
+}
+
+// ------------------------------------------------------------
+// Mixing
+// ------------------------------------------------------------
+
+void Mixer::mix(float* out, int frames)
+{
+    applyCommands();
+    mixVoices(out, frames, cpu::simd());
+}
+
+void Mixer::mixScalar(float* out, int frames)
+{
+    applyCommands();
+    mixVoices(out, frames, cpu::Simd::Scalar);
+}
+
+void Mixer::mixVoices(float* out, int frames, cpu::Simd level)
+{
+    const size_t samples = static_cast<size_t>(std::max(frames, 0)) * CHANNELS;
+    std::fill_n(out, samples, 0.0f);
+
+    int active = 0;
+    for (Voice& v : m_voices) {
+        if (!v.samples) continue;
+
+        const uint32_t n = std::min(static_cast<uint32_t>(std::max(frames, 0)), v.length - v.position);
+        addVoice(out, v.samples + v.position, n, v.gainLeft, v.gainRight, level);
+
+        v.position += n;
+        if (v.position >= v.length) {
+            v.samples = nullptr;
+        } else {
+            ++active;
+        }
+    }
+
+    // hard limit; loud pile-ups clip instead of wrapping in the device format
+    for (size_t i = 0; i < samples; ++i) out[i] = std::clamp(out[i], -1.0f, 1.0f);
+
+    m_active.store(active, std::memory_order_relaxed);
+}
+
+MixerStats Mixer::stats() const
+{
+    MixerStats s;
+    s.callbacks       = m_callbacks.load(std::memory_order_relaxed);
+    s.frames          = m_frames.load(std::memory_order_relaxed);
+    s.averageUs       = s.callbacks ? m_callbackNs.load(std::memory_order_relaxed) / 1000.0 / s.callbacks : 0.0;
+    s.maxUs           = m_maxCallbackNs.load(std::memory_order_relaxed) / 1000.0;
+    s.voicesStolen    = m_stolen.load(std::memory_order_relaxed);
+    s.soundsDropped   = m_soundsDropped.load(std::memory_order_relaxed);
+    s.commandsDropped = m_commandsDropped.load(std::memory_order_relaxed);
+    s.activeVoices    = m_active.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace audio
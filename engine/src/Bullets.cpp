@@ -0,0 +1,363 @@
+#include "Engine/Bullets.hpp"
+#include "Engine/Draw.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bullet {
+
+namespace {
+    constexpr float    DEG_TO_RAD = 3.14159265358979f / 180.0f;
+    constexpr uint64_t NO_BURST   = UINT64_MAX;
+}
+
+BulletSystem::BulletSystem(size_t capacity)
+    : m_capacity(capacity)
+{
+    m_x.reserve(capacity);
+    m_y.reserve(capacity);
+    m_vx.reserve(capacity);
+    m_vy.reserve(capacity);
+    m_burstTick.reserve(capacity);
+    m_pattern.reserve(capacity);
+}
+
+PatternId BulletSystem::define(const Pattern& p)
+{
+    Pattern stored = p;
+    stored.interval = std::max<uint32_t>(stored.interval, 1);
+    stored.count    = std::max<uint16_t>(stored.count, 1);
+    m_patterns.push_back(stored);
+    m_maxRadius = std::max(m_maxRadius, stored.radius);
+    return static_cast<PatternId>(m_patterns.size() - 1);
+}
+
+// ------------------------------------------------------------
+// Emitters
+// ------------------------------------------------------------
+
+EmitterId BulletSystem::start(PatternId pattern, float x, float y, uint64_t now)
+{
+    // reuse a finished slot before growing
+    size_t slot = m_emitters.size();
+    if (!m_freeEmitters.empty()) {
+        slot = m_freeEmitters.back();
+        m_freeEmitters.pop_back();
+    } else {
+        m_emitters.emplace_back();
+    }
+
+    Emitter& e    = m_emitters[slot];
+    e.x           = x;
+    e.y           = y;
+    e.turn        = 0.0f;
+    e.nextTick    = now;
+    e.volleysLeft = m_patterns[pattern].volleys;
+    e.pattern     = pattern;
+    e.active      = true;
+    return EmitterId{static_cast<uint32_t>(slot), e.generation};
+}
+
+bool BulletSystem::running(EmitterId id) const
+{
+    return id.index < m_emitters.size() && m_emitters[id.index].active
+        && m_emitters[id.index].generation == id.generation;
+}
+
+void BulletSystem::moveEmitter(EmitterId id, float x, float y)
+{
+    if (!running(id)) return;
+    m_emitters[id.index].x = x;
+    m_emitters[id.index].y = y;
+}
+
+void BulletSystem::stop(EmitterId id)
+{
+    if (running(id)) retire(m_emitters[id.index]);
+}
+
+void BulletSystem::retire(Emitter& e)
+{
+    e.active = false;
+    ++e.generation;
+    m_freeEmitters.push_back(static_cast<uint32_t>(&e - m_emitters.data()));
+}
+
+size_t BulletSystem::emitterCount() const
+{
+    return m_emitters.size() - m_freeEmitters.size();
+}
+
+void BulletSystem::fire(Emitter& e, SDL_FPoint target)
+{
+    const Pattern& p = m_patterns[e.pattern];
+
+    float centre = p.angle;
+    if (p.aimed) centre = std::atan2(target.y - e.y, target.x - e.x) / DEG_TO_RAD;
+    centre += e.turn;
+
+    if (p.shape == Shape::Ring) {
+        const float step = 360.0f / p.count;
+        for (uint16_t i = 0; i < p.count; ++i) spawn(e.x, e.y, centre + step * i, p, e.pattern);
+    } else if (p.count == 1) {
+        spawn(e.x, e.y, centre, p, e.pattern);
+    } else {
+        const float step = p.spread / (p.count - 1);
+        for (uint16_t i = 0; i < p.count; ++i) spawn(e.x, e.y, centre - p.spread * 0.5f + step * i, p, e.pattern);
+    }
+
+    e.turn = std::fmod(e.turn + p.spin, 360.0f);
+}
+
+void BulletSystem::spawn(float x, float y, float angle, const Pattern& p, PatternId id)
+{
+    if (m_x.size() >= m_capacity) {
+        ++m_dropped;
+        return;
+    }
+    const float rad = angle * DEG_TO_RAD;
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_vx.push_back(std::cos(rad) * p.speed);
+    m_vy.push_back(std::sin(rad) * p.speed);
+    m_burstTick.push_back(p.child != NoPattern ? m_now + p.childDelay : NO_BURST);
+    m_pattern.push_back(id);
+}
+
+// ------------------------------------------------------------
+// Pool
+// ------------------------------------------------------------
+
+// The last bullet fills the hole; callers walk the pool backwards,
+// so the one moved in has been looked at already
+void BulletSystem::removeAt(size_t i)
+{
+    const size_t last = m_x.size() - 1;
+    m_x[i]         = m_x[last];
+    m_y[i]         = m_y[last];
+    m_vx[i]        = m_vx[last];
+    m_vy[i]        = m_vy[last];
+    m_burstTick[i] = m_burstTick[last];
+    m_pattern[i]   = m_pattern[last];
+    m_x.pop_back();
+    m_y.pop_back();
+    m_vx.pop_back();
+    m_vy.pop_back();
+    m_burstTick.pop_back();
+    m_pattern.pop_back();
+}
+
+void BulletSystem::resizePool(size_t n)
+{
+    m_x.resize(n);
+    m_y.resize(n);
+    m_vx.resize(n);
+    m_vy.resize(n);
+    m_burstTick.resize(n);
+    m_pattern.resize(n);
+}
+
+void BulletSystem::update(float dt, uint64_t now, SDL_FPoint target, const SDL_FRect& bounds)
+{
+    m_now = now;
+
+    // plain arrays so the compiler vectorises the move and the flags
+    const size_t n = m_x.size();
+    m_flags.resize(n);
+    float*          x     = m_x.data();
+    float*          y     = m_y.data();
+    const float*    vx    = m_vx.data();
+    const float*    vy    = m_vy.data();
+    const uint64_t* burst = m_burstTick.data();
+    uint8_t*        dead  = m_flags.data();
+    const float minX = bounds.x, maxX = bounds.x + bounds.w;
+    const float minY = bounds.y, maxY = bounds.y + bounds.h;
+    for (size_t i = 0; i < n; ++i) {
+        const float nx = x[i] + vx[i] * dt;
+        const float ny = y[i] + vy[i] * dt;
+        x[i] = nx;
+        y[i] = ny;
+        dead[i] = (nx < minX) | (nx > maxX) | (ny < minY) | (ny > maxY);
+    }
+    for (size_t i = 0; i < n; ++i) dead[i] |= burst[i] <= now;
+
+    // a few bullets leave or burst per tick: removing them one by one
+    // is cheaper than compacting the whole pool
+    m_bursts.clear();
+    for (size_t i = n; i-- > 0;) {
+        if (!dead[i]) continue;
+        if (m_burstTick[i] <= now) m_bursts.push_back(Burst{m_x[i], m_y[i], m_patterns[m_pattern[i]].child});
+        removeAt(i);
+    }
+
+    for (const Burst& b : m_bursts) start(b.pattern, b.x, b.y, now);
+
+    // volleys appear at the emitter and start moving next update
+    for (Emitter& e : m_emitters) {
+        const Pattern& p = m_patterns[e.pattern];
+        while (e.active && e.nextTick <= now) {
+            fire(e, target);
+            e.nextTick += p.interval;
+            if (p.volleys != 0 && --e.volleysLeft == 0) retire(e);
+        }
+    }
+}
+
+size_t BulletSystem::collide(const SDL_FRect& box)
+{
+    // branch-free flags against the box grown by the largest radius;
+    // the exact test only runs for the few bullets near the box
+    const size_t n = m_x.size();
+    m_flags.resize(n);
+    const float* x    = m_x.data();
+    const float* y    = m_y.data();
+    uint8_t*     near = m_flags.data();
+    const float minX = box.x - m_maxRadius, maxX = box.x + box.w + m_maxRadius;
+    const float minY = box.y - m_maxRadius, maxY = box.y + box.h + m_maxRadius;
+    size_t candidates = 0;
+    for (size_t i = 0; i < n; ++i) {
+        near[i] = (x[i] >= minX) & (x[i] <= maxX) & (y[i] >= minY) & (y[i] <= maxY);
+        candidates += near[i];
+    }
+    if (candidates == 0) return 0;
+
+    size_t hits = 0;
+    for (size_t i = n; i-- > 0;) {
+        if (!near[i]) continue;
+        const float dx = m_x[i] - std::clamp(m_x[i], box.x, box.x + box.w);
+        const float dy = m_y[i] - std::clamp(m_y[i], box.y, box.y + box.h);
+        const float r  = m_patterns[m_pattern[i]].radius;
+        if (dx * dx + dy * dy > r * r) continue;
+        removeAt(i);
+        ++hits;
+    }
+    return hits;
+}
+
+void BulletSystem::render(SDL_Renderer* r, SDL_Texture* texture, const SDL_FRect& src)
+{
+    const size_t n = m_x.size();
+    if (n == 0) return;
+
+    float tw = 1.0f, th = 1.0f;
+    if (texture) SDL_GetTextureSize(texture, &tw, &th);
+    const float u0 = src.x / tw, u1 = (src.x + src.w) / tw;
+    const float v0 = src.y / th, v1 = (src.y + src.h) / th;
+
+    m_vertices.resize(n * 4);
+    uint64_t pixels = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Pattern& p = m_patterns[m_pattern[i]];
+        const float h  = p.size * 0.5f;
+        const float x0 = m_x[i] - h, x1 = m_x[i] + h;
+        const float y0 = m_y[i] - h, y1 = m_y[i] + h;
+        SDL_Vertex* v = &m_vertices[i * 4];
+        v[0] = SDL_Vertex{{x0, y0}, p.color, {u0, v0}};
+        v[1] = SDL_Vertex{{x1, y0}, p.color, {u1, v0}};
+        v[2] = SDL_Vertex{{x1, y1}, p.color, {u1, v1}};
+        v[3] = SDL_Vertex{{x0, y1}, p.color, {u0, v1}};
+        pixels += static_cast<uint64_t>(p.size * p.size);
+    }
+
+    // the index pattern never changes, only its length
+    for (size_t quad = m_indices.size() / 6; quad < n; ++quad) {
+        const int base = static_cast<int>(quad * 4);
+        const int idx[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        m_indices.insert(m_indices.end(), idx, idx + 6);
+    }
+
+    draw::geometry(r, texture, m_vertices.data(), static_cast<int>(n * 4),
+                   m_indices.data(), static_cast<int>(n * 6), pixels);
+}
+
+void BulletSystem::clearBullets()
+{
+    resizePool(0);
+}
+
+void BulletSystem::clear()
+{
+    clearBullets();
+    for (Emitter& e : m_emitters) {
+        if (e.active) retire(e);
+    }
+}
+
+// ------------------------------------------------------------
+// Snapshots
+// ------------------------------------------------------------
+
+void BulletSystem::save(snapshot::Writer& out) const
+{
+    out.put(static_cast<uint32_t>(m_emitters.size()));
+    for (const Emitter& e : m_emitters) {
+        // field by field: no padding reaches the bytes
+        out.put(e.x);
+        out.put(e.y);
+        out.put(e.turn);
+        out.put(e.nextTick);
+        out.put(e.volleysLeft);
+        out.put(e.generation);
+        out.put(e.pattern);
+        out.put(static_cast<uint8_t>(e.active));
+    }
+
+    const size_t n = m_x.size();
+    out.put(static_cast<uint32_t>(n));
+    out.put(m_dropped);
+    out.bytes(m_x.data(), n * sizeof(float));
+    out.bytes(m_y.data(), n * sizeof(float));
+    out.bytes(m_vx.data(), n * sizeof(float));
+    out.bytes(m_vy.data(), n * sizeof(float));
+    out.bytes(m_burstTick.data(), n * sizeof(uint64_t));
+    out.bytes(m_pattern.data(), n * sizeof(PatternId));
+}
+
+bool BulletSystem::load(snapshot::Reader& in)
+{
+    uint32_t emitters = 0;
+    in.get(emitters);
+    m_emitters.clear();
+    m_freeEmitters.clear();
+    for (uint32_t i = 0; i < emitters && in.ok(); ++i) {
+        Emitter e;
+        uint8_t active = 0;
+        in.get(e.x);
+        in.get(e.y);
+        in.get(e.turn);
+        in.get(e.nextTick);
+        in.get(e.volleysLeft);
+        in.get(e.generation);
+        in.get(e.pattern);
+        in.get(active);
+        e.active = active != 0 && e.pattern < m_patterns.size();
+        if (!e.active) m_freeEmitters.push_back(i);
+        m_emitters.push_back(e);
+    }
+
+    uint32_t n = 0;
+    in.get(n);
+    in.get(m_dropped);
+    if (!in.ok() || n > m_capacity) {
+        clear();
+        return false;
+    }
+
+    resizePool(n);
+    in.bytes(m_x.data(), n * sizeof(float));
+    in.bytes(m_y.data(), n * sizeof(float));
+    in.bytes(m_vx.data(), n * sizeof(float));
+    in.bytes(m_vy.data(), n * sizeof(float));
+    in.bytes(m_burstTick.data(), n * sizeof(uint64_t));
+    in.bytes(m_pattern.data(), n * sizeof(PatternId));
+
+    const bool valid = std::all_of(m_pattern.begin(), m_pattern.end(),
+                                   [this](PatternId p) { return p < m_patterns.size(); });
+    if (!in.ok() || !valid) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace bullet
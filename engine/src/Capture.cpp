@@ -0,0 +1,436 @@
+#include "Engine/Capture.hpp"
+
+#include "Engine/Log.hpp"
+#include "Engine/Trace.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace capture {
+
+Format formatFor(const std::string& path)
+{
+    const size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos) return Format::RawRGBA;
+    std::string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == "y4m" ? Format::Y4M : Format::RawRGBA;
+}
+
+// ------------------------------------------------------------
+// RGBA -> I420
+//
+// BT.601 limited range in 8-bit fixed point:
+//   Y = (( 66 R + 129 G +  25 B + 128) >> 8) +  16
+//   U = ((-38 R -  74 G + 112 B + 128) >> 8) + 128
+//   V = ((112 R -  94 G -  18 B + 128) >> 8) + 128
+// Chroma comes from each 2x2 block, averaged as the SIMD average
+// instructions do it: rows first, then columns, each rounding up.
+// ------------------------------------------------------------
+
+namespace {
+
+    inline uint8_t avg(uint8_t a, uint8_t b) { return static_cast<uint8_t>((a + b + 1) >> 1); }
+
+    inline uint8_t lumaOf(const uint8_t* p)
+    {
+        return static_cast<uint8_t>(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+    }
+
+    // Averaged block at chroma column 'cx', rows 'r0' and 'r1'
+    inline void chromaOf(const uint8_t* r0, const uint8_t* r1, int cx, int width, uint8_t* u, uint8_t* v)
+    {
+        const int x0 = 2 * cx;
+        const int x1 = std::min(x0 + 1, width - 1);
+        int c[3];
+        for (int k = 0; k < 3; ++k) {
+            c[k] = avg(avg(r0[x0 * 4 + k], r1[x0 * 4 + k]), avg(r0[x1 * 4 + k], r1[x1 * 4 + k]));
+        }
+        *u = static_cast<uint8_t>(((-38 * c[0] - 74 * c[1] + 112 * c[2] + 128) >> 8) + 128);
+        *v = static_cast<uint8_t>(((112 * c[0] - 94 * c[1] - 18 * c[2] + 128) >> 8) + 128);
+    }
+
+    void lumaRow(const uint8_t* row, int begin, int width, uint8_t* y)
+    {
+        for (int x = begin; x < width; ++x) y[x] = lumaOf(row + x * 4);
+    }
+
+    void chromaRow(const uint8_t* r0, const uint8_t* r1, int begin, int width, uint8_t* u, uint8_t* v)
+    {
+        const int chromaWidth = (width + 1) / 2;
+        for (int cx = begin; cx < chromaWidth; ++cx) chromaOf(r0, r1, cx, width, u + cx, v + cx);
+    }
+
+#if defined(__SSE2__)
+    // Dot product of 4 RGBA pixels with (r, g, b, 0): 4 int32
+    inline __m128i dot4(__m128i pixels, __m128i coef)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lo   = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coef);   // r+g, b+0 of pixels 0, 1
+        const __m128i hi   = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coef);   // and of pixels 2, 3
+        const __m128  even = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128  odd  = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+    }
+
+    // (dot + 128) >> 8, plus 'offset'
+    inline __m128i scale4(__m128i pixels, __m128i coef, __m128i offset)
+    {
+        const __m128i sum = _mm_add_epi32(dot4(pixels, coef), _mm_set1_epi32(128));
+        return _mm_add_epi32(_mm_srai_epi32(sum, 8), offset);
+    }
+
+    // 16 pixels per step
+    int lumaRowSSE2(const uint8_t* row, int width, uint8_t* y)
+    {
+        const __m128i coef   = _mm_setr_epi16(66, 129, 25, 0, 66, 129, 25, 0);
+        const __m128i offset = _mm_set1_epi32(16);
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            const uint8_t* p = row + x * 4;
+            const __m128i a = scale4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), coef, offset);
+            const __m128i b = scale4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), coef, offset);
+            const __m128i c = scale4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)), coef, offset);
+            const __m128i d = scale4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)), coef, offset);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x),
+                             _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        }
+        return x;
+    }
+
+    // 4 pixels of two rows -> 2 averaged blocks, in lanes 0 and 1 of the
+    // result (lanes 2 and 3 are the same blocks again)
+    inline __m128i blocks2(const uint8_t* r0, const uint8_t* r1)
+    {
+        const __m128i rows = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1)));
+        const __m128i cols = _mm_avg_epu8(rows, _mm_srli_si128(rows, 4));   // pixel 0 = (0, 1), pixel 2 = (2, 3)
+        return _mm_shuffle_epi32(cols, _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    // 16 pixels (8 blocks) per step, whole pairs only
+    int chromaRowSSE2(const uint8_t* r0, const uint8_t* r1, int width, uint8_t* u, uint8_t* v)
+    {
+        const __m128i coefU  = _mm_setr_epi16(-38, -74, 112, 0, -38, -74, 112, 0);
+        const __m128i coefV  = _mm_setr_epi16(112, -94, -18, 0, 112, -94, -18, 0);
+        const __m128i offset = _mm_set1_epi32(128);
+        int cx = 0;
+        for (; 2 * cx + 16 <= width; cx += 8) {
+            __m128i blocks[2];
+            for (int half = 0; half < 2; ++half) {
+                const int at = (2 * cx + half * 8) * 4;
+                blocks[half] = _mm_unpacklo_epi64(blocks2(r0 + at, r1 + at), blocks2(r0 + at + 16, r1 + at + 16));
+            }
+            const __m128i u8 = _mm_packs_epi32(scale4(blocks[0], coefU, offset), scale4(blocks[1], coefU, offset));
+            const __m128i v8 = _mm_packs_epi32(scale4(blocks[0], coefV, offset), scale4(blocks[1], coefV, offset));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(u + cx), _mm_packus_epi16(u8, u8));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(v + cx), _mm_packus_epi16(v8, v8));
+        }
+        return cx;
+    }
+#elif defined(__ARM_NEON)
+    // 8 pixels per step; vld4 splits the channels
+    int lumaRowNEON(const uint8_t* row, int width, uint8_t* y)
+    {
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            const uint8x8x4_t p = vld4_u8(row + x * 4);
+            uint16x8_t sum = vmull_u8(p.val[0], vdup_n_u8(66));
+            sum = vmlal_u8(sum, p.val[1], vdup_n_u8(129));
+            sum = vmlal_u8(sum, p.val[2], vdup_n_u8(25));
+            // at most 220 * 255 + 128, no overflow
+            const uint8x8_t luma = vshrn_n_u16(vaddq_u16(sum, vdupq_n_u16(128)), 8);
+            vst1_u8(y + x, vadd_u8(luma, vdup_n_u8(16)));
+        }
+        return x;
+    }
+
+    // Rounded average of rows, then of column pairs: 16 pixels -> 8 blocks
+    inline int16x8_t blocks8(uint8x16_t a, uint8x16_t b)
+    {
+        const uint8x16_t   rows  = vrhaddq_u8(a, b);
+        const uint8x16x2_t split = vuzpq_u8(rows, rows);
+        const uint8x8_t    cols  = vrhadd_u8(vget_low_u8(split.val[0]), vget_low_u8(split.val[1]));
+        return vreinterpretq_s16_u16(vmovl_u8(cols));
+    }
+
+    // |sum| <= 112 * 255 + 128, which int16 holds
+    inline uint8x8_t chroma8(int16x8_t r, int16x8_t g, int16x8_t b, int16_t cr, int16_t cg, int16_t cb)
+    {
+        int16x8_t sum = vmlaq_n_s16(vdupq_n_s16(128), r, cr);
+        sum = vmlaq_n_s16(sum, g, cg);
+        sum = vmlaq_n_s16(sum, b, cb);
+        return vmovn_u16(vreinterpretq_u16_s16(vaddq_s16(vshrq_n_s16(sum, 8), vdupq_n_s16(128))));
+    }
+
+    int chromaRowNEON(const uint8_t* r0, const uint8_t* r1, int width, uint8_t* u, uint8_t* v)
+    {
+        int cx = 0;
+        for (; 2 * cx + 16 <= width; cx += 8) {
+            const uint8x16x4_t a = vld4q_u8(r0 + cx * 8);
+            const uint8x16x4_t b = vld4q_u8(r1 + cx * 8);
+            const int16x8_t red   = blocks8(a.val[0], b.val[0]);
+            const int16x8_t green = blocks8(a.val[1], b.val[1]);
+            const int16x8_t blue  = blocks8(a.val[2], b.val[2]);
+            vst1_u8(u + cx, chroma8(red, green, blue, -38, -74, 112));
+            vst1_u8(v + cx, chroma8(red, green, blue, 112, -94, -18));
+        }
+        return cx;
+    }
+#endif
+
+} // namespace
+
+void rgbaToI420Scalar(const uint8_t* rgba, size_t pitch, int width, int height,
+                      uint8_t* y, uint8_t* u, uint8_t* v)
+{
+    const int chromaWidth = (width + 1) / 2;
+    for (int row = 0; row < height; ++row) {
+        lumaRow(rgba + row * pitch, 0, width, y + static_cast<size_t>(row) * width);
+    }
+    for (int row = 0; row < height; row += 2) {
+        const uint8_t* r0 = rgba + row * pitch;
+        const uint8_t* r1 = rgba + std::min(row + 1, height - 1) * pitch;
+        const size_t   at = static_cast<size_t>(row / 2) * chromaWidth;
+        chromaRow(r0, r1, 0, width, u + at, v + at);
+    }
+}
+
+void rgbaToI420(const uint8_t* rgba, size_t pitch, int width, int height,
+                uint8_t* y, uint8_t* u, uint8_t* v)
+{
+    const int chromaWidth = (width + 1) / 2;
+    for (int row = 0; row < height; ++row) {
+        const uint8_t* in  = rgba + row * pitch;
+        uint8_t*       out = y + static_cast<size_t>(row) * width;
+        int done = 0;
+#if defined(__SSE2__)
+        done = lumaRowSSE2(in, width, out);
+#elif defined(__ARM_NEON)
+        done = lumaRowNEON(in, width, out);
+#endif
+        lumaRow(in, done, width, out);
+    }
+    for (int row = 0; row < height; row += 2) {
+        const uint8_t* r0 = rgba + row * pitch;
+        const uint8_t* r1 = rgba + std::min(row + 1, height - 1) * pitch;
+        const size_t   at = static_cast<size_t>(row / 2) * chromaWidth;
+        int done = 0;
+#if defined(__SSE2__)
+        done = chromaRowSSE2(r0, r1, width, u + at, v + at);
+#elif defined(__ARM_NEON)
+        done = chromaRowNEON(r0, r1, width, u + at, v + at);
+#endif
+        chromaRow(r0, r1, done, width, u + at, v + at);
+    }
+}
+
+// ------------------------------------------------------------
+// Recorder
+// ------------------------------------------------------------
+
+Recorder::~Recorder()
+{
+    stop();
+}
+
+bool Recorder::start(const CaptureConfig& config, int width, int height)
+{
+    stop();
+    if (width <= 0 || height <= 0) return false;
+
+    m_file = std::fopen(config.path.c_str(), "wb");
+    if (!m_file) {
+        LOG_WARN("[Capture] Cannot write %s", config.path.c_str());
+        return false;
+    }
+
+    m_config     = config;
+    m_width      = width;
+    m_height     = height;
+    m_frameBytes = static_cast<size_t>(width) * height * 4;
+    m_stats      = CaptureStats{};
+    m_stop       = false;
+    m_failed     = false;
+    m_config.buffers = std::max<size_t>(config.buffers, 1);
+
+    // everything the capture needs, up front: frames are never allocated
+    m_buffers.reset(new uint8_t[m_frameBytes * m_config.buffers]);
+    m_free.clear();
+    m_queued.clear();
+    m_free.reserve(m_config.buffers);
+    m_queued.reserve(m_config.buffers);
+    for (size_t i = 0; i < m_config.buffers; ++i) m_free.push_back(m_buffers.get() + i * m_frameBytes);
+
+    if (m_config.format == Format::Y4M) {
+        const size_t chroma = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+        m_planes.resize(static_cast<size_t>(width) * height + 2 * chroma);
+        std::fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n", width, height,
+                     std::max(m_config.fps, 1));
+    }
+
+    m_writer = std::thread([this] { writerLoop(); });
+    LOG_INFO("[Capture] Recording %dx%d %s to %s", width, height,
+             m_config.format == Format::Y4M ? "Y4M" : "raw RGBA", m_config.path.c_str());
+    return true;
+}
+
+void Recorder::stop()
+{
+    if (!m_file) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+
+    const bool closed = std::fclose(m_file) == 0;
+    m_file = nullptr;
+    if (!closed) m_failed = true;
+
+    LOG_INFO("[Capture] %s: %llu frames written, %llu dropped%s", m_config.path.c_str(),
+             static_cast<unsigned long long>(m_stats.written), static_cast<unsigned long long>(m_stats.dropped),
+             m_failed ? " (write failed)" : "");
+
+    m_buffers.reset();
+    m_free.clear();
+    m_queued.clear();
+    m_planes.clear();
+    m_planes.shrink_to_fit();
+}
+
+CaptureStats Recorder::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+uint8_t* Recorder::acquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_free.empty() || m_failed) {
+        ++m_stats.dropped;
+        return nullptr;
+    }
+    uint8_t* frame = m_free.back();
+    m_free.pop_back();
+    return frame;
+}
+
+void Recorder::submit(uint8_t* frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queued.push_back(frame);
+        ++m_stats.captured;
+    }
+    m_wake.notify_one();
+}
+
+void Recorder::release(uint8_t* frame)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(frame);
+    ++m_stats.dropped;
+}
+
+bool Recorder::fill(uint8_t* frame, SDL_Surface* surface)
+{
+    if (!surface || surface->w != m_width || surface->h != m_height) return false;
+
+    const bool lock = SDL_MUSTLOCK(surface);
+    if (lock && !SDL_LockSurface(surface)) return false;
+    const bool ok = SDL_ConvertPixels(m_width, m_height, surface->format, surface->pixels, surface->pitch,
+                                      SDL_PIXELFORMAT_RGBA32, frame, m_width * 4);
+    if (lock) SDL_UnlockSurface(surface);
+    return ok;
+}
+
+void Recorder::captureRenderer(SDL_Renderer* renderer)
+{
+    if (!m_file) return;
+    TRACE_ZONE("capture::Recorder::captureRenderer", "capture");
+
+    // no buffer, no read-back: a dropped frame costs nothing
+    uint8_t* frame = acquire();
+    if (!frame) return;
+
+    // SDL hands the pixels back in a surface of its own, one per call
+    SDL_Surface* pixels = SDL_RenderReadPixels(renderer, nullptr);
+    const bool ok = fill(frame, pixels);
+    SDL_DestroySurface(pixels);
+    if (ok) {
+        submit(frame);
+    } else {
+        release(frame);
+    }
+}
+
+void Recorder::captureSurface(SDL_Surface* surface)
+{
+    if (!m_file) return;
+    TRACE_ZONE("capture::Recorder::captureSurface", "capture");
+
+    uint8_t* frame = acquire();
+    if (!frame) return;
+    if (fill(frame, surface)) {
+        submit(frame);
+    } else {
+        release(frame);
+    }
+}
+
+void Recorder::writerLoop()
+{
+    trace::setThreadName("capture");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stop || !m_queued.empty(); });
+        if (m_queued.empty()) return;   // stopping, and everything is written
+
+        uint8_t* frame = m_queued.front();
+        m_queued.erase(m_queued.begin());
+        const bool failed = m_failed;
+        lock.unlock();
+
+        // once the disk has failed, what is still queued is dropped
+        const bool ok = !failed && writeFrame(frame);
+
+        lock.lock();
+        m_free.push_back(frame);
+        if (ok) {
+            ++m_stats.written;
+        } else {
+            ++m_stats.dropped;
+            if (!m_failed) LOG_WARN("[Capture] Writing %s failed; capture stopped", m_config.path.c_str());
+            m_failed = true;
+        }
+    }
+}
+
+bool Recorder::writeFrame(const uint8_t* frame)
+{
+    TRACE_ZONE("capture::Recorder::writeFrame", "capture");
+
+    if (m_config.format == Format::RawRGBA) return std::fwrite(frame, m_frameBytes, 1, m_file) == 1;
+
+    const size_t lumaBytes = static_cast<size_t>(m_width) * m_height;
+    const size_t chroma    = (m_planes.size() - lumaBytes) / 2;
+    uint8_t* y = m_planes.data();
+    rgbaToI420(frame, static_cast<size_t>(m_width) * 4, m_width, m_height, y, y + lumaBytes, y + lumaBytes + chroma);
+
+    static const char header[] = "FRAME\n";
+    return std::fwrite(header, sizeof(header) - 1, 1, m_file) == 1 &&
+           std::fwrite(m_planes.data(), m_planes.size(), 1, m_file) == 1;
+}
+
+} // namespace capture
@@ -0,0 +1,244 @@
+#include "Engine/CollisionMask.hpp"
+
+#include "Engine/Cpu.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || CPU_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+CollisionMask CollisionMask::fromRGBA(const uint8_t* pixels, int pitch,
+                                      int sheetWidth, int sheetHeight,
+                                      int frameWidth, int frameHeight)
+{
+    CollisionMask mask;
+    if (!pixels || sheetWidth <= 0 || sheetHeight <= 0) return mask;
+
+    if (frameWidth <= 0 || frameWidth > sheetWidth)    frameWidth  = sheetWidth;
+    if (frameHeight <= 0 || frameHeight > sheetHeight) frameHeight = sheetHeight;
+
+    mask.m_frameWidth  = frameWidth;
+    mask.m_frameHeight = frameHeight;
+    mask.m_columns     = sheetWidth / frameWidth;
+    mask.m_frameCount  = mask.m_columns * (sheetHeight / frameHeight);
+    mask.m_blocks      = (frameWidth + 63) / 64;
+    mask.m_bits.assign(static_cast<size_t>(mask.m_frameCount) * mask.m_blocks * frameHeight, 0);
+
+    for (int frame = 0; frame < mask.m_frameCount; ++frame) {
+        const int originX = (frame % mask.m_columns) * frameWidth;
+        const int originY = (frame / mask.m_columns) * frameHeight;
+
+        for (int y = 0; y < frameHeight; ++y) {
+            const uint8_t* row = pixels + static_cast<size_t>(originY + y) * pitch;
+            for (int x = 0; x < frameWidth; ++x) {
+                const uint8_t* px = row + (originX + x) * 4;
+                const bool keyed = (px[0] == 255 && px[1] == 0 && px[2] == 255) || px[3] == 0;
+                if (keyed) continue;
+
+                uint64_t* words = mask.m_bits.data()
+                                + (static_cast<size_t>(frame) * mask.m_blocks + x / 64) * frameHeight;
+                words[y] |= uint64_t{1} << (x % 64);
+            }
+        }
+    }
+    return mask;
+}
+
+CollisionMask CollisionMask::resampled(int frame, int width, int height) const
+{
+    CollisionMask out;
+    if (empty() || width <= 0 || height <= 0) return out;
+
+    out.m_frameWidth  = width;
+    out.m_frameHeight = height;
+    out.m_columns     = 1;
+    out.m_frameCount  = 1;
+    out.m_blocks      = (width + 63) / 64;
+    out.m_bits.assign(static_cast<size_t>(out.m_blocks) * height, 0);
+
+    for (int y = 0; y < height; ++y) {
+        const int sy = y * m_frameHeight / height;
+        for (int x = 0; x < width; ++x) {
+            const int sx = x * m_frameWidth / width;
+            if (testPixel(frame, sx, sy)) {
+                out.m_bits[static_cast<size_t>(x / 64) * height + y] |= uint64_t{1} << (x % 64);
+            }
+        }
+    }
+    return out;
+}
+
+int CollisionMask::frameAt(const SDL_FRect& src) const
+{
+    if (empty()) return 0;
+    const int column = static_cast<int>(src.x) / m_frameWidth;
+    const int row    = static_cast<int>(src.y) / m_frameHeight;
+    // strips that step past the sheet width wrap like a flat frame index
+    return (row * m_columns + column) % m_frameCount;
+}
+
+bool CollisionMask::testPixel(int frame, int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= m_frameWidth || y >= m_frameHeight) return false;
+    return (block(frame, x / 64)[y] >> (x % 64)) & 1u;
+}
+
+// ------------------------------------------------------------
+// Narrow-phase
+// ------------------------------------------------------------
+namespace {
+
+    // Where one 64 pixel strip of the overlap starts inside a mask.
+    // The strip is (lo >> shift) | (hi << hiShift); a hiShift of 64
+    // means there is no next block and contributes nothing.
+    struct Strip {
+        const uint64_t* lo;
+        const uint64_t* hi;
+        int             shift;
+        int             hiShift;
+    };
+
+    Strip stripAt(const CollisionMask& m, int frame, int localX, int firstRow)
+    {
+        const int blockIndex = localX / 64;
+        const int shift      = localX % 64;
+
+        Strip s;
+        s.lo    = m.block(frame, blockIndex) + firstRow;
+        s.shift = shift;
+        if (blockIndex + 1 < m.blocks()) {
+            s.hi      = m.block(frame, blockIndex + 1) + firstRow;
+            s.hiShift = 64 - shift;
+        } else {
+            s.hi      = s.lo;
+            s.hiShift = 64;
+        }
+        return s;
+    }
+
+    inline uint64_t scalarRow(const Strip& s, int r)
+    {
+        const uint64_t hi = s.hiShift < 64 ? (s.hi[r] << s.hiShift) : 0;
+        return (s.lo[r] >> s.shift) | hi;
+    }
+
+    bool rowsOverlapScalar(const Strip& a, const Strip& b, uint64_t keep, int rows, int r)
+    {
+        for (; r < rows; ++r) {
+            if (scalarRow(a, r) & scalarRow(b, r) & keep) return true;
+        }
+        return false;
+    }
+
+#if CPU_AVX2
+    // 4 rows a step from 'r', which it leaves where it stopped
+    CPU_AVX2_FN bool rowsOverlapAvx2(const Strip& a, const Strip& b, uint64_t keep, int rows, int& r)
+    {
+        const __m128i sa = _mm_cvtsi32_si128(a.shift);
+        const __m128i ha = _mm_cvtsi32_si128(a.hiShift);
+        const __m128i sb = _mm_cvtsi32_si128(b.shift);
+        const __m128i hb = _mm_cvtsi32_si128(b.hiShift);
+        const __m256i k  = _mm256_set1_epi64x(static_cast<long long>(keep));
+        for (; r + 4 <= rows; r += 4) {
+            const __m256i va = _mm256_or_si256(
+                _mm256_srl_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.lo + r)), sa),
+                _mm256_sll_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.hi + r)), ha));
+            const __m256i vb = _mm256_or_si256(
+                _mm256_srl_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.lo + r)), sb),
+                _mm256_sll_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.hi + r)), hb));
+            const __m256i hit = _mm256_and_si256(_mm256_and_si256(va, vb), k);
+            if (!_mm256_testz_si256(hit, hit)) return true;
+        }
+        return false;
+    }
+#endif
+
+    bool rowsOverlap(const Strip& a, const Strip& b, uint64_t keep, int rows, [[maybe_unused]] cpu::Simd level)
+    {
+        int r = 0;
+
+#if CPU_AVX2
+        if (level >= cpu::Simd::Avx2 && rowsOverlapAvx2(a, b, keep, rows, r)) return true;
+#endif
+
+#if defined(__SSE2__)
+        if (level >= cpu::Simd::Vector128) {
+            // shifts of 64 or more produce zero, which covers the missing next block
+            const __m128i sa = _mm_cvtsi32_si128(a.shift);
+            const __m128i ha = _mm_cvtsi32_si128(a.hiShift);
+            const __m128i sb = _mm_cvtsi32_si128(b.shift);
+            const __m128i hb = _mm_cvtsi32_si128(b.hiShift);
+            const __m128i k  = _mm_set1_epi64x(static_cast<long long>(keep));
+            const __m128i zero = _mm_setzero_si128();
+            for (; r + 2 <= rows; r += 2) {
+                const __m128i va = _mm_or_si128(
+                    _mm_srl_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.lo + r)), sa),
+                    _mm_sll_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.hi + r)), ha));
+                const __m128i vb = _mm_or_si128(
+                    _mm_srl_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.lo + r)), sb),
+                    _mm_sll_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.hi + r)), hb));
+                const __m128i hit = _mm_and_si128(_mm_and_si128(va, vb), k);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(hit, zero)) != 0xFFFF) return true;
+            }
+        }
+#elif defined(__ARM_NEON)
+        if (level >= cpu::Simd::Vector128) {
+            // USHL by a negative count shifts right; counts >= 64 produce zero
+            const int64x2_t sa = vdupq_n_s64(-a.shift);
+            const int64x2_t ha = vdupq_n_s64(a.hiShift);
+            const int64x2_t sb = vdupq_n_s64(-b.shift);
+            const int64x2_t hb = vdupq_n_s64(b.hiShift);
+            const uint64x2_t k = vdupq_n_u64(keep);
+            for (; r + 2 <= rows; r += 2) {
+                const uint64x2_t va = vorrq_u64(vshlq_u64(vld1q_u64(a.lo + r), sa),
+                                                vshlq_u64(vld1q_u64(a.hi + r), ha));
+                const uint64x2_t vb = vorrq_u64(vshlq_u64(vld1q_u64(b.lo + r), sb),
+                                                vshlq_u64(vld1q_u64(b.hi + r), hb));
+                const uint64x2_t hit = vandq_u64(vandq_u64(va, vb), k);
+                if (vgetq_lane_u64(hit, 0) | vgetq_lane_u64(hit, 1)) return true;
+            }
+        }
+#endif
+
+        return rowsOverlapScalar(a, b, keep, rows, r);
+    }
+
+    bool overlapImpl(cpu::Simd level,
+                     const CollisionMask& a, int frameA, int ax, int ay,
+                     const CollisionMask& b, int frameB, int bx, int by)
+    {
+        if (a.empty() || b.empty()) return false;
+
+        const int x0 = std::max(ax, bx);
+        const int x1 = std::min(ax + a.frameWidth(), bx + b.frameWidth());
+        const int y0 = std::max(ay, by);
+        const int y1 = std::min(ay + a.frameHeight(), by + b.frameHeight());
+        if (x0 >= x1 || y0 >= y1) return false;
+
+        const int rows = y1 - y0;
+        for (int sx = x0; sx < x1; sx += 64) {
+            const int      width = std::min(64, x1 - sx);
+            const uint64_t keep  = width == 64 ? ~uint64_t{0} : ((uint64_t{1} << width) - 1);
+
+            const Strip sa = stripAt(a, frameA, sx - ax, y0 - ay);
+            const Strip sb = stripAt(b, frameB, sx - bx, y0 - by);
+            if (rowsOverlap(sa, sb, keep, rows, level)) return true;
+        }
+        return false;
+    }
+}
+
+bool masksOverlap(const CollisionMask& a, int frameA, int ax, int ay,
+                  const CollisionMask& b, int frameB, int bx, int by)
+{
+    return overlapImpl(cpu::simd(), a, frameA, ax, ay, b, frameB, bx, by);
+}
+
+bool masksOverlapScalar(const CollisionMask& a, int frameA, int ax, int ay,
+                        const CollisionMask& b, int frameB, int bx, int by)
+{
+    return overlapImpl(cpu::Simd::Scalar, a, frameA, ax, ay, b, frameB, bx, by);
+}
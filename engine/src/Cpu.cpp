@@ -0,0 +1,58 @@
+#include "Engine/Cpu.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace cpu {
+
+namespace {
+
+    Simd probe()
+    {
+#if CPU_AVX2 && (defined(__GNUC__) || defined(__clang__))
+        if (__builtin_cpu_supports("avx2")) return Simd::Avx2;
+#elif CPU_AVX2
+        return Simd::Avx2;
+#endif
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+        return Simd::Vector128;
+#else
+        return Simd::Scalar;
+#endif
+    }
+
+    std::atomic<Simd> s_limit{Simd::Avx2};   // read by the audio thread too
+
+} // namespace
+
+const char* simdName(Simd level)
+{
+    switch (level) {
+        case Simd::Scalar:    return "scalar";
+#if defined(__ARM_NEON)
+        case Simd::Vector128: return "neon";
+#else
+        case Simd::Vector128: return "sse2";
+#endif
+        case Simd::Avx2:      return "avx2";
+    }
+    return "?";
+}
+
+Simd detected()
+{
+    static const Simd s_detected = probe();
+    return s_detected;
+}
+
+Simd simd()
+{
+    return std::min(detected(), s_limit.load(std::memory_order_relaxed));
+}
+
+void limitSimd(Simd most)
+{
+    s_limit.store(most, std::memory_order_relaxed);
+}
+
+} // namespace cpu
@@ -0,0 +1,528 @@
+#include "Engine/ECS.hpp"
+#include "Engine/Log.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+namespace ecs {
+
+// ------------------------------------------------------------
+// Component registry
+// ------------------------------------------------------------
+namespace {
+    struct ComponentInfo {
+        size_t size;
+        size_t align;
+    };
+
+    std::mutex                 g_registryMutex;
+    std::vector<ComponentInfo> g_components;
+}
+
+namespace detail {
+
+ComponentId registerComponent(size_t size, size_t align)
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (g_components.size() >= MAX_COMPONENTS) {
+        LOG_ERROR("[ECS] Too many component types (max %u)", MAX_COMPONENTS);
+        logging::flush();
+        std::abort();
+    }
+    g_components.push_back({size, align});
+    return static_cast<ComponentId>(g_components.size() - 1);
+}
+
+size_t componentSize(ComponentId id)
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    return g_components[id].size;
+}
+
+ComponentId componentCount()
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    return static_cast<ComponentId>(g_components.size());
+}
+
+} // namespace detail
+
+namespace {
+    size_t componentAlign(ComponentId id)
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        return g_components[id].align;
+    }
+
+    size_t alignUp(size_t value, size_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    // Lays out the entity column followed by one column per component.
+    // Returns false if 'capacity' rows do not fit into one chunk.
+    bool layoutColumns(Archetype& arch, uint32_t capacity)
+    {
+        size_t cursor = sizeof(Entity) * capacity;
+        for (ComponentId id : arch.components) {
+            if (arch.stride[id] == 0) {
+                // tags: any address inside the chunk will do
+                arch.offset[id] = 0;
+                continue;
+            }
+            cursor = alignUp(cursor, componentAlign(id));
+            arch.offset[id] = static_cast<int32_t>(cursor);
+            cursor += arch.stride[id] * capacity;
+        }
+        return cursor <= CHUNK_BYTES;
+    }
+
+    // True if every bit names a registered component and one row of
+    // them fits into a chunk, i.e. archetypeFor(mask) will not abort
+    bool validMask(ComponentMask mask)
+    {
+        const ComponentId count = detail::componentCount();
+        if (count < MAX_COMPONENTS && (mask >> count) != 0) return false;
+
+        size_t cursor = sizeof(Entity);
+        for (ComponentId id = 0; id < count; ++id) {
+            if (!(mask & (ComponentMask{1} << id))) continue;
+            const size_t size = detail::componentSize(id);
+            if (size == 0) continue;
+            cursor = alignUp(cursor, componentAlign(id)) + size;
+        }
+        return cursor <= CHUNK_BYTES;
+    }
+}
+
+// ------------------------------------------------------------
+// World
+// ------------------------------------------------------------
+World::World(std::pmr::memory_resource* resource)
+    : m_resource(resource)
+    , m_archetypes(resource)
+    , m_archetypeLookup(resource)
+    , m_records(resource)
+    , m_freeIndices(resource)
+    , m_spareChunks(resource)
+    , m_pendingCreates(resource)
+    , m_pendingDestroys(resource)
+{
+}
+
+World::~World()
+{
+    for (Archetype& arch : m_archetypes) {
+        for (Chunk& chunk : arch.chunks) {
+            m_resource->deallocate(chunk.data, CHUNK_BYTES, 64);
+        }
+    }
+    for (std::byte* data : m_spareChunks) {
+        m_resource->deallocate(data, CHUNK_BYTES, 64);
+    }
+}
+
+Entity World::allocateEntity()
+{
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_records.size());
+        m_records.emplace_back();
+    }
+
+    Record& rec = m_records[index];
+    rec.alive = true;
+    ++m_liveCount;
+    return Entity{index, rec.generation};
+}
+
+uint32_t World::archetypeFor(ComponentMask mask)
+{
+    auto it = m_archetypeLookup.find(mask);
+    if (it != m_archetypeLookup.end()) {
+        return it->second;
+    }
+
+    Archetype arch(m_resource);
+    arch.mask = mask;
+    arch.offset.fill(-1);
+
+    size_t rowBytes = sizeof(Entity);
+    for (ComponentId id = 0; id < MAX_COMPONENTS; ++id) {
+        if (mask & (ComponentMask{1} << id)) {
+            arch.components.push_back(id);
+            arch.stride[id] = static_cast<uint32_t>(detail::componentSize(id));
+            rowBytes += arch.stride[id];
+        }
+    }
+
+    // start from the unpadded estimate and back off until alignment fits
+    uint32_t capacity = static_cast<uint32_t>(CHUNK_BYTES / rowBytes);
+    while (capacity > 1 && !layoutColumns(arch, capacity)) {
+        --capacity;
+    }
+    if (!layoutColumns(arch, capacity)) {
+        LOG_ERROR("[ECS] Archetype row does not fit into a chunk");
+        logging::flush();
+        std::abort();
+    }
+    arch.capacity = capacity;
+
+    const uint32_t index = static_cast<uint32_t>(m_archetypes.size());
+    m_archetypes.push_back(std::move(arch));
+    m_archetypeLookup.emplace(mask, index);
+    return index;
+}
+
+std::byte* World::allocateChunk()
+{
+    if (!m_spareChunks.empty()) {
+        std::byte* data = m_spareChunks.back();
+        m_spareChunks.pop_back();
+        return data;
+    }
+    return static_cast<std::byte*>(m_resource->allocate(CHUNK_BYTES, 64));
+}
+
+void World::releaseChunk(std::byte* data)
+{
+    m_spareChunks.push_back(data);
+}
+
+void World::insertRow(uint32_t archetype, Entity e)
+{
+    Archetype& arch = m_archetypes[archetype];
+    if (arch.chunks.empty() || arch.chunks.back().count == arch.capacity) {
+        arch.chunks.push_back(Chunk{allocateChunk(), 0});
+    }
+
+    Chunk& chunk = arch.chunks.back();
+    const uint32_t row = chunk.count++;
+    arch.entities(chunk)[row] = e;
+    ++arch.size;
+
+    Record& rec   = m_records[e.index];
+    rec.archetype = archetype;
+    rec.chunk     = static_cast<uint32_t>(arch.chunks.size() - 1);
+    rec.row       = row;
+}
+
+void World::removeRow(const Record& rec)
+{
+    Archetype& arch = m_archetypes[rec.archetype];
+    Chunk& last     = arch.chunks.back();
+    Chunk& chunk    = arch.chunks[rec.chunk];
+
+    // move the last row of the archetype into the hole
+    const uint32_t lastRow = last.count - 1;
+    if (&chunk != &last || rec.row != lastRow) {
+        const Entity moved = arch.entities(last)[lastRow];
+        arch.entities(chunk)[rec.row] = moved;
+        for (ComponentId id : arch.components) {
+            std::memcpy(arch.at(chunk, id, rec.row), arch.at(last, id, lastRow), arch.stride[id]);
+        }
+
+        Record& movedRec = m_records[moved.index];
+        movedRec.chunk   = rec.chunk;
+        movedRec.row     = rec.row;
+    }
+
+    --last.count;
+    --arch.size;
+    if (last.count == 0) {
+        releaseChunk(last.data);
+        arch.chunks.pop_back();
+    }
+}
+
+std::byte* World::componentPtr(const Record& rec, ComponentId id)
+{
+    const Archetype& arch = m_archetypes[rec.archetype];
+    return arch.at(arch.chunks[rec.chunk], id, rec.row);
+}
+
+void World::moveEntity(Entity e, ComponentMask newMask)
+{
+    const Record old = m_records[e.index];
+    if (m_archetypes[old.archetype].mask == newMask) return;
+
+    const uint32_t target = archetypeFor(newMask);
+    insertRow(target, e);
+
+    // archetypeFor may have grown m_archetypes; fetch references afterwards
+    const Archetype& from = m_archetypes[old.archetype];
+    const Record&    now  = m_records[e.index];
+    for (ComponentId id : from.components) {
+        if (newMask & (ComponentMask{1} << id)) {
+            std::memcpy(componentPtr(now, id), from.at(from.chunks[old.chunk], id, old.row), from.stride[id]);
+        }
+    }
+
+    removeRow(old);
+}
+
+void World::destroy(Entity e)
+{
+    if (!isAlive(e)) return;
+
+    Record& rec = m_records[e.index];
+    removeRow(rec);
+    rec.alive = false;
+    ++rec.generation;
+    m_freeIndices.push_back(e.index);
+    --m_liveCount;
+}
+
+bool World::isAlive(Entity e) const
+{
+    return e.index < m_records.size()
+        && m_records[e.index].alive
+        && m_records[e.index].generation == e.generation;
+}
+
+void World::destroyDeferred(Entity e)
+{
+    m_pendingDestroys.push_back(e);
+}
+
+void World::flush()
+{
+    // destroy first so the creates below can reuse the freed rows
+    for (Entity e : m_pendingDestroys) {
+        destroy(e);
+    }
+    m_pendingDestroys.clear();
+
+    const std::byte* cursor = m_pendingCreates.data();
+    const std::byte* end    = cursor + m_pendingCreates.size();
+    while (cursor < end) {
+        ComponentMask mask;
+        uint32_t      count;
+        std::memcpy(&mask, cursor, sizeof(mask));   cursor += sizeof(mask);
+        std::memcpy(&count, cursor, sizeof(count)); cursor += sizeof(count);
+
+        const Entity e = allocateEntity();
+        insertRow(archetypeFor(mask), e);
+        const Record& rec = m_records[e.index];
+
+        for (uint32_t i = 0; i < count; ++i) {
+            ComponentId id;
+            uint32_t    size;
+            std::memcpy(&id, cursor, sizeof(id));     cursor += sizeof(id);
+            std::memcpy(&size, cursor, sizeof(size)); cursor += sizeof(size);
+            std::memcpy(componentPtr(rec, id), cursor, size);
+            cursor += size;
+        }
+    }
+    m_pendingCreates.clear();
+}
+
+void World::clear()
+{
+    for (Archetype& arch : m_archetypes) {
+        for (Chunk& chunk : arch.chunks) {
+            releaseChunk(chunk.data);
+        }
+        arch.chunks.clear();
+        arch.size = 0;
+    }
+
+    m_freeIndices.clear();
+    for (uint32_t i = 0; i < m_records.size(); ++i) {
+        Record& rec = m_records[i];
+        if (rec.alive) {
+            rec.alive = false;
+            ++rec.generation;
+        }
+        m_freeIndices.push_back(i);
+    }
+    m_liveCount = 0;
+
+    m_pendingCreates.clear();
+    m_pendingDestroys.clear();
+}
+
+// ------------------------------------------------------------
+// Snapshots
+//
+// [recordCount][freeCount][archetypeCount]
+// [generation] per record, [index] per free slot, then for every
+// non-empty archetype: [mask][size], the entity column and one
+// column per component, each concatenated over the chunks.
+// ------------------------------------------------------------
+void World::save(snapshot::Writer& out) const
+{
+    uint32_t archetypes = 0;
+    for (const Archetype& arch : m_archetypes) {
+        if (arch.size > 0) ++archetypes;
+    }
+
+    out.put(static_cast<uint32_t>(m_records.size()));
+    out.put(static_cast<uint32_t>(m_freeIndices.size()));
+    out.put(archetypes);
+
+    std::byte* generations = out.reserve(m_records.size() * sizeof(uint32_t));
+    for (const Record& rec : m_records) {
+        std::memcpy(generations, &rec.generation, sizeof(uint32_t));
+        generations += sizeof(uint32_t);
+    }
+    out.bytes(m_freeIndices.data(), m_freeIndices.size() * sizeof(uint32_t));
+
+    for (const Archetype& arch : m_archetypes) {
+        if (arch.size == 0) continue;
+        out.put(arch.mask);
+        out.put(arch.size);
+
+        std::byte* dst = out.reserve(static_cast<size_t>(arch.size) * sizeof(Entity));
+        for (const Chunk& chunk : arch.chunks) {
+            std::memcpy(dst, chunk.data, chunk.count * sizeof(Entity));
+            dst += chunk.count * sizeof(Entity);
+        }
+
+        for (ComponentId id : arch.components) {
+            const size_t stride = arch.stride[id];
+            if (stride == 0) continue;
+            dst = out.reserve(arch.size * stride);
+            for (const Chunk& chunk : arch.chunks) {
+                std::memcpy(dst, arch.at(chunk, id, 0), chunk.count * stride);
+                dst += chunk.count * stride;
+            }
+        }
+    }
+}
+
+bool World::load(snapshot::Reader& in)
+{
+    // like clear(), without rebuilding records and free list that
+    // are overwritten below
+    for (Archetype& arch : m_archetypes) {
+        for (Chunk& chunk : arch.chunks) {
+            releaseChunk(chunk.data);
+        }
+        arch.chunks.clear();
+        arch.size = 0;
+    }
+    m_liveCount = 0;
+    m_pendingCreates.clear();
+    m_pendingDestroys.clear();
+
+    auto fail = [this] {
+        clear();
+        LOG_ERROR("[ECS] Malformed world snapshot");
+        return false;
+    };
+
+    uint32_t recordCount = 0, freeCount = 0, archetypes = 0;
+    if (!in.get(recordCount) || !in.get(freeCount) || !in.get(archetypes)) return fail();
+
+    const std::byte* generations = in.take(static_cast<size_t>(recordCount) * sizeof(uint32_t));
+    const std::byte* freeIndices = in.take(static_cast<size_t>(freeCount) * sizeof(uint32_t));
+    if (!in.ok()) return fail();
+
+    m_records.resize(recordCount);
+    for (uint32_t i = 0; i < recordCount; ++i) {
+        Record& rec = m_records[i];
+        std::memcpy(&rec.generation, generations + i * sizeof(uint32_t), sizeof(uint32_t));
+        rec.alive = false;
+    }
+    m_freeIndices.resize(freeCount);
+    if (freeCount > 0) std::memcpy(m_freeIndices.data(), freeIndices, freeCount * sizeof(uint32_t));
+
+    for (uint32_t a = 0; a < archetypes; ++a) {
+        ComponentMask mask = 0;
+        uint32_t      size = 0;
+        if (!in.get(mask) || !in.get(size)) return fail();
+        // empty archetypes are not saved, and every row is a distinct record
+        if (!validMask(mask) || size == 0 || size > recordCount) return fail();
+
+        const uint32_t index = archetypeFor(mask);
+        Archetype& arch = m_archetypes[index];
+        if (!arch.chunks.empty()) return fail();   // archetype listed twice
+
+        const std::byte* entities = in.take(static_cast<size_t>(size) * sizeof(Entity));
+        std::array<const std::byte*, MAX_COMPONENTS> columns{};
+        for (ComponentId id : arch.components) {
+            columns[id] = in.take(static_cast<size_t>(size) * arch.stride[id]);
+        }
+        if (!in.ok()) return fail();
+
+        // refill chunks to capacity, which reproduces the saved split
+        for (uint32_t first = 0; first < size; first += arch.capacity) {
+            const uint32_t count = std::min(arch.capacity, size - first);
+            arch.chunks.push_back(Chunk{allocateChunk(), count});
+            const Chunk& chunk = arch.chunks.back();
+
+            std::memcpy(chunk.data, entities + first * sizeof(Entity), count * sizeof(Entity));
+            for (ComponentId id : arch.components) {
+                const size_t stride = arch.stride[id];
+                if (stride == 0) continue;
+                std::memcpy(arch.at(chunk, id, 0), columns[id] + first * stride, count * stride);
+            }
+
+            const uint32_t chunkIndex = static_cast<uint32_t>(arch.chunks.size() - 1);
+            const Entity*  rows       = arch.entities(chunk);
+            for (uint32_t row = 0; row < count; ++row) {
+                const Entity e = rows[row];
+                if (e.index >= recordCount) return fail();
+                Record& rec = m_records[e.index];
+                if (rec.alive || rec.generation != e.generation) return fail();
+                rec.alive     = true;
+                rec.archetype = index;
+                rec.chunk     = chunkIndex;
+                rec.row       = row;
+            }
+            arch.size += count;
+        }
+        m_liveCount += size;
+    }
+
+    for (uint32_t index : m_freeIndices) {
+        if (index >= recordCount || m_records[index].alive) return fail();
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Scheduler
+// ------------------------------------------------------------
+bool Scheduler::conflicts(const SystemAccess& a, const SystemAccess& b)
+{
+    return (a.writes & (b.reads | b.writes)) != 0
+        || (b.writes & a.reads) != 0;
+}
+
+void Scheduler::add(std::string name, SystemAccess access, SystemFn fn)
+{
+    const uint32_t index = static_cast<uint32_t>(m_systems.size());
+    m_systems.push_back({std::move(name), access, std::move(fn)});
+
+    // join the current stage unless this system races with a member of it
+    bool newStage = m_stages.empty();
+    if (!newStage) {
+        for (uint32_t other : m_stages.back()) {
+            if (conflicts(access, m_systems[other].access)) {
+                newStage = true;
+                break;
+            }
+        }
+    }
+
+    if (newStage) m_stages.emplace_back();
+    m_stages.back().push_back(index);
+}
+
+void Scheduler::run(World& world, float dt)
+{
+    for (const auto& stage : m_stages) {
+        for (uint32_t index : stage) {
+            m_systems[index].fn(world, dt);
+        }
+        world.flush();
+    }
+}
+
+} // namespace ecs
@@ -1,7 +1,11 @@
 #include "Engine/Engine.hpp"
+#include "Engine/Draw.hpp"
+#include "Engine/Log.hpp"
+#include "Engine/Trace.hpp"
 
-
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 
 Engine::Engine(int width, int height, const std::string& title, IGame& game)
     : m_width(width)
@@ -19,12 +23,27 @@ Engine::~Engine()
 bool Engine::init()
 {
     if (!initSDL()) {
-        std::cerr << "[Engine] Failed to init SDL\n";
+        LOG_ERROR("[Engine] Failed to init SDL");
         return false;
     }
 
+    return initGame();
+}
+
+bool Engine::initOffscreen()
+{
+    if (!initSoftwareRenderer()) {
+        LOG_ERROR("[Engine] Failed to init offscreen renderer");
+        return false;
+    }
+
+    return initGame();
+}
+
+bool Engine::initGame()
+{
     if (!initBox2D()) {
-        std::cerr << "[Engine] Failed to init Box2D\n";
+        LOG_ERROR("[Engine] Failed to init Box2D");
         return false;
     }
 
@@ -36,10 +55,15 @@ bool Engine::init()
     m_ctx.width    = m_width;
     m_ctx.height   = m_height;
     m_ctx.textures = &m_textureManager;
+    m_ctx.audio    = &m_audio;
+    m_ctx.recorder = &m_recorder;
+    m_ctx.frameArena = &m_frameArena;
+    m_ctx.stats    = &m_stats;
+    m_ctx.tick     = &m_tick;
 
 
     if (!m_game.init(m_ctx)) {
-        std::cerr << "[Engine] Game init failed\n";
+        LOG_ERROR("[Engine] Game init failed");
         return false;
     }
 
@@ -48,11 +72,14 @@ bool Engine::init()
 
 bool Engine::initSDL()
 {
+    // count SDL's heap use too; has to happen before SDL allocates
+    memory::installSDLAllocationHooks();
+
     SDL_SetHint("SDL_HINT_RENDER_SCALE_QUALITY", "0");
 
     // include gamepads for that 5% mark later
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD)) {
-        std::cerr << "[Engine] SDL_Init failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("[Engine] SDL_Init failed: %s", SDL_GetError());
         return false;
     }
 
@@ -64,23 +91,54 @@ bool Engine::initSDL()
     );
 
     if (!m_window) {
-        std::cerr << "[Engine] SDL_CreateWindow failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("[Engine] SDL_CreateWindow failed: %s", SDL_GetError());
         return false;
     }
 
     // SDL3: two parameters, then enable vsync separately
     m_renderer = SDL_CreateRenderer(m_window, nullptr);
     if (!m_renderer) {
-        std::cerr << "[Engine] SDL_CreateRenderer failed: " << SDL_GetError() << "\n";
+        LOG_ERROR("[Engine] SDL_CreateRenderer failed: %s", SDL_GetError());
         return false;
     }
 
     if (!SDL_SetRenderVSync(m_renderer, 1)) {
-        std::cerr << "[Engine] SDL_SetRenderVSync failed: "
-                  << SDL_GetError() << "\n";
+        LOG_WARN("[Engine] SDL_SetRenderVSync failed: %s", SDL_GetError());
         // not fatal
     }
 
+    // audio on its own: a machine without sound still runs the game
+    if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+        LOG_WARN("[Engine] No audio: %s", SDL_GetError());
+    } else {
+        m_audio.open();
+    }
+
+    return true;
+}
+
+bool Engine::initSoftwareRenderer()
+{
+    memory::installSDLAllocationHooks();
+
+    // no video subsystem: the software renderer only needs a surface
+    if (!SDL_Init(0)) {
+        LOG_ERROR("[Engine] SDL_Init failed: %s", SDL_GetError());
+        return false;
+    }
+
+    m_offscreen = SDL_CreateSurface(m_width, m_height, SDL_PIXELFORMAT_ARGB8888);
+    if (!m_offscreen) {
+        LOG_ERROR("[Engine] SDL_CreateSurface failed: %s", SDL_GetError());
+        return false;
+    }
+
+    m_renderer = SDL_CreateSoftwareRenderer(m_offscreen);
+    if (!m_renderer) {
+        LOG_ERROR("[Engine] SDL_CreateSoftwareRenderer failed: %s", SDL_GetError());
+        return false;
+    }
+
     return true;
 }
 
@@ -93,11 +151,13 @@ bool Engine::initBox2D()
 
     m_world = b2CreateWorld(&worldDef);
     if (B2_IS_NULL(m_world)) {
-        std::cerr << "[Engine] Failed to create Box2D world\n";
+        LOG_ERROR("[Engine] Failed to create Box2D world");
         return false;
     }
 
-    std::cout << "[Engine] Box2D world initialized\n";
+    m_physics.setWorld(m_world);
+
+    LOG_INFO("[Engine] Box2D world initialized");
     return true;
 }
 
@@ -106,25 +166,166 @@ void Engine::run()
     bool running = true;
     uint64_t lastTicks = SDL_GetTicks();
 
+    trace::setThreadName("main");
+
+    using Clock = std::chrono::steady_clock;
+    auto since = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
     while (running) {
+        waitForFrame(lastTicks);
+
+        // nothing to show: only events, until the window comes back
+        if (windowHidden()) {
+            processEvents(running);
+            lastTicks = SDL_GetTicks();
+            continue;
+        }
+
+        TRACE_ZONE("Frame", "engine");
+        const memory::AllocationCounters frameStart = memory::allocationCounters();
+        const auto frameBegin = Clock::now();
+        m_recorder.beginFrame(m_stats.frameIndex, m_tick);
+
+        // physics launched last frame lands here, before anything reads the world
+        syncPhysics();
+
         uint64_t currentTicks = SDL_GetTicks();
         float dt = static_cast<float>(currentTicks - lastTicks) / 1000.0f;
         lastTicks = currentTicks;
 
+        const auto workStart = Clock::now();
+        auto sectionStart = workStart;
         processEvents(running);
+        m_recorder.section(flight::Section::Events, since(sectionStart));
+
+        sectionStart = Clock::now();
         update(dt);
+        m_recorder.section(flight::Section::Update, since(sectionStart));
+
+        sectionStart = Clock::now();
         render();
+        m_recorder.section(flight::Section::Render, since(sectionStart));
+        governFrame(since(workStart));
+
+        // after the governor: capturing must not lower the quality it records
+        sectionStart = Clock::now();
+        captureFrame();
+        m_stats.captureMs = since(sectionStart);
+        m_recorder.section(flight::Section::Capture, m_stats.captureMs);
+
+        sectionStart = Clock::now();
+        present();
+        m_recorder.section(flight::Section::Present, since(sectionStart));
+
+        endFrame(frameStart);
+        m_recorder.section(flight::Section::Physics, m_stats.physicsMs);
+        m_recorder.endFrame(since(frameBegin), m_stats.allocations, m_stats.allocatedBytes, m_stats.drawCalls,
+                            m_stats.arenaBytes, m_stats.physicsSteps, m_stats.quality);
     }
 }
 
+// The level is read by the game on the next frame through FrameStats
+void Engine::governFrame(double workMs)
+{
+    m_stats.workMs = workMs;
+    const int before = m_governor.level();
+    if (m_governor.addFrame(workMs)) {
+        const int now = m_governor.level();
+        if (now > before) {
+            LOG_WARN("[Engine] Frame budget missed: quality %s -> %s (%.2f ms average, budget %.2f ms)",
+                     FrameGovernor::levelName(before), FrameGovernor::levelName(now),
+                     m_governor.averageMs(), m_governor.budgetMs());
+        } else {
+            LOG_INFO("[Engine] Frame budget regained: quality %s -> %s (%.2f ms average, budget %.2f ms)",
+                     FrameGovernor::levelName(before), FrameGovernor::levelName(now),
+                     m_governor.averageMs(), m_governor.budgetMs());
+        }
+    }
+    m_stats.quality = m_governor.level();
+}
+
+void Engine::endFrame(const memory::AllocationCounters& frameStart)
+{
+    const memory::AllocationCounters now = memory::allocationCounters();
+
+    m_stats.frameIndex++;
+    m_stats.allocations    = now.allocations - frameStart.allocations;
+    m_stats.allocatedBytes = now.bytes - frameStart.bytes;
+    m_stats.arenaBytes     = m_frameArena.used();
+    m_stats.drawCalls      = draw::counters().drawCalls;
+
+    // everything the game put in the arena this frame is gone now
+    m_frameArena.reset();
+
+    m_reportAllocations += m_stats.allocations;
+    m_reportBytes       += m_stats.allocatedBytes;
+    if (m_stats.allocations > m_reportPeak) m_reportPeak = m_stats.allocations;
+
+    if (m_stats.frameIndex % s_allocReportFrames == 0) {
+        if (m_reportAllocations > 0) {
+            LOG_INFO("[Engine] last %llu frames: %llu system allocations (%llu bytes), peak %llu/frame, arena high water %zu bytes",
+                     static_cast<unsigned long long>(s_allocReportFrames),
+                     static_cast<unsigned long long>(m_reportAllocations),
+                     static_cast<unsigned long long>(m_reportBytes),
+                     static_cast<unsigned long long>(m_reportPeak),
+                     m_frameArena.highWater());
+        }
+        m_reportAllocations = 0;
+        m_reportBytes       = 0;
+        m_reportPeak        = 0;
+    }
+}
+
+bool Engine::windowHidden() const
+{
+    // an export reader still wants the frames nobody sees
+    if (!m_window || m_export.active()) return false;
+    return (SDL_GetWindowFlags(m_window) & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED | SDL_WINDOW_OCCLUDED)) != 0;
+}
+
+// Sleeps in SDL_WaitEventTimeout while the window is hidden, or until
+// the game's next frame is due when it asks for a low refresh rate.
+// The event stays queued for processEvents.
+void Engine::waitForFrame(uint64_t lastFrameTicks)
+{
+    int32_t waitMs = 0;
+    if (windowHidden()) {
+        waitMs = s_hiddenWaitMs;
+    } else {
+        const FramePacing pacing = m_game.pacing();
+        if (pacing.refreshHz <= 0.0f) return;
+
+        const uint64_t intervalMs = static_cast<uint64_t>(1000.0f / pacing.refreshHz);
+        const uint64_t elapsedMs  = SDL_GetTicks() - lastFrameTicks;
+        if (elapsedMs >= intervalMs) return;
+        waitMs = static_cast<int32_t>(intervalMs - elapsedMs);
+    }
+
+    TRACE_ZONE("Engine::idle", "engine");
+    SDL_WaitEventTimeout(nullptr, waitMs);
+}
+
 void Engine::processEvents(bool& running)
 {
+    TRACE_ZONE("Engine::processEvents", "engine");
+
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
         if (e.type == SDL_EVENT_QUIT) {
             running = false;
         }
 
+        if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_F9 && !e.key.repeat) {
+            toggleTrace();
+        }
+        if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_F10 && !e.key.repeat) {
+            toggleCapture();
+        }
+
+        m_recorder.event(e);
+
         // Forward everything to the game
         m_game.handleEvent(e, running);
     }
@@ -132,39 +333,245 @@ void Engine::processEvents(bool& running)
 
 void Engine::update(float dt)
 {
-    // fixed-step physics
-    m_accumulator += dt;
-    const float timeStep = s_fixedTimeStep;
-    const int   subSteps = 4;
+    const FramePacing pacing = m_game.pacing();
+
+    // fixed steps: the tick advances unless the game is paused, Box2D only
+    // when something is awake. The first frame after a pause starts the
+    // clock afresh rather than catching up on the idle time.
+    if (pacing.simulate && !m_simulating) dt = std::min(dt, s_fixedTimeStep);
+    m_simulating = pacing.simulate;
+    const int steps = pacing.simulate ? m_physics.advance(dt) : 0;
+    m_tick += static_cast<uint64_t>(steps);
+
+    if (m_physics.droppedSteps() != m_reportedDrops) {
+        LOG_WARN("[Engine] Frame stalled: dropped %llu fixed steps",
+                 static_cast<unsigned long long>(m_physics.droppedSteps() - m_reportedDrops));
+        m_reportedDrops = m_physics.droppedSteps();
+    }
 
-    while (m_accumulator >= timeStep) {
-        if (!B2_IS_NULL(m_world)) {
-            b2World_Step(m_world, timeStep, subSteps);
-        }
-        m_accumulator -= timeStep;
+    if (!m_physics.async()) {
+        m_physics.step(steps);
+        publishPhysics();
     }
 
     // game logic
-    m_game.update(dt);
+    {
+        TRACE_ZONE("IGame::update", "game");
+        m_game.update(dt);
+    }
+
+    // runs while the frame renders; synced at the start of the next one
+    if (m_physics.async()) m_physics.launch(steps);
+}
+
+void Engine::syncPhysics()
+{
+    if (!m_physics.async()) return;
+    m_physics.sync();
+    publishPhysics();
+}
+
+void Engine::publishPhysics()
+{
+    const physics::StepReport& report = m_physics.report();
+    m_stats.physicsMs       = report.ms;
+    m_stats.physicsSteps    = report.steps;
+    m_stats.subSteps        = report.subSteps;
 }
 
 void Engine::render()
 {
     SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
     SDL_RenderClear(m_renderer);
+    draw::resetCounters();
 
-    m_game.render(m_renderer);
+    {
+        TRACE_ZONE("IGame::render", "game");
+        m_game.render(m_renderer);
+    }
+}
 
+void Engine::present()
+{
+    TRACE_ZONE("SDL_RenderPresent", "render");
     SDL_RenderPresent(m_renderer);
+}
+
+Engine::OffscreenFrame Engine::renderOffscreenFrame()
+{
+    OffscreenFrame frame;
+    if (!m_offscreen) return frame;
+
+    const memory::AllocationCounters frameStart = memory::allocationCounters();
+
+    // scripted frames: one simulation tick each, so clips advance
+    ++m_tick;
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    render();
+    present();
+    frame.submitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    frame.drawCalls = draw::counters().drawCalls;
+    frame.pixels    = draw::counters().pixels;
+    frame.checksum  = framebufferChecksum();
+
+    // the surface holds the finished frame: no read-back needed
+    m_capture.captureSurface(m_offscreen);
+    exportFrame(m_offscreen);
+
+    endFrame(frameStart);
+    return frame;
+}
+
+uint64_t Engine::framebufferChecksum()
+{
+    const bool lock = SDL_MUSTLOCK(m_offscreen);
+    if (lock && !SDL_LockSurface(m_offscreen)) return 0;
+
+    // FNV-1a over the visible bytes of every row, ignoring pitch padding
+    uint64_t hash = 14695981039346656037ull;
+    const size_t rowBytes = static_cast<size_t>(m_offscreen->w) * 4;
+    for (int y = 0; y < m_offscreen->h; ++y) {
+        const auto* row = static_cast<const uint8_t*>(m_offscreen->pixels)
+                        + static_cast<size_t>(y) * m_offscreen->pitch;
+        for (size_t i = 0; i < rowBytes; ++i) {
+            hash = (hash ^ row[i]) * 1099511628211ull;
+        }
+    }
+
+    if (lock) SDL_UnlockSurface(m_offscreen);
+    return hash;
+}
+
+void Engine::toggleTrace()
+{
+    if (trace::isActive()) {
+        trace::stop();
+        return;
+    }
+
+    // a new file per capture so earlier ones are not overwritten
+    char path[64];
+    std::snprintf(path, sizeof(path), "xenon_trace_%u.json", ++m_traceCaptures);
+    trace::start(path);
+}
+
+// The renderer's output before it is presented; SDL leaves the back
+// buffer undefined after SDL_RenderPresent
+void Engine::captureFrame()
+{
+    if (m_offscreen) return;
+    if (!m_export.active()) {
+        if (m_capture.active()) m_capture.captureRenderer(m_renderer);
+        return;
+    }
+
+    // one read-back for both
+    SDL_Surface* frame = SDL_RenderReadPixels(m_renderer, nullptr);
+    m_capture.captureSurface(frame);
+    exportFrame(frame);
+    SDL_DestroySurface(frame);
+}
 
-    // Set nearest scaling for sharp pixel art
-    SDL_SetHint("SDL_RENDER_SCALE_QUALITY", "0");
+void Engine::exportFrame(SDL_Surface* frame)
+{
+    if (!m_export.active()) return;
+    shm::GameState state;
+    state.tick = m_tick;
+    m_game.exportState(state);
+    m_export.publish(frame, m_stats.frameIndex, state);
+}
+
+void Engine::stepOffscreen()
+{
+    if (!m_offscreen) return;
+    ++m_tick;
+    m_game.update(s_fixedTimeStep);
+    m_frameArena.reset();
+}
+
+bool Engine::startCapture(const std::string& path)
+{
+    int width = m_width, height = m_height;
+    if (m_offscreen) {
+        width  = m_offscreen->w;
+        height = m_offscreen->h;
+    } else if (!m_renderer || !SDL_GetCurrentRenderOutputSize(m_renderer, &width, &height)) {
+        return false;
+    }
+
+    capture::CaptureConfig config;
+    config.path   = path;
+    config.format = capture::formatFor(path);
+    config.fps    = static_cast<int>(1.0f / s_fixedTimeStep + 0.5f);
+    return m_capture.start(config, width, height);
+}
+
+void Engine::stopCapture()
+{
+    m_capture.stop();
+}
+
+bool Engine::startExport(const std::string& name, int slots)
+{
+    int width = m_width, height = m_height;
+    if (m_offscreen) {
+        width  = m_offscreen->w;
+        height = m_offscreen->h;
+    } else if (!m_renderer || !SDL_GetCurrentRenderOutputSize(m_renderer, &width, &height)) {
+        return false;
+    }
+    return m_export.start(name, width, height, slots);
+}
+
+void Engine::stopExport()
+{
+    m_export.stop();
+}
+
+void Engine::toggleCapture()
+{
+    if (m_capture.active()) {
+        stopCapture();
+        return;
+    }
+
+    char path[64];
+    std::snprintf(path, sizeof(path), "xenon_capture_%u.y4m", ++m_videoCaptures);
+    startCapture(path);
 }
 
 void Engine::shutdown()
 {
+    trace::stop();
+    m_capture.stop();
+    m_export.stop();
+
+    if (m_audio.isOpen()) {
+        const audio::MixerStats a = m_audio.stats();
+        LOG_INFO("[Audio] %llu callbacks, %.1f us average, %.1f us max, %llu voices stolen, %llu commands dropped",
+                 static_cast<unsigned long long>(a.callbacks), a.averageUs, a.maxUs,
+                 static_cast<unsigned long long>(a.voicesStolen),
+                 static_cast<unsigned long long>(a.commandsDropped));
+    }
+    m_audio.close();
+
+    // a dump started by the last frames still gets written
+    m_recorder.waitForWriter();
+    if (m_recorder.dumpsWritten() > 0 || m_recorder.dumpsSkipped() > 0) {
+        LOG_INFO("[Flight] %llu hitch dumps written, %llu skipped",
+                 static_cast<unsigned long long>(m_recorder.dumpsWritten()),
+                 static_cast<unsigned long long>(m_recorder.dumpsSkipped()));
+    }
+
     m_textureManager.clear();
 
+    // the worker may still be stepping the world
+    m_physics.setAsync(false);
+    m_physics.setWorld(b2_nullWorldId);
+
     if (B2_IS_NON_NULL(m_world)) {
         b2DestroyWorld(m_world);
         m_world = b2_nullWorldId;
@@ -175,6 +582,11 @@ void Engine::shutdown()
         m_renderer = nullptr;
     }
 
+    if (m_offscreen) {
+        SDL_DestroySurface(m_offscreen);
+        m_offscreen = nullptr;
+    }
+
     if (m_window) {
         SDL_DestroyWindow(m_window);
         m_window = nullptr;
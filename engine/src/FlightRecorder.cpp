@@ -0,0 +1,309 @@
+#include "Engine/FlightRecorder.hpp"
+#include "Engine/Log.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace flight {
+
+const char* sectionName(Section s)
+{
+    switch (s) {
+    case Section::Events:  return "events";
+    case Section::Update:  return "update";
+    case Section::Physics: return "physics";
+    case Section::Render:  return "render";
+    case Section::Present: return "present";
+    case Section::Capture: return "capture";
+    case Section::Count:   break;
+    }
+    return "?";
+}
+
+// ------------------------------------------------------------
+// Reading
+// ------------------------------------------------------------
+
+namespace {
+    // FrameRecord as "XFR1" dumps wrote it, before Section::Capture
+    struct FrameRecordV1 {
+        uint64_t   frameIndex;
+        uint64_t   tick;
+        uint64_t   startUs;
+        uint64_t   allocations;
+        uint64_t   allocatedBytes;
+        float      totalMs;
+        float      sectionMs[static_cast<size_t>(Section::Capture)];
+        uint32_t   drawCalls;
+        uint32_t   arenaBytes;
+        uint16_t   physicsSteps;
+        uint8_t    quality;
+        uint8_t    eventCount;
+        uint32_t   counters[MAX_COUNTERS];
+        InputEvent events[MAX_EVENTS];
+    };
+    static_assert(sizeof(FrameRecordV1) == 144);
+
+    FrameRecord upgrade(const FrameRecordV1& v1)
+    {
+        FrameRecord f;
+        f.frameIndex     = v1.frameIndex;
+        f.tick           = v1.tick;
+        f.startUs        = v1.startUs;
+        f.allocations    = v1.allocations;
+        f.allocatedBytes = v1.allocatedBytes;
+        f.totalMs        = v1.totalMs;
+        std::copy(std::begin(v1.sectionMs), std::end(v1.sectionMs), f.sectionMs);
+        f.drawCalls      = v1.drawCalls;
+        f.arenaBytes     = v1.arenaBytes;
+        f.physicsSteps   = v1.physicsSteps;
+        f.quality        = v1.quality;
+        f.eventCount     = v1.eventCount;
+        std::copy(std::begin(v1.counters), std::end(v1.counters), f.counters);
+        std::copy(std::begin(v1.events), std::end(v1.events), f.events);
+        return f;
+    }
+}
+
+bool readDump(const std::string& path, Dump& out)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    static const char v1Magic[4] = {'X', 'F', 'R', '1'};
+    bool ok = std::fread(&out.header, sizeof(out.header), 1, file) == 1;
+    const bool v1 = ok && std::memcmp(out.header.magic, v1Magic, sizeof(v1Magic)) == 0;
+    ok = ok && (v1 || std::memcmp(out.header.magic, DumpHeader{}.magic, sizeof(out.header.magic)) == 0) &&
+         out.header.counterCount <= MAX_COUNTERS;
+
+    out.counterNames.clear();
+    for (uint32_t i = 0; ok && i < out.header.counterCount; ++i) {
+        char name[NAME_LENGTH + 1]{};
+        ok = std::fread(name, NAME_LENGTH, 1, file) == 1;
+        out.counterNames.emplace_back(name);
+    }
+
+    if (ok && v1) {
+        std::vector<FrameRecordV1> old(out.header.frameCount);
+        ok = old.empty() || std::fread(old.data(), sizeof(FrameRecordV1), old.size(), file) == old.size();
+        out.frames.clear();
+        for (const FrameRecordV1& f : old) out.frames.push_back(upgrade(f));
+    } else if (ok) {
+        out.frames.resize(out.header.frameCount);
+        ok = out.frames.empty() ||
+             std::fread(out.frames.data(), sizeof(FrameRecord), out.frames.size(), file) == out.frames.size();
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+// ------------------------------------------------------------
+// Recording
+// ------------------------------------------------------------
+
+Recorder::Recorder(const RecorderConfig& config)
+    : m_config(config)
+    , m_epoch(std::chrono::steady_clock::now())
+    , m_ring(new FrameRecord[std::max<size_t>(config.capacity, 1)]())
+    , m_dumpFrames(new FrameRecord[std::max<size_t>(config.capacity, 1)]())
+{
+    m_config.capacity = std::max<size_t>(m_config.capacity, 1);
+    m_frame = &m_ring[0];
+}
+
+Recorder::~Recorder()
+{
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_writer.join();
+    }
+}
+
+void Recorder::configure(float thresholdMs, const std::string& directory)
+{
+    waitForWriter();
+    m_config.thresholdMs = thresholdMs;
+    m_config.directory   = directory;
+}
+
+CounterId Recorder::defineCounter(const char* name)
+{
+    for (size_t i = 0; i < m_counterCount; ++i) {
+        if (std::strncmp(m_counterNames[i], name, NAME_LENGTH - 1) == 0) return static_cast<CounterId>(i);
+    }
+    if (m_counterCount == MAX_COUNTERS) {
+        LOG_WARN("[Flight] No room for counter '%s'", name);
+        return MAX_COUNTERS - 1;
+    }
+    std::snprintf(m_counterNames[m_counterCount], NAME_LENGTH, "%s", name);
+    return static_cast<CounterId>(m_counterCount++);
+}
+
+void Recorder::setCounter(CounterId id, uint32_t value)
+{
+    if (id < MAX_COUNTERS) m_counterValues[id] = value;
+}
+
+void Recorder::beginFrame(uint64_t frameIndex, uint64_t tick)
+{
+    m_frame = &m_ring[m_next];
+    *m_frame = FrameRecord{};
+    m_frame->frameIndex = frameIndex;
+    m_frame->tick       = tick;
+    m_frame->startUs    = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - m_epoch).count());
+}
+
+void Recorder::section(Section s, double ms)
+{
+    m_frame->sectionMs[static_cast<size_t>(s)] += static_cast<float>(ms);
+}
+
+void Recorder::event(const SDL_Event& e)
+{
+    int32_t code = 0;
+    switch (e.type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        code = static_cast<int32_t>(e.key.key);
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        code = e.button.button;
+        break;
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+        code = e.gbutton.button;
+        break;
+    default:
+        return;
+    }
+
+    if (m_frame->eventCount < MAX_EVENTS) m_frame->events[m_frame->eventCount] = InputEvent{e.type, code};
+    if (m_frame->eventCount < UINT8_MAX) ++m_frame->eventCount;
+}
+
+void Recorder::endFrame(double totalMs, uint64_t allocations, uint64_t allocatedBytes, uint64_t drawCalls,
+                        size_t arenaBytes, int physicsSteps, int quality)
+{
+    FrameRecord& f = *m_frame;
+    f.totalMs        = static_cast<float>(totalMs);
+    f.allocations    = allocations;
+    f.allocatedBytes = allocatedBytes;
+    f.drawCalls      = static_cast<uint32_t>(std::min<uint64_t>(drawCalls, UINT32_MAX));
+    f.arenaBytes     = static_cast<uint32_t>(std::min<size_t>(arenaBytes, UINT32_MAX));
+    f.physicsSteps   = static_cast<uint16_t>(std::clamp(physicsSteps, 0, 0xFFFF));
+    f.quality        = static_cast<uint8_t>(std::clamp(quality, 0, 0xFF));
+    std::copy(std::begin(m_counterValues), std::end(m_counterValues), f.counters);
+
+    m_next  = (m_next + 1) % m_config.capacity;
+    m_count = std::min(m_count + 1, m_config.capacity);
+
+    if (m_config.thresholdMs > 0.0f && totalMs > m_config.thresholdMs && f.frameIndex >= m_config.warmupFrames) {
+        requestDump(f.frameIndex);
+    }
+}
+
+void Recorder::requestDump(uint64_t hitchFrame)
+{
+    if (m_dumped && hitchFrame < m_lastDumpFrame + m_config.cooldownFrames) {
+        ++m_skipped;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_writing) {
+        ++m_skipped;
+        return;
+    }
+
+    // oldest first, ending with the frame just recorded
+    const size_t first = (m_next + m_config.capacity - m_count) % m_config.capacity;
+    for (size_t i = 0; i < m_count; ++i) m_dumpFrames[i] = m_ring[(first + i) % m_config.capacity];
+
+    m_dumpHeader              = DumpHeader{};
+    m_dumpHeader.frameCount   = static_cast<uint32_t>(m_count);
+    m_dumpHeader.counterCount = static_cast<uint32_t>(m_counterCount);
+    m_dumpHeader.thresholdMs  = m_config.thresholdMs;
+    m_dumpHeader.hitchFrame   = hitchFrame;
+
+    char name[48];
+    std::snprintf(name, sizeof(name), "hitch-%llu.xfr", static_cast<unsigned long long>(hitchFrame));
+    m_dumpPath = (std::filesystem::path(m_config.directory) / name).string();
+
+    m_writing       = true;
+    m_dumped        = true;
+    m_lastDumpFrame = hitchFrame;
+
+    if (!m_writer.joinable()) m_writer = std::thread([this] { writerLoop(); });
+    lock.unlock();
+    m_wake.notify_one();
+}
+
+void Recorder::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stop || m_writing; });
+        if (m_writing) {
+            // the frame thread does not touch the dump buffer while m_writing is set
+            lock.unlock();
+            writeDump();
+            lock.lock();
+            m_writing = false;
+            ++m_written;
+            m_idle.notify_all();
+        }
+        if (m_stop) return;
+    }
+}
+
+void Recorder::writeDump()
+{
+    std::error_code ec;
+    const std::filesystem::path directory = std::filesystem::path(m_dumpPath).parent_path();
+    if (!directory.empty()) std::filesystem::create_directories(directory, ec);
+
+    std::FILE* file = std::fopen(m_dumpPath.c_str(), "wb");
+    if (!file) {
+        LOG_WARN("[Flight] Cannot write %s", m_dumpPath.c_str());
+        return;
+    }
+
+    bool ok = std::fwrite(&m_dumpHeader, sizeof(m_dumpHeader), 1, file) == 1;
+    for (uint32_t i = 0; ok && i < m_dumpHeader.counterCount; ++i) {
+        ok = std::fwrite(m_counterNames[i], NAME_LENGTH, 1, file) == 1;
+    }
+    ok = ok && std::fwrite(m_dumpFrames.get(), sizeof(FrameRecord), m_dumpHeader.frameCount, file) == m_dumpHeader.frameCount;
+    ok = std::fclose(file) == 0 && ok;
+
+    const FrameRecord& hitch = m_dumpFrames[m_dumpHeader.frameCount - 1];
+    if (ok) {
+        LOG_WARN("[Flight] Frame %llu took %.1f ms (threshold %.1f ms): last %u frames in %s",
+                 static_cast<unsigned long long>(hitch.frameIndex), hitch.totalMs, m_dumpHeader.thresholdMs,
+                 m_dumpHeader.frameCount, m_dumpPath.c_str());
+    } else {
+        LOG_WARN("[Flight] Writing %s failed", m_dumpPath.c_str());
+    }
+}
+
+uint64_t Recorder::dumpsWritten() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_written;
+}
+
+void Recorder::waitForWriter()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return !m_writing; });
+}
+
+} // namespace flight
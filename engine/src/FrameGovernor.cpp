@@ -0,0 +1,46 @@
+#include "Engine/FrameGovernor.hpp"
+
+#include <algorithm>
+
+FrameGovernor::FrameGovernor(double budgetMs)
+    : m_budgetMs(budgetMs)
+    , m_averageMs(budgetMs * 0.5)
+{
+}
+
+const char* FrameGovernor::levelName(int level)
+{
+    static const char* const s_names[LEVEL_COUNT] = {"full", "reduced", "low", "minimal"};
+    return s_names[std::clamp(level, 0, LEVEL_COUNT - 1)];
+}
+
+bool FrameGovernor::addFrame(double workMs)
+{
+    // one long hitch (a load, a debugger break) should not cost quality
+    workMs = std::min(workMs, m_budgetMs * 3.0);
+    m_averageMs += (workMs - m_averageMs) * s_smoothing;
+    if (m_sinceRestore != UINT32_MAX) ++m_sinceRestore;
+
+    m_overFrames  = m_averageMs > m_budgetMs * s_degradeAt ? m_overFrames + 1 : 0;
+    m_underFrames = m_averageMs < m_budgetMs * s_restoreAt ? m_underFrames + 1 : 0;
+
+    if (m_overFrames >= s_degradeFrames && m_level < LEVEL_COUNT - 1) {
+        // the last restore did not hold: be slower to try again
+        m_restoreAfter = m_sinceRestore < m_restoreAfter * 2
+                       ? std::min(m_restoreAfter * 2, s_maxRestore)
+                       : s_restoreFrames;
+        ++m_level;
+        m_overFrames  = 0;
+        m_underFrames = 0;
+        return true;
+    }
+
+    if (m_underFrames >= m_restoreAfter && m_level > 0) {
+        --m_level;
+        m_overFrames   = 0;
+        m_underFrames  = 0;
+        m_sinceRestore = 0;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,327 @@
+#include "Engine/Log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace logging {
+
+namespace {
+
+    struct Message {
+        uint64_t time;     // ns since g_epoch
+        Level    level;
+        uint16_t length;
+        char     text[244];
+    };
+
+    // Single producer (the owning thread), single consumer (whoever
+    // holds g_drainMutex: the writer thread or a flush() caller).
+    // Once the owner has exited and the consumer has drained it, the
+    // ring goes to g_spare for the next thread that logs.
+    struct ThreadBuffer {
+        static constexpr uint64_t CAPACITY = 1u << 10;
+
+        Message               slots[CAPACITY];
+        std::atomic<uint64_t> head{0};   // written by the owner
+        std::atomic<uint64_t> tail{0};   // written by the consumer
+        std::atomic<bool>     retired{false};   // the owner has exited
+    };
+
+    const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+    std::mutex                                 g_registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;   // owned by a thread, or retired and not yet drained
+    std::vector<std::unique_ptr<ThreadBuffer>> g_spare;     // drained, waiting for a new thread
+
+    // Trivially destructible, so still readable while the thread exits
+    thread_local ThreadBuffer* t_buffer = nullptr;
+    thread_local bool          t_exited = false;
+
+    // Hands the thread's ring back when the thread exits
+    struct BufferOwner {
+        ~BufferOwner()
+        {
+            t_exited = true;
+            if (t_buffer) t_buffer->retired.store(true, std::memory_order_release);
+            t_buffer = nullptr;
+        }
+    };
+    thread_local BufferOwner t_owner;
+
+    std::atomic<uint64_t> g_dropped{0};
+
+    // consumer state, guarded by g_drainMutex
+    struct Pending {
+        uint64_t       time;
+        uint32_t       order;   // keeps one thread's messages in sequence on equal times
+        const Message* message;
+    };
+    std::mutex           g_drainMutex;
+    std::FILE*           g_file = nullptr;   // nullptr: stderr
+    std::vector<Pending> g_pending;
+    struct Drained {
+        ThreadBuffer* buffer;
+        uint64_t      head;
+        bool          retired;
+    };
+    std::vector<Drained> g_heads;
+    uint64_t             g_reportedDrops = 0;
+
+    // writer thread
+    std::mutex              g_controlMutex;   // start/stop
+    std::atomic<bool>       g_running{false};
+    std::atomic<bool>       g_closed{false};  // past static destruction: write directly
+    std::thread             g_writer;
+    std::mutex              g_wakeMutex;
+    std::condition_variable g_wake;
+    bool                    g_stopWriter = false;
+
+    const char* levelName(Level level)
+    {
+        switch (level) {
+        case Level::Debug: return "DEBUG";
+        case Level::Info:  return "INFO";
+        case Level::Warn:  return "WARN";
+        case Level::Error: return "ERROR";
+        }
+        return "?";
+    }
+
+    uint64_t now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - g_epoch).count());
+    }
+
+    // nullptr once the thread's thread_locals are being destroyed
+    ThreadBuffer* threadBuffer()
+    {
+        if (t_buffer || t_exited) return t_buffer;
+
+        (void)t_owner;   // registers the exit hook
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        std::unique_ptr<ThreadBuffer> buffer;
+        if (!g_spare.empty()) {
+            buffer = std::move(g_spare.back());
+            g_spare.pop_back();
+            buffer->retired.store(false, std::memory_order_relaxed);
+        } else {
+            buffer = std::make_unique<ThreadBuffer>();
+        }
+        t_buffer = buffer.get();
+        g_buffers.push_back(std::move(buffer));
+        return t_buffer;
+    }
+
+    // Caller holds g_drainMutex. Messages of all threads are merged by
+    // time, then the slots are handed back to their producers.
+    void drain()
+    {
+        g_heads.clear();
+        {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            for (const auto& b : g_buffers) {
+                // read before head: a retired owner has written its last message
+                const bool retired = b->retired.load(std::memory_order_acquire);
+                g_heads.push_back({b.get(), b->head.load(std::memory_order_acquire), retired});
+            }
+        }
+
+        g_pending.clear();
+        for (const auto& [b, head, retired] : g_heads) {
+            for (uint64_t i = b->tail.load(std::memory_order_relaxed); i != head; ++i) {
+                const Message& m = b->slots[i % ThreadBuffer::CAPACITY];
+                g_pending.push_back({m.time, static_cast<uint32_t>(g_pending.size()), &m});
+            }
+        }
+        std::sort(g_pending.begin(), g_pending.end(), [](const Pending& a, const Pending& b) {
+            return a.time != b.time ? a.time < b.time : a.order < b.order;
+        });
+
+        std::FILE* out = g_file ? g_file : stderr;
+        for (const Pending& p : g_pending) {
+            std::fprintf(out, "%9.3f %-5s %.*s\n", static_cast<double>(p.time) / 1e9,
+                         levelName(p.message->level), p.message->length, p.message->text);
+        }
+
+        const uint64_t dropped = g_dropped.load(std::memory_order_relaxed);
+        if (dropped != g_reportedDrops) {
+            std::fprintf(out, "%9.3f %-5s [Log] %llu messages dropped\n", static_cast<double>(now()) / 1e9,
+                         levelName(Level::Warn), static_cast<unsigned long long>(dropped - g_reportedDrops));
+            g_reportedDrops = dropped;
+        }
+        if (!g_pending.empty()) std::fflush(out);
+
+        for (const auto& [b, head, retired] : g_heads) {
+            b->tail.store(head, std::memory_order_release);
+        }
+
+        // rings of exited threads are empty now: hand them to new threads
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (const auto& [b, head, retired] : g_heads) {
+            if (!retired) continue;
+            auto it = std::find_if(g_buffers.begin(), g_buffers.end(),
+                                   [b = b](const auto& owned) { return owned.get() == b; });
+            g_spare.push_back(std::move(*it));
+            g_buffers.erase(it);
+        }
+    }
+
+    void writerLoop()
+    {
+        std::unique_lock<std::mutex> lock(g_wakeMutex);
+        while (!g_stopWriter) {
+            g_wake.wait_for(lock, std::chrono::milliseconds(10));
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> drainLock(g_drainMutex);
+                drain();
+            }
+            lock.lock();
+        }
+    }
+
+    void startWriter()
+    {
+        std::lock_guard<std::mutex> lock(g_controlMutex);
+        if (g_running.load(std::memory_order_relaxed)) return;
+        {
+            std::lock_guard<std::mutex> wake(g_wakeMutex);
+            g_stopWriter = false;
+        }
+        g_writer = std::thread(writerLoop);
+        g_running.store(true, std::memory_order_release);
+    }
+
+    // Declared last so it is destroyed first, while the rings still exist
+    struct ExitFlush {
+        ~ExitFlush()
+        {
+            shutdown();
+            g_closed.store(true, std::memory_order_release);
+        }
+    } g_exitFlush;
+}
+
+namespace detail {
+
+void write(Level level, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+
+    if (g_closed.load(std::memory_order_acquire)) {
+        std::fprintf(stderr, "%-5s ", levelName(level));
+        std::vfprintf(stderr, fmt, args);
+        std::fputc('\n', stderr);
+        va_end(args);
+        return;
+    }
+    if (!g_running.load(std::memory_order_acquire)) startWriter();
+
+    ThreadBuffer* b = threadBuffer();
+    if (!b) {
+        // the thread is exiting and has handed its ring back
+        char text[sizeof(Message::text)];
+        std::vsnprintf(text, sizeof(text), fmt, args);
+        va_end(args);
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+        std::fprintf(g_file ? g_file : stderr, "%9.3f %-5s %s\n", static_cast<double>(now()) / 1e9,
+                     levelName(level), text);
+        return;
+    }
+
+    const uint64_t head = b->head.load(std::memory_order_relaxed);
+    const uint64_t tail = b->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= ThreadBuffer::CAPACITY) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        va_end(args);
+        return;
+    }
+
+    Message& m = b->slots[head % ThreadBuffer::CAPACITY];
+    m.time  = now();
+    m.level = level;
+
+    const int length = std::vsnprintf(m.text, sizeof(m.text), fmt, args);
+    va_end(args);
+    if (length < 0) {
+        m.length = 0;
+    } else if (static_cast<size_t>(length) >= sizeof(m.text)) {
+        // mark the cut
+        m.length = sizeof(m.text) - 1;
+        std::copy_n("...", 3, m.text + m.length - 3);
+    } else {
+        m.length = static_cast<uint16_t>(length);
+    }
+
+    b->head.store(head + 1, std::memory_order_release);
+
+    // errors often come right before a crash or exit: don't sit on them
+    if (level == Level::Error) g_wake.notify_one();
+}
+
+} // namespace detail
+
+bool setOutput(const std::string& path)
+{
+    std::FILE* file = nullptr;
+    if (!path.empty()) {
+        file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            LOG_ERROR("[Log] Cannot open %s", path.c_str());
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_drainMutex);
+    drain();
+    if (g_file) std::fclose(g_file);
+    g_file = file;
+    return true;
+}
+
+void flush()
+{
+    std::lock_guard<std::mutex> lock(g_drainMutex);
+    drain();
+}
+
+void shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_controlMutex);
+        if (g_running.load(std::memory_order_relaxed)) {
+            {
+                std::lock_guard<std::mutex> wake(g_wakeMutex);
+                g_stopWriter = true;
+            }
+            g_wake.notify_one();
+            g_writer.join();
+            g_running.store(false, std::memory_order_release);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_drainMutex);
+    drain();
+    if (g_file) {
+        std::fclose(g_file);
+        g_file = nullptr;
+    }
+}
+
+uint64_t droppedMessages()
+{
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace logging
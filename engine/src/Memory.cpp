@@ -0,0 +1,249 @@
+#include "Engine/Memory.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// ------------------------------------------------------------
+// Counters
+// ------------------------------------------------------------
+namespace {
+    std::atomic<uint64_t> g_allocations{0};
+    std::atomic<uint64_t> g_bytes{0};
+    std::atomic<uint64_t> g_frees{0};
+    std::atomic<uint64_t> g_resizes{0};
+
+    inline void countAllocation(size_t size)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    inline void countFree()
+    {
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* allocate(size_t size)
+    {
+        if (size == 0) size = 1;
+        countAllocation(size);
+        return std::malloc(size);
+    }
+
+    void* allocateAligned(size_t size, size_t alignment)
+    {
+        if (size == 0) size = 1;
+        countAllocation(size);
+#if defined(_WIN32)
+        return _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc wants a size that is a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+    }
+
+    void release(void* p)
+    {
+        if (!p) return;
+        countFree();
+        std::free(p);
+    }
+
+    void releaseAligned(void* p)
+    {
+        if (!p) return;
+        countFree();
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    // SDL allocator hooks
+    SDL_malloc_func  g_sdlMalloc  = nullptr;
+    SDL_calloc_func  g_sdlCalloc  = nullptr;
+    SDL_realloc_func g_sdlRealloc = nullptr;
+    SDL_free_func    g_sdlFree    = nullptr;
+
+    void* SDLCALL countingMalloc(size_t size)
+    {
+        countAllocation(size);
+        return g_sdlMalloc(size);
+    }
+
+    void* SDLCALL countingCalloc(size_t count, size_t size)
+    {
+        // an overflowing product fails in calloc; it allocates nothing
+        if (size != 0 && count > SIZE_MAX / size) return g_sdlCalloc(count, size);
+        countAllocation(count * size);
+        return g_sdlCalloc(count, size);
+    }
+
+    // realloc(nullptr, n) is an allocation; anything else resizes a
+    // block already counted, shrinks and realloc(p, 0) included
+    void* SDLCALL countingRealloc(void* mem, size_t size)
+    {
+        if (mem) {
+            g_resizes.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            countAllocation(size);
+        }
+        return g_sdlRealloc(mem, size);
+    }
+
+    void SDLCALL countingFree(void* mem)
+    {
+        if (mem) countFree();
+        g_sdlFree(mem);
+    }
+}
+
+// ------------------------------------------------------------
+// Global operator new/delete replacements
+// ------------------------------------------------------------
+void* operator new(size_t size)
+{
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept   { return allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    if (void* p = allocateAligned(size, static_cast<size_t>(align))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    if (void* p = allocateAligned(size, static_cast<size_t>(align))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, static_cast<size_t>(align));
+}
+
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, static_cast<size_t>(align));
+}
+
+void operator delete(void* p) noexcept                         { release(p); }
+void operator delete[](void* p) noexcept                       { release(p); }
+void operator delete(void* p, size_t) noexcept                 { release(p); }
+void operator delete[](void* p, size_t) noexcept               { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept   { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept           { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept         { releaseAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept   { releaseAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept   { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+namespace memory {
+
+AllocationCounters allocationCounters()
+{
+    AllocationCounters c;
+    c.allocations = g_allocations.load(std::memory_order_relaxed);
+    c.bytes       = g_bytes.load(std::memory_order_relaxed);
+    c.frees       = g_frees.load(std::memory_order_relaxed);
+    c.resizes     = g_resizes.load(std::memory_order_relaxed);
+    return c;
+}
+
+void installSDLAllocationHooks()
+{
+    if (g_sdlMalloc) return;
+    SDL_GetOriginalMemoryFunctions(&g_sdlMalloc, &g_sdlCalloc, &g_sdlRealloc, &g_sdlFree);
+    SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc, countingFree);
+}
+
+// ------------------------------------------------------------
+// FrameArena
+// ------------------------------------------------------------
+FrameArena::FrameArena(size_t capacity)
+    : m_buffer(new std::byte[capacity])
+    , m_capacity(capacity)
+{
+    m_overflow.reserve(16);
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+}
+
+void FrameArena::reset()
+{
+    for (const Overflow& o : m_overflow) {
+        ::operator delete(o.ptr, std::align_val_t{o.alignment});
+    }
+    m_overflow.clear();
+    m_offset = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    const size_t start = (m_offset + alignment - 1) & ~(alignment - 1);
+    if (start + bytes <= m_capacity) {
+        m_offset = start + bytes;
+        if (m_offset > m_highWater) m_highWater = m_offset;
+        return m_buffer.get() + start;
+    }
+
+    void* p = ::operator new(bytes, std::align_val_t{alignment});
+    m_overflow.push_back({p, alignment});
+    return p;
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t)
+{
+    // monotonic: memory comes back in reset()
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+std::string_view FrameArena::format(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    va_list copy;
+    va_copy(copy, args);
+    const int length = std::vsnprintf(nullptr, 0, fmt, copy);
+    va_end(copy);
+
+    if (length < 0) {
+        va_end(args);
+        return {};
+    }
+
+    char* text = static_cast<char*>(allocate(static_cast<size_t>(length) + 1, 1));
+    std::vsnprintf(text, static_cast<size_t>(length) + 1, fmt, args);
+    va_end(args);
+    return std::string_view(text, static_cast<size_t>(length));
+}
+
+} // namespace memory
@@ -0,0 +1,132 @@
+#include "Engine/Parallax.hpp"
+
+#include "Engine/Draw.hpp"
+#include "Engine/Log.hpp"
+#include "Engine/TextureManager.hpp"
+#include "Engine/Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace parallax {
+
+void Background::init(TextureManager& textures, SDL_Renderer* renderer, int width, int height)
+{
+    m_textures = &textures;
+    m_renderer = renderer;
+    m_width    = width;
+    m_height   = height;
+    m_layers.clear();
+}
+
+bool Background::addLayer(const LayerDesc& desc)
+{
+    if (!m_textures || !m_renderer || !desc.sprite || m_width <= 0 || m_height <= 0) return false;
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "parallax-%p-%zu", static_cast<const void*>(this), m_layers.size());
+    SDL_Texture* tile = m_textures->createTarget(name, m_width, m_height);
+    if (!tile) return false;
+
+    bake(tile, desc);
+    SDL_SetTextureAlphaMod(tile, desc.alpha);
+
+    m_layers.push_back(Layer{tile, desc.speed, 0.0f});
+    return true;
+}
+
+void Background::bake(SDL_Texture* tile, const LayerDesc& desc)
+{
+    TRACE_ZONE("parallax::bake", "assets");
+
+    SDL_Texture* previous = SDL_GetRenderTarget(m_renderer);
+    SDL_SetRenderTarget(m_renderer, tile);
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+    SDL_RenderClear(m_renderer);
+
+    const float w = static_cast<float>(m_width);
+    const float h = static_cast<float>(m_height);
+    std::mt19937 rng(desc.seed);
+    std::uniform_real_distribution<float> x(0.0f, w);
+    std::uniform_real_distribution<float> y(0.0f, h);
+
+    for (int i = 0; i < desc.count; ++i) {
+        const SDL_FRect at{x(rng), y(rng), desc.size, desc.size};
+        // copies one tile over wherever the sprite crosses the right or bottom edge
+        const bool wrapX = at.x + at.w > w;
+        const bool wrapY = at.y + at.h > h;
+        draw::texture(m_renderer, desc.sprite, nullptr, &at);
+        if (wrapX) {
+            const SDL_FRect left{at.x - w, at.y, at.w, at.h};
+            draw::texture(m_renderer, desc.sprite, nullptr, &left);
+        }
+        if (wrapY) {
+            const SDL_FRect top{at.x, at.y - h, at.w, at.h};
+            draw::texture(m_renderer, desc.sprite, nullptr, &top);
+        }
+        if (wrapX && wrapY) {
+            const SDL_FRect corner{at.x - w, at.y - h, at.w, at.h};
+            draw::texture(m_renderer, desc.sprite, nullptr, &corner);
+        }
+    }
+
+    SDL_SetRenderTarget(m_renderer, previous);
+}
+
+void Background::scroll(float dt)
+{
+    const float h = static_cast<float>(m_height);
+    for (Layer& layer : m_layers) {
+        layer.offset = std::fmod(layer.offset + layer.speed * dt, h);
+        if (layer.offset < 0.0f) layer.offset += h;
+    }
+}
+
+void Background::resetScroll()
+{
+    for (Layer& layer : m_layers) layer.offset = 0.0f;
+}
+
+void Background::render(SDL_Renderer* renderer, size_t layers) const
+{
+    const float w = static_cast<float>(m_width);
+    const float h = static_cast<float>(m_height);
+    const size_t first = m_layers.size() - std::min(layers, m_layers.size());
+
+    for (size_t i = first; i < m_layers.size(); ++i) {
+        const Layer& layer = m_layers[i];
+        const float o = layer.offset;
+        // the tile's bottom rows wrap around to the top of the screen
+        if (o > 0.0f) {
+            const SDL_FRect src{0.0f, h - o, w, o};
+            const SDL_FRect dst{0.0f, 0.0f, w, o};
+            draw::texture(renderer, layer.tile, &src, &dst);
+        }
+        const SDL_FRect src{0.0f, 0.0f, w, h - o};
+        const SDL_FRect dst{0.0f, o, w, h - o};
+        draw::texture(renderer, layer.tile, &src, &dst);
+    }
+}
+
+void Background::save(snapshot::Writer& out) const
+{
+    out.put(static_cast<uint32_t>(m_layers.size()));
+    for (const Layer& layer : m_layers) out.put(layer.offset);
+}
+
+bool Background::load(snapshot::Reader& in)
+{
+    uint32_t count = 0;
+    in.get(count);
+    for (uint32_t i = 0; i < count && in.ok(); ++i) {
+        float offset = 0.0f;
+        in.get(offset);
+        if (i < m_layers.size()) m_layers[i].offset = offset;
+    }
+    if (count != m_layers.size()) LOG_WARN("[Parallax] Snapshot has %u layers, background has %zu", count, m_layers.size());
+    return in.ok();
+}
+
+} // namespace parallax
@@ -0,0 +1,104 @@
+#include "Engine/Path.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace path {
+
+PathId PathLibrary::add(const Path& p)
+{
+    m_paths.push_back(p);
+    return static_cast<PathId>(m_paths.size() - 1);
+}
+
+PathId PathLibrary::line(float dx, float dy, uint32_t ticks, bool loop)
+{
+    return sineSweep(dx, dy, 0.0f, 0.0f, ticks, loop);
+}
+
+PathId PathLibrary::sineSweep(float dx, float dy, float amplitude, float cycles, uint32_t ticks, bool loop)
+{
+    Path p;
+    p.firstSample = static_cast<uint32_t>(m_x.size());
+    p.ticks       = std::max<uint32_t>(ticks, 1);
+    p.loop        = loop;
+
+    // swing along the left-hand normal of the travel direction
+    const float length = std::hypot(dx, dy);
+    const float nx = length > 0.0f ? -dy / length : 0.0f;
+    const float ny = length > 0.0f ?  dx / length : 1.0f;
+
+    for (uint32_t k = 0; k <= p.ticks; ++k) {
+        const float s     = static_cast<float>(k) / static_cast<float>(p.ticks);
+        const float swing = amplitude * std::sin(2.0f * 3.14159265f * cycles * s);
+        m_x.push_back(dx * s + nx * swing);
+        m_y.push_back(dy * s + ny * swing);
+    }
+    return add(p);
+}
+
+PathId PathLibrary::spline(const SDL_FPoint* points, size_t count, uint32_t ticks, bool loop)
+{
+    Path p;
+    p.firstSample = static_cast<uint32_t>(m_x.size());
+    p.ticks       = std::max<uint32_t>(ticks, 1);
+    p.loop        = loop;
+
+    if (count < 2) {
+        const SDL_FPoint only = count == 1 ? points[0] : SDL_FPoint{0.0f, 0.0f};
+        m_x.insert(m_x.end(), p.ticks + 1, only.x);
+        m_y.insert(m_y.end(), p.ticks + 1, only.y);
+        return add(p);
+    }
+
+    // the neighbours of the end points are the end points themselves,
+    // or wrap around for loops
+    const int last = static_cast<int>(count) - 1;
+    auto at = [&](int i) {
+        if (loop) return points[(i % static_cast<int>(count) + static_cast<int>(count)) % static_cast<int>(count)];
+        return points[std::clamp(i, 0, last)];
+    };
+    const int segments = loop ? static_cast<int>(count) : last;
+
+    for (uint32_t k = 0; k <= p.ticks; ++k) {
+        const float u   = static_cast<float>(k) / static_cast<float>(p.ticks) * static_cast<float>(segments);
+        const int   seg = std::min(static_cast<int>(u), segments - 1);
+        const float t   = u - static_cast<float>(seg);
+        const float t2  = t * t;
+        const float t3  = t2 * t;
+
+        const SDL_FPoint p0 = at(seg - 1), p1 = at(seg), p2 = at(seg + 1), p3 = at(seg + 2);
+        auto catmullRom = [&](float a, float b, float c, float d) {
+            return 0.5f * (2.0f * b + (c - a) * t
+                         + (2.0f * a - 5.0f * b + 4.0f * c - d) * t2
+                         + (3.0f * b - a - 3.0f * c + d) * t3);
+        };
+        m_x.push_back(catmullRom(p0.x, p1.x, p2.x, p3.x));
+        m_y.push_back(catmullRom(p0.y, p1.y, p2.y, p3.y));
+    }
+    return add(p);
+}
+
+// One lookup per follower with no per-curve code: the loop body is the
+// same for a line and a spline. (AVX2 gathers were tried here and were
+// no faster than these scalar loads.)
+void PathLibrary::evaluate(size_t count, const Follower* followers, uint64_t now, SDL_FPoint* out) const
+{
+    const Path*  paths = m_paths.data();
+    const float* xs    = m_x.data();
+    const float* ys    = m_y.data();
+    for (size_t i = 0; i < count; ++i) {
+        const Follower& f = followers[i];
+        const size_t s = sampleIndex(paths[f.path], f.startTick, now);
+        out[i] = SDL_FPoint{f.originX + xs[s], f.originY + ys[s]};
+    }
+}
+
+void PathLibrary::clear()
+{
+    m_paths.clear();
+    m_x.clear();
+    m_y.clear();
+}
+
+} // namespace path
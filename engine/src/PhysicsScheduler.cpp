@@ -0,0 +1,168 @@
+#include "Engine/PhysicsScheduler.hpp"
+
+#include "Engine/Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace physics {
+
+Scheduler::Scheduler(const SchedulerConfig& config)
+    : m_config(config)
+{
+}
+
+Scheduler::~Scheduler()
+{
+    setAsync(false);
+}
+
+void Scheduler::setWorld(b2WorldId world)
+{
+    sync();
+    m_world    = world;
+    m_maxSpeed = 0.0f;
+}
+
+void Scheduler::setAsync(bool async)
+{
+    if (async == this->async()) return;
+
+    if (async) {
+        m_stop   = false;
+        m_worker = std::thread([this] { workerLoop(); });
+        return;
+    }
+
+    sync();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_worker.join();
+}
+
+int Scheduler::advance(float dt)
+{
+    m_accumulator += dt;
+    int steps = 0;
+    while (m_accumulator >= m_config.timeStep) {
+        m_accumulator -= m_config.timeStep;
+        if (steps < m_config.maxStepsPerFrame) {
+            ++steps;
+        } else {
+            ++m_droppedSteps;
+        }
+    }
+    return steps;
+}
+
+int Scheduler::subStepsFor(int awake, float maxSpeed) const
+{
+    // more when the fastest body would move over travelPerSubStep in one
+    const float travel = maxSpeed * m_config.timeStep;
+    int n = std::max(m_config.subSteps, static_cast<int>(std::ceil(travel / m_config.travelPerSubStep)));
+    n = std::min(n, m_config.maxSubSteps);
+
+    // a big crowd gets fewer, down to the minimum
+    if (awake > 0 && awake * n > m_config.subStepBudget) {
+        n = std::max(m_config.minSubSteps, m_config.subStepBudget / awake);
+    }
+    return n;
+}
+
+void Scheduler::step(int steps)
+{
+    sync();
+    runBatch(steps);
+}
+
+void Scheduler::launch(int steps)
+{
+    if (!async()) {
+        step(steps);
+        return;
+    }
+
+    sync();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = steps;
+    }
+    m_wake.notify_one();
+}
+
+void Scheduler::sync()
+{
+    if (!async()) return;
+
+    TRACE_ZONE("physics::sync", "physics");
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending < 0; });
+}
+
+void Scheduler::runBatch(int steps)
+{
+    StepReport report;
+    if (B2_IS_NULL(m_world)) {
+        m_report = report;
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    for (int i = 0; i < steps; ++i) {
+        // bodies only wake through the API, so nothing awake now means nothing moves
+        const int awake = b2World_GetAwakeBodyCount(m_world);
+        if (awake == 0) {
+            ++report.skipped;
+            continue;
+        }
+
+        const int subSteps = subStepsFor(awake, m_maxSpeed);
+        const auto start = Clock::now();
+        {
+            TRACE_ZONE("b2World_Step", "physics");
+            b2World_Step(m_world, m_config.timeStep, subSteps);
+        }
+        report.ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        ++report.steps;
+        report.subSteps = subSteps;
+        report.awake    = awake;
+
+        // speeds for the next step's substeps; moved bodies are the awake ones
+        const b2BodyEvents events = b2World_GetBodyEvents(m_world);
+        float maxSpeedSq = 0.0f;
+        for (int e = 0; e < events.moveCount; ++e) {
+            const b2Vec2 v = b2Body_GetLinearVelocity(events.moveEvents[e].bodyId);
+            maxSpeedSq = std::max(maxSpeedSq, v.x * v.x + v.y * v.y);
+        }
+        m_maxSpeed = std::sqrt(maxSpeedSq);
+    }
+    m_report = report;
+}
+
+void Scheduler::workerLoop()
+{
+    trace::setThreadName("physics");
+    for (;;) {
+        int steps = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || m_pending >= 0; });
+            if (m_stop) return;
+            steps = m_pending;
+        }
+
+        runBatch(steps);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending = -1;
+        }
+        m_done.notify_all();
+    }
+}
+
+} // namespace physics
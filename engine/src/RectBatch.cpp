@@ -0,0 +1,145 @@
+#include "Engine/RectBatch.hpp"
+
+#include "Engine/Cpu.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || CPU_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+    inline void setBits(uint64_t* hits, size_t first, uint64_t bits)
+    {
+        // 'first' is a multiple of the lane count, so a group never straddles two words
+        hits[first / 64] |= bits << (first % 64);
+    }
+
+    void scalarRange(const SDL_FRect& a,
+                     const float* x, const float* y, const float* w, const float* h,
+                     size_t begin, size_t end, uint64_t* hits)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            if (rectsIntersect(a, SDL_FRect{x[i], y[i], w[i], h[i]})) {
+                hits[i / 64] |= uint64_t{1} << (i % 64);
+            }
+        }
+    }
+
+#if CPU_AVX2
+    // 8 rects a step from 0; returns where it stopped
+    CPU_AVX2_FN size_t avx2Range(float ax0, float ax1, float ay0, float ay1,
+                                 const float* x, const float* y, const float* w, const float* h,
+                                 size_t n, uint64_t* hits)
+    {
+        const __m256 vax0 = _mm256_set1_ps(ax0), vax1 = _mm256_set1_ps(ax1);
+        const __m256 vay0 = _mm256_set1_ps(ay0), vay1 = _mm256_set1_ps(ay1);
+        const __m256 zero = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const __m256 bx = _mm256_loadu_ps(x + i), bw = _mm256_loadu_ps(w + i);
+            const __m256 by = _mm256_loadu_ps(y + i), bh = _mm256_loadu_ps(h + i);
+
+            // empty: w < 0 || h < 0
+            const __m256 empty = _mm256_or_ps(_mm256_cmp_ps(bw, zero, _CMP_LT_OQ),
+                                              _mm256_cmp_ps(bh, zero, _CMP_LT_OQ));
+
+            // _mm256_max_ps(p, q) is p > q ? p : q, the same select as the scalar code
+            const __m256 xmin = _mm256_max_ps(bx, vax0);
+            const __m256 xmax = _mm256_min_ps(_mm256_add_ps(bx, bw), vax1);
+            const __m256 ymin = _mm256_max_ps(by, vay0);
+            const __m256 ymax = _mm256_min_ps(_mm256_add_ps(by, bh), vay1);
+
+            const __m256 miss = _mm256_or_ps(empty,
+                                _mm256_or_ps(_mm256_cmp_ps(xmax, xmin, _CMP_LT_OQ),
+                                             _mm256_cmp_ps(ymax, ymin, _CMP_LT_OQ)));
+            const uint64_t bits = static_cast<uint64_t>(~_mm256_movemask_ps(miss) & 0xFF);
+            if (bits) setBits(hits, i, bits);
+        }
+        return i;
+    }
+#endif
+}
+
+void rectOverlapMaskScalar(const SDL_FRect& a,
+                           const float* x, const float* y, const float* w, const float* h,
+                           size_t n, uint64_t* hits)
+{
+    std::memset(hits, 0, ((n + 63) / 64) * sizeof(uint64_t));
+    scalarRange(a, x, y, w, h, 0, n, hits);
+}
+
+// The vector paths mirror rectsIntersect lane by lane: max/min are
+// written as compare + select with the same operand order so NaNs
+// and signed zeros come out exactly as in the scalar code.
+void rectOverlapMask(const SDL_FRect& a,
+                     const float* x, const float* y, const float* w, const float* h,
+                     size_t n, uint64_t* hits)
+{
+    std::memset(hits, 0, ((n + 63) / 64) * sizeof(uint64_t));
+    if (a.w < 0.0f || a.h < 0.0f) return;
+
+    const float ax0 = a.x, ax1 = a.x + a.w;
+    const float ay0 = a.y, ay1 = a.y + a.h;
+    size_t i = 0;
+
+    [[maybe_unused]] const cpu::Simd level = cpu::simd();
+#if CPU_AVX2
+    if (level >= cpu::Simd::Avx2) i = avx2Range(ax0, ax1, ay0, ay1, x, y, w, h, n, hits);
+#endif
+
+#if defined(__SSE2__)
+    if (level >= cpu::Simd::Vector128) {
+        const __m128 vax0 = _mm_set1_ps(ax0), vax1 = _mm_set1_ps(ax1);
+        const __m128 vay0 = _mm_set1_ps(ay0), vay1 = _mm_set1_ps(ay1);
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= n; i += 4) {
+            const __m128 bx = _mm_loadu_ps(x + i), bw = _mm_loadu_ps(w + i);
+            const __m128 by = _mm_loadu_ps(y + i), bh = _mm_loadu_ps(h + i);
+
+            const __m128 empty = _mm_or_ps(_mm_cmplt_ps(bw, zero), _mm_cmplt_ps(bh, zero));
+
+            const __m128 xmin = _mm_max_ps(bx, vax0);
+            const __m128 xmax = _mm_min_ps(_mm_add_ps(bx, bw), vax1);
+            const __m128 ymin = _mm_max_ps(by, vay0);
+            const __m128 ymax = _mm_min_ps(_mm_add_ps(by, bh), vay1);
+
+            const __m128 miss = _mm_or_ps(empty,
+                                _mm_or_ps(_mm_cmplt_ps(xmax, xmin), _mm_cmplt_ps(ymax, ymin)));
+            const uint64_t bits = static_cast<uint64_t>(~_mm_movemask_ps(miss) & 0xF);
+            if (bits) setBits(hits, i, bits);
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    if (level >= cpu::Simd::Vector128) {
+        const float32x4_t vax0 = vdupq_n_f32(ax0), vax1 = vdupq_n_f32(ax1);
+        const float32x4_t vay0 = vdupq_n_f32(ay0), vay1 = vdupq_n_f32(ay1);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const uint32x4_t  lane = {1u, 2u, 4u, 8u};
+        for (; i + 4 <= n; i += 4) {
+            const float32x4_t bx = vld1q_f32(x + i), bw = vld1q_f32(w + i);
+            const float32x4_t by = vld1q_f32(y + i), bh = vld1q_f32(h + i);
+
+            const uint32x4_t empty = vorrq_u32(vcltq_f32(bw, zero), vcltq_f32(bh, zero));
+
+            // vmaxq/vminq propagate NaN, so select explicitly
+            const float32x4_t bx1  = vaddq_f32(bx, bw);
+            const float32x4_t by1  = vaddq_f32(by, bh);
+            const float32x4_t xmin = vbslq_f32(vcgtq_f32(bx, vax0), bx, vax0);
+            const float32x4_t xmax = vbslq_f32(vcltq_f32(bx1, vax1), bx1, vax1);
+            const float32x4_t ymin = vbslq_f32(vcgtq_f32(by, vay0), by, vay0);
+            const float32x4_t ymax = vbslq_f32(vcltq_f32(by1, vay1), by1, vay1);
+
+            const uint32x4_t miss = vorrq_u32(empty,
+                                    vorrq_u32(vcltq_f32(xmax, xmin), vcltq_f32(ymax, ymin)));
+            const uint64_t bits = vaddvq_u32(vbicq_u32(lane, miss));
+            if (bits) setBits(hits, i, bits);
+        }
+    }
+#endif
+
+    scalarRange(a, x, y, w, h, i, n, hits);
+}
@@ -0,0 +1,225 @@
+#include "Engine/Script.hpp"
+
+#include "Engine/Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory_resource>
+
+namespace script {
+
+// ------------------------------------------------------------
+// Frame pool
+// ------------------------------------------------------------
+
+namespace {
+
+// Counts what the pool takes from the system allocator
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t bytes = 0;
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override
+    {
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* p, size_t size, size_t alignment) override
+    {
+        bytes -= size;
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// Ahead of every frame: the pool it came from, nullptr for the heap.
+// A whole max_align_t keeps the frame as aligned as operator new's.
+constexpr size_t FRAME_HEADER = alignof(std::max_align_t);
+
+} // namespace
+
+struct Runtime::FramePool {
+    CountingResource                       upstream;
+    std::pmr::unsynchronized_pool_resource pool{std::pmr::pool_options{0, 4096}, &upstream};
+};
+
+thread_local Runtime::FramePool* Runtime::s_framePool = nullptr;
+
+void* Task::promise_type::operator new(size_t size)
+{
+    Runtime::FramePool* owner = Runtime::s_framePool;
+    void* block = owner ? owner->pool.allocate(size + FRAME_HEADER, alignof(std::max_align_t))
+                        : ::operator new(size + FRAME_HEADER);
+    *static_cast<Runtime::FramePool**>(block) = owner;
+    return static_cast<uint8_t*>(block) + FRAME_HEADER;
+}
+
+void Task::promise_type::operator delete(void* frame, size_t size)
+{
+    void* block = static_cast<uint8_t*>(frame) - FRAME_HEADER;
+    Runtime::FramePool* owner = *static_cast<Runtime::FramePool**>(block);
+    if (owner) {
+        owner->pool.deallocate(block, size + FRAME_HEADER, alignof(std::max_align_t));
+    } else {
+        ::operator delete(block, size + FRAME_HEADER);
+    }
+}
+
+Runtime::FrameSource::FrameSource(Runtime& runtime)
+    : m_previous(std::exchange(s_framePool, runtime.m_pool.get()))
+{
+}
+
+Runtime::FrameSource::~FrameSource()
+{
+    s_framePool = m_previous;
+}
+
+// ------------------------------------------------------------
+// Waiting
+// ------------------------------------------------------------
+
+void Wait::await_suspend(Task::Handle handle) const
+{
+    Runtime& runtime = *handle.promise().runtime;
+    runtime.sleep(handle.promise().slot, inTicks ? ticks : runtime.ticksFor(seconds));
+}
+
+// ------------------------------------------------------------
+// Runtime
+// ------------------------------------------------------------
+
+Runtime::Runtime(float tickSeconds, size_t capacity)
+    : m_pool(std::make_unique<FramePool>())
+    , m_tickSeconds(tickSeconds)
+    , m_wakes(capacity)
+{
+    m_slots.reserve(capacity);
+    m_freeSlots.reserve(capacity);
+}
+
+Runtime::~Runtime()
+{
+    stopAll();
+}
+
+size_t Runtime::poolBytes() const
+{
+    return m_pool->upstream.bytes;
+}
+
+uint64_t Runtime::ticksFor(float seconds) const
+{
+    return static_cast<uint64_t>(std::max(0L, std::lround(seconds / m_tickSeconds)));
+}
+
+ScriptId Runtime::start(Task task, uint64_t wakeTick, Tag tag)
+{
+    Task::Handle handle = task.release();
+    if (!handle) return ScriptId{};
+
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    Slot& s    = m_slots[slot];
+    s.handle   = handle;
+    s.tag      = tag;
+    s.stopping = false;
+    s.wake     = m_wakes.schedule(wakeTick, timer::Timer{0, slot});
+    handle.promise().runtime = this;
+    handle.promise().slot    = slot;
+    ++m_count;
+    return ScriptId{slot, s.generation};
+}
+
+bool Runtime::running(ScriptId id) const
+{
+    return id.index < m_slots.size() && m_slots[id.index].generation == id.generation &&
+           m_slots[id.index].handle && !m_slots[id.index].stopping;
+}
+
+void Runtime::stop(ScriptId id)
+{
+    if (!running(id)) return;
+    if (id.index == m_current) {
+        // cannot destroy a frame that is executing; run() does it when it suspends
+        m_slots[id.index].stopping = true;
+        return;
+    }
+    finish(id.index);
+}
+
+void Runtime::stopAll()
+{
+    for (uint32_t slot = 0; slot < m_slots.size(); ++slot) {
+        if (!m_slots[slot].handle) continue;
+        if (slot == m_current) {
+            m_slots[slot].stopping = true;
+        } else {
+            finish(slot);
+        }
+    }
+}
+
+void Runtime::finish(uint32_t slot)
+{
+    Slot& s = m_slots[slot];
+    s.handle.destroy();
+    s.handle   = {};
+    s.stopping = false;
+    m_wakes.cancel(s.wake);
+    ++s.generation;
+    m_freeSlots.push_back(slot);
+    --m_count;
+}
+
+void Runtime::sleep(uint32_t slot, uint64_t ticks)
+{
+    m_slots[slot].wake = m_wakes.schedule(m_wakes.now() + std::max<uint64_t>(ticks, 1), timer::Timer{0, slot});
+}
+
+void Runtime::run(uint64_t now)
+{
+    TRACE_ZONE("script::Runtime::run", "game");
+    FrameSource source(*this);   // for scripts the resumed ones start
+    m_wakes.advance(now, [this](timer::TimerId, const timer::Timer& wake) {
+        resume(static_cast<uint32_t>(wake.arg));
+    });
+}
+
+void Runtime::resume(uint32_t slot)
+{
+    // the script may start others, which can grow m_slots: no references across resume()
+    m_current = slot;
+    m_slots[slot].handle.resume();
+    m_current = 0xFFFFFFFFu;
+    ++m_resumes;
+
+    if (m_slots[slot].handle.done() || m_slots[slot].stopping) finish(slot);
+}
+
+void Runtime::save(snapshot::Writer& out) const
+{
+    m_wakes.list(m_saveOrder);
+
+    out.put(m_wakes.now());
+    out.put(static_cast<uint32_t>(m_saveOrder.size()));
+    for (const timer::Wheel::Pending& wake : m_saveOrder) {
+        const Tag& tag = m_slots[static_cast<uint32_t>(wake.timer.arg)].tag;
+        // field by field: no padding reaches the bytes
+        out.put(tag.kind);
+        out.put(tag.arg);
+        out.put(wake.tick);
+    }
+}
+
+} // namespace script
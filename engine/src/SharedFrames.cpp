@@ -0,0 +1,245 @@
+#include "Engine/SharedFrames.hpp"
+
+#include "Engine/Log.hpp"
+#include "Engine/Trace.hpp"
+
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHM_POSIX 1
+#else
+#define SHM_POSIX 0
+#endif
+
+namespace shm {
+
+namespace {
+
+    constexpr size_t HEADER_BYTES = 64;   // the first slot starts a cache line in
+    static_assert(sizeof(RingHeader) <= HEADER_BYTES);
+
+    constexpr size_t alignUp(size_t n) { return (n + 63) & ~size_t{63}; }
+
+    // 'base' is the start of the mapping, as uint8_t or const uint8_t
+    template <typename Byte>
+    Byte* slotAt(Byte* base, const RingHeader& header, uint64_t sequence)
+    {
+        return base + HEADER_BYTES + (sequence % header.slotCount) * header.slotBytes;
+    }
+
+} // namespace
+
+// ------------------------------------------------------------
+// Publisher
+// ------------------------------------------------------------
+
+Publisher::~Publisher()
+{
+    stop();
+}
+
+bool Publisher::start(const std::string& name, int width, int height, int slots)
+{
+    stop();
+#if SHM_POSIX
+    if (width <= 0 || height <= 0 || slots < 2) {
+        LOG_ERROR("[Shm] Bad ring size: %dx%d, %d slots", width, height, slots);
+        return false;
+    }
+    const size_t slotBytes = alignUp(SLOT_HEADER_BYTES + static_cast<size_t>(width) * height * 4);
+    if (slotBytes > UINT32_MAX) {
+        LOG_ERROR("[Shm] %dx%d frames are too large to share", width, height);
+        return false;
+    }
+    const size_t bytes = HEADER_BYTES + slotBytes * static_cast<size_t>(slots);
+
+    // a ring left behind by a crashed run is replaced, not reused
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        LOG_ERROR("[Shm] shm_open failed for %s", name.c_str());
+        return false;
+    }
+    void* base = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+        base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR("[Shm] Could not map %zu bytes for %s", bytes, name.c_str());
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    RingHeader* header = new (base) RingHeader{};
+    header->width     = static_cast<uint32_t>(width);
+    header->height    = static_cast<uint32_t>(height);
+    header->slotCount = static_cast<uint32_t>(slots);
+    header->slotBytes = static_cast<uint32_t>(slotBytes);
+    for (int i = 0; i < slots; ++i) {
+        new (slotAt(static_cast<uint8_t*>(base), *header, static_cast<uint64_t>(i))) SlotHeader{};
+    }
+
+    m_name     = name;
+    m_header   = header;
+    m_bytes    = bytes;
+    m_sequence = 0;
+    LOG_INFO("[Shm] Publishing %dx%d frames to %s (%d slots, %.1f MB)", width, height, name.c_str(), slots,
+             bytes / (1024.0 * 1024.0));
+    return true;
+#else
+    (void)name; (void)width; (void)height; (void)slots;
+    LOG_ERROR("[Shm] Shared memory export needs POSIX shared memory");
+    return false;
+#endif
+}
+
+void Publisher::stop()
+{
+    if (!m_header) return;
+#if SHM_POSIX
+    m_header->closed.store(1, std::memory_order_release);
+    munmap(m_header, m_bytes);
+    shm_unlink(m_name.c_str());
+#endif
+    LOG_INFO("[Shm] Published %llu frames to %s", static_cast<unsigned long long>(m_sequence), m_name.c_str());
+    m_header = nullptr;
+    m_bytes  = 0;
+}
+
+bool Publisher::publish(SDL_Surface* surface, uint64_t frameIndex, const GameState& state)
+{
+    if (!m_header || !surface) return false;
+    const int width  = static_cast<int>(m_header->width);
+    const int height = static_cast<int>(m_header->height);
+    if (surface->w != width || surface->h != height) return false;
+    TRACE_ZONE("shm::Publisher::publish", "capture");
+
+    const uint64_t sequence = m_sequence + 1;
+    uint8_t*       at       = slotAt(reinterpret_cast<uint8_t*>(m_header), *m_header, sequence);
+    SlotHeader*    slot     = reinterpret_cast<SlotHeader*>(at);
+
+    // a reader still on the frame this slot held sees it go stale
+    slot->sequence.store(WRITING, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const bool lock = SDL_MUSTLOCK(surface);
+    if (lock && !SDL_LockSurface(surface)) return false;
+    const bool ok = SDL_ConvertPixels(width, height, surface->format, surface->pixels, surface->pitch,
+                                      SDL_PIXELFORMAT_RGBA32, at + SLOT_HEADER_BYTES, width * 4);
+    if (lock) SDL_UnlockSurface(surface);
+    if (!ok) return false;   // the slot stays WRITING until it is used again
+
+    slot->frameIndex = frameIndex;
+    slot->state      = state;
+    slot->sequence.store(sequence, std::memory_order_release);
+    m_header->latest.store(sequence, std::memory_order_release);
+    m_sequence = sequence;
+    return true;
+}
+
+// ------------------------------------------------------------
+// Reader
+// ------------------------------------------------------------
+
+Reader::~Reader()
+{
+    close();
+}
+
+bool Reader::open(const std::string& name)
+{
+    close();
+#if SHM_POSIX
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat info {};
+    void* base = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= HEADER_BYTES) {
+        base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    const size_t      bytes  = static_cast<size_t>(info.st_size);
+    const RingHeader* header = static_cast<const RingHeader*>(base);
+    const size_t      frame  = static_cast<size_t>(header->width) * header->height * 4;
+    const bool fits = header->magic == MAGIC && header->version == VERSION && header->slotCount >= 2 &&
+                      header->slotBytes >= SLOT_HEADER_BYTES + frame &&
+                      bytes >= HEADER_BYTES + static_cast<size_t>(header->slotCount) * header->slotBytes;
+    if (!fits) {
+        LOG_ERROR("[Shm] %s is not a version %u frame ring", name.c_str(), VERSION);
+        munmap(base, bytes);
+        return false;
+    }
+
+    m_header = header;
+    m_bytes  = bytes;
+    return true;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void Reader::close()
+{
+    if (!m_header) return;
+#if SHM_POSIX
+    munmap(const_cast<RingHeader*>(m_header), m_bytes);
+#endif
+    m_header = nullptr;
+    m_bytes  = 0;
+}
+
+bool Reader::closed() const
+{
+    return m_header && m_header->closed.load(std::memory_order_acquire) != 0;
+}
+
+int Reader::width() const  { return m_header ? static_cast<int>(m_header->width) : 0; }
+int Reader::height() const { return m_header ? static_cast<int>(m_header->height) : 0; }
+
+const SlotHeader* Reader::slot(uint64_t sequence) const
+{
+    return reinterpret_cast<const SlotHeader*>(slotAt(reinterpret_cast<const uint8_t*>(m_header), *m_header, sequence));
+}
+
+bool Reader::latest(FrameView& out, uint64_t after) const
+{
+    if (!m_header) return false;
+
+    // a few tries: the game can lap a slot between reading 'latest' and the slot
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const uint64_t sequence = m_header->latest.load(std::memory_order_acquire);
+        if (sequence == 0 || sequence <= after) return false;
+
+        const SlotHeader* s = slot(sequence);
+        if (s->sequence.load(std::memory_order_acquire) != sequence) continue;
+
+        out.sequence   = sequence;
+        out.frameIndex = s->frameIndex;
+        out.state      = s->state;
+        out.pixels     = reinterpret_cast<const uint8_t*>(s) + SLOT_HEADER_BYTES;
+        out.width      = static_cast<int>(m_header->width);
+        out.height     = static_cast<int>(m_header->height);
+        out.pitch      = out.width * 4;
+        if (valid(out)) return true;
+    }
+    return false;
+}
+
+bool Reader::valid(const FrameView& frame) const
+{
+    if (!m_header || frame.sequence == 0) return false;
+    // whatever was read of the slot happens before this load
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot(frame.sequence)->sequence.load(std::memory_order_relaxed) == frame.sequence;
+}
+
+} // namespace shm
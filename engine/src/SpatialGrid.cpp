@@ -0,0 +1,376 @@
+#include "Engine/SpatialGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace spatial {
+
+namespace {
+
+// Squared distance from (x, y) to the closest point of r
+float distanceSq(const SDL_FRect& r, float x, float y)
+{
+    const float dx = std::max(std::max(r.x - x, x - (r.x + r.w)), 0.0f);
+    const float dy = std::max(std::max(r.y - y, y - (r.y + r.h)), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+// Parameter where the segment p + t*d, t in [0, 1], enters r
+bool segmentEntry(const SDL_FRect& r, float x0, float y0, float dx, float dy, float& t)
+{
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    auto slab = [&](float p, float d, float lo, float hi) {
+        if (d == 0.0f) return p >= lo && p <= hi;
+        float t0 = (lo - p) / d;
+        float t1 = (hi - p) / d;
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        return tMin <= tMax;
+    };
+    if (!slab(x0, dx, r.x, r.x + r.w) || !slab(y0, dy, r.y, r.y + r.h)) return false;
+    t = tMin;
+    return true;
+}
+
+// Result order: closer first, lower entity index on ties
+bool closer(const Neighbour& a, const Neighbour& b)
+{
+    if (a.distance != b.distance) return a.distance < b.distance;
+    return a.entity.index < b.entity.index;
+}
+
+bool earlier(const SegmentHit& a, const SegmentHit& b)
+{
+    if (a.t != b.t) return a.t < b.t;
+    return a.entity.index < b.entity.index;
+}
+
+// Keeps the k closest in a max-heap; distances are squared until the end
+void offer(std::vector<Neighbour>& heap, size_t k, const Neighbour& n)
+{
+    if (heap.size() < k) {
+        heap.push_back(n);
+        std::push_heap(heap.begin(), heap.end(), closer);
+    } else if (closer(n, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), closer);
+        heap.back() = n;
+        std::push_heap(heap.begin(), heap.end(), closer);
+    }
+}
+
+void finishNearest(std::vector<Neighbour>& heap)
+{
+    std::sort_heap(heap.begin(), heap.end(), closer);
+    for (Neighbour& n : heap) n.distance = std::sqrt(n.distance);
+}
+
+} // namespace
+
+Grid::Grid(float cellSize, size_t buckets)
+    : m_cellSize(cellSize > 0.0f ? cellSize : 64.0f)
+    , m_invCellSize(1.0f / m_cellSize)
+{
+    size_t count = 16;
+    while (count < buckets && count < (size_t{1} << 30)) count *= 2;
+    m_bucketMask = static_cast<uint32_t>(count - 1);
+    m_heads.assign(count, s_none);
+}
+
+int32_t Grid::cellOf(float v) const
+{
+    // far-off or NaN coordinates share the edge cells instead of overflowing
+    constexpr float limit = 1073741824.0f;
+    const float c = std::floor(v * m_invCellSize);
+    return static_cast<int32_t>(c < -limit ? -limit : (c < limit ? c : limit));
+}
+
+uint32_t Grid::bucketOf(int32_t cx, int32_t cy) const
+{
+    uint32_t h = static_cast<uint32_t>(cx) * 0x9E3779B1u ^ static_cast<uint32_t>(cy) * 0x85EBCA77u;
+    h ^= h >> 15;
+    return h & m_bucketMask;
+}
+
+void Grid::link(uint32_t slot)
+{
+    Item& item = m_items[slot];
+    uint32_t& head = m_heads[item.bucket];
+    item.prev = s_none;
+    item.next = head;
+    if (head != s_none) m_items[head].prev = slot;
+    head = slot;
+}
+
+void Grid::unlink(uint32_t slot)
+{
+    const Item& item = m_items[slot];
+    if (item.prev != s_none) m_items[item.prev].next = item.next;
+    else                     m_heads[item.bucket]    = item.next;
+    if (item.next != s_none) m_items[item.next].prev = item.prev;
+}
+
+void Grid::update(ecs::Entity e, const SDL_FRect& rect)
+{
+    if (e.index >= m_slotOf.size()) m_slotOf.resize(static_cast<size_t>(e.index) + 1, s_none);
+
+    // the index now belongs to a newer entity: the old one is gone
+    if (m_slotOf[e.index] != s_none && m_items[m_slotOf[e.index]].entity.generation != e.generation) {
+        removeSlot(m_slotOf[e.index]);
+    }
+
+    m_maxHalfExtent = std::max(m_maxHalfExtent, std::max(rect.w, rect.h) * 0.5f);
+    const int32_t cx = cellOf(rect.x + rect.w * 0.5f);
+    const int32_t cy = cellOf(rect.y + rect.h * 0.5f);
+
+    const uint32_t slot = m_slotOf[e.index];
+    if (slot == s_none) {
+        m_slotOf[e.index] = static_cast<uint32_t>(m_items.size());
+        m_items.push_back(Item{e, rect, cx, cy, bucketOf(cx, cy), s_none, s_none});
+        link(m_slotOf[e.index]);
+        return;
+    }
+
+    Item& item = m_items[slot];
+    item.rect = rect;
+    if (item.cellX == cx && item.cellY == cy) return;
+
+    unlink(slot);
+    item.cellX  = cx;
+    item.cellY  = cy;
+    item.bucket = bucketOf(cx, cy);
+    link(slot);
+}
+
+void Grid::remove(ecs::Entity e)
+{
+    if (contains(e)) removeSlot(m_slotOf[e.index]);
+}
+
+bool Grid::contains(ecs::Entity e) const
+{
+    return e.index < m_slotOf.size() && m_slotOf[e.index] != s_none
+        && m_items[m_slotOf[e.index]].entity == e;
+}
+
+// The last item fills the hole, so slots stay dense
+void Grid::removeSlot(uint32_t slot)
+{
+    unlink(slot);
+    m_slotOf[m_items[slot].entity.index] = s_none;
+
+    const uint32_t last = static_cast<uint32_t>(m_items.size() - 1);
+    if (slot != last) {
+        unlink(last);
+        m_items[slot] = m_items[last];
+        m_slotOf[m_items[slot].entity.index] = slot;
+        link(slot);
+    }
+    m_items.pop_back();
+}
+
+void Grid::clear()
+{
+    m_items.clear();
+    m_slotOf.clear();
+    std::fill(m_heads.begin(), m_heads.end(), s_none);
+    m_maxHalfExtent = 0.0f;
+}
+
+// ------------------------------------------------------------
+// Queries
+// ------------------------------------------------------------
+
+void Grid::radius(float x, float y, float r, std::vector<ecs::Entity>& out) const
+{
+    out.clear();
+    const float reach = r + m_maxHalfExtent;
+    const int32_t x0 = cellOf(x - reach), x1 = cellOf(x + reach);
+    const int32_t y0 = cellOf(y - reach), y1 = cellOf(y + reach);
+
+    // a range wider than the population is cheaper to scan outright
+    const int64_t cells = (int64_t{x1} - x0 + 1) * (int64_t{y1} - y0 + 1);
+    if (cells > static_cast<int64_t>(m_items.size())) {
+        radiusLinear(x, y, r, out);
+        return;
+    }
+
+    const float r2 = r * r;
+    for (int32_t cy = y0; cy <= y1; ++cy) {
+        for (int32_t cx = x0; cx <= x1; ++cx) {
+            forEachInCell(cx, cy, [&](const Item& item) {
+                if (distanceSq(item.rect, x, y) <= r2) out.push_back(item.entity);
+            });
+        }
+    }
+}
+
+void Grid::radiusLinear(float x, float y, float r, std::vector<ecs::Entity>& out) const
+{
+    out.clear();
+    const float r2 = r * r;
+    for (const Item& item : m_items) {
+        if (distanceSq(item.rect, x, y) <= r2) out.push_back(item.entity);
+    }
+}
+
+// Rings of cells outward from the query point. Everything outside
+// ring R has its centre at least R cells away, so the search ends
+// once the k-th best is closer than that minus the largest half extent.
+void Grid::nearest(float x, float y, size_t k, std::vector<Neighbour>& out) const
+{
+    out.clear();
+    if (k == 0 || m_items.empty()) return;
+
+    const int32_t px = cellOf(x);
+    const int32_t py = cellOf(y);
+    size_t seen    = 0;
+    size_t scanned = 0;
+
+    auto visit = [&](int32_t cx, int32_t cy) {
+        ++scanned;
+        forEachInCell(cx, cy, [&](const Item& item) {
+            ++seen;
+            offer(out, k, Neighbour{item.entity, distanceSq(item.rect, x, y)});
+        });
+    };
+
+    for (int32_t ring = 0;; ++ring) {
+        if (ring == 0) {
+            visit(px, py);
+        } else {
+            for (int32_t cx = px - ring; cx <= px + ring; ++cx) {
+                visit(cx, py - ring);
+                visit(cx, py + ring);
+            }
+            for (int32_t cy = py - ring + 1; cy <= py + ring - 1; ++cy) {
+                visit(px - ring, cy);
+                visit(px + ring, cy);
+            }
+        }
+
+        if (seen == m_items.size()) break;
+
+        // slightly short of R cells, for the rounding in cellOf()
+        const float bound = (static_cast<float>(ring) - 0.001f) * m_cellSize - m_maxHalfExtent;
+        if (out.size() == k && bound > 0.0f && out.front().distance < bound * bound) break;
+
+        // far from everything: the rings cost more than a scan
+        if (scanned > m_items.size() + 64) {
+            nearestLinear(x, y, k, out);
+            return;
+        }
+    }
+
+    finishNearest(out);
+}
+
+void Grid::nearestLinear(float x, float y, size_t k, std::vector<Neighbour>& out) const
+{
+    out.clear();
+    if (k == 0) return;
+    for (const Item& item : m_items) {
+        offer(out, k, Neighbour{item.entity, distanceSq(item.rect, x, y)});
+    }
+    finishNearest(out);
+}
+
+// Walks the cells under the segment in order. A rect can reach into
+// a cell from 'pad' cells away, so each step tests the leading row or
+// column of the padded window; every cell is tested once. The walk
+// stops when it enters a cell beyond the best hit so far.
+bool Grid::segment(float x0, float y0, float x1, float y1, SegmentHit& out) const
+{
+    if (m_items.empty()) return false;
+
+    const float   dx  = x1 - x0;
+    const float   dy  = y1 - y0;
+    const int32_t pad = static_cast<int32_t>(m_maxHalfExtent * m_invCellSize) + 1;
+
+    int32_t cx = cellOf(x0), cy = cellOf(y0);
+    const int32_t endX = cellOf(x1), endY = cellOf(y1);
+
+    const int64_t steps  = std::abs(int64_t{endX} - cx) + std::abs(int64_t{endY} - cy) + 1;
+    const int64_t window = 2 * int64_t{pad} + 1;
+    if (steps * window > static_cast<int64_t>(m_items.size())) {
+        return segmentLinear(x0, y0, x1, y1, out);
+    }
+
+    bool found = false;
+    SegmentHit best;
+    auto test = [&](int32_t tx, int32_t ty) {
+        forEachInCell(tx, ty, [&](const Item& item) {
+            SegmentHit hit;
+            if (!segmentEntry(item.rect, x0, y0, dx, dy, hit.t)) return;
+            hit.entity = item.entity;
+            if (!found || earlier(hit, best)) {
+                best  = hit;
+                found = true;
+            }
+        });
+    };
+
+    for (int32_t ty = cy - pad; ty <= cy + pad; ++ty) {
+        for (int32_t tx = cx - pad; tx <= cx + pad; ++tx) test(tx, ty);
+    }
+
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    const int32_t stepX  = dx > 0.0f ? 1 : -1;
+    const int32_t stepY  = dy > 0.0f ? 1 : -1;
+    float nextX  = dx != 0.0f ? ((cx + (dx > 0.0f ? 1 : 0)) * m_cellSize - x0) / dx : inf;
+    float nextY  = dy != 0.0f ? ((cy + (dy > 0.0f ? 1 : 0)) * m_cellSize - y0) / dy : inf;
+    const float deltaX = dx != 0.0f ? m_cellSize / std::fabs(dx) : inf;
+    const float deltaY = dy != 0.0f ? m_cellSize / std::fabs(dy) : inf;
+
+    // exactly one move per step, so the walk ends in the end cell
+    // even when rounding puts a crossing on the wrong side
+    for (int64_t step = 1; step < steps; ++step) {
+        const bool alongX = cy == endY || (cx != endX && nextX < nextY);
+        const float enter = alongX ? nextX : nextY;
+        if (enter > 1.0f || (found && enter > best.t)) break;
+
+        if (alongX) {
+            nextX += deltaX;
+            cx += stepX;
+            const int32_t tx = cx + stepX * pad;
+            for (int32_t ty = cy - pad; ty <= cy + pad; ++ty) test(tx, ty);
+        } else {
+            nextY += deltaY;
+            cy += stepY;
+            const int32_t ty = cy + stepY * pad;
+            for (int32_t tx = cx - pad; tx <= cx + pad; ++tx) test(tx, ty);
+        }
+    }
+
+    if (found) {
+        best.point = SDL_FPoint{x0 + dx * best.t, y0 + dy * best.t};
+        out = best;
+    }
+    return found;
+}
+
+bool Grid::segmentLinear(float x0, float y0, float x1, float y1, SegmentHit& out) const
+{
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+    bool found = false;
+    SegmentHit best;
+    for (const Item& item : m_items) {
+        SegmentHit hit;
+        if (!segmentEntry(item.rect, x0, y0, dx, dy, hit.t)) continue;
+        hit.entity = item.entity;
+        if (!found || earlier(hit, best)) {
+            best  = hit;
+            found = true;
+        }
+    }
+    if (found) {
+        best.point = SDL_FPoint{x0 + dx * best.t, y0 + dy * best.t};
+        out = best;
+    }
+    return found;
+}
+
+} // namespace spatial
@@ -0,0 +1,106 @@
+#include "Engine/SpriteSheet.hpp"
+
+#include <algorithm>
+
+const char* coverageName(Coverage coverage)
+{
+    switch (coverage) {
+        case Coverage::Empty:       return "empty";
+        case Coverage::Opaque:      return "opaque";
+        case Coverage::Keyed:       return "keyed";
+        case Coverage::Translucent: return "translucent";
+    }
+    return "?";
+}
+
+SpriteSheet SpriteSheet::fromRGBA(const uint8_t* pixels, int pitch,
+                                  int sheetWidth, int sheetHeight,
+                                  int frameWidth, int frameHeight)
+{
+    SpriteSheet sheet;
+    if (!pixels || sheetWidth <= 0 || sheetHeight <= 0) return sheet;
+
+    if (frameWidth <= 0 || frameWidth > sheetWidth)    frameWidth  = sheetWidth;
+    if (frameHeight <= 0 || frameHeight > sheetHeight) frameHeight = sheetHeight;
+
+    sheet.m_sheetWidth  = sheetWidth;
+    sheet.m_sheetHeight = sheetHeight;
+    sheet.m_frameWidth  = frameWidth;
+    sheet.m_frameHeight = frameHeight;
+    sheet.m_columns     = sheetWidth / frameWidth;
+    sheet.m_frames.resize(static_cast<size_t>(sheet.m_columns) * (sheetHeight / frameHeight));
+
+    for (size_t f = 0; f < sheet.m_frames.size(); ++f) {
+        const int originX = static_cast<int>(f % sheet.m_columns) * frameWidth;
+        const int originY = static_cast<int>(f / sheet.m_columns) * frameHeight;
+
+        int  minX = frameWidth, minY = frameHeight, maxX = -1, maxY = -1;
+        bool holes = false, partial = false;
+        for (int y = 0; y < frameHeight; ++y) {
+            const uint8_t* row = pixels + static_cast<size_t>(originY + y) * pitch + originX * 4;
+            for (int x = 0; x < frameWidth; ++x) {
+                const uint8_t* px = row + x * 4;
+                // the collision masks' rule: magenta and alpha 0 draw nothing
+                if ((px[0] == 255 && px[1] == 0 && px[2] == 255) || px[3] == 0) {
+                    holes = true;
+                    continue;
+                }
+                partial |= px[3] != 255;
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+
+        Frame& frame = sheet.m_frames[f];
+        if (maxX < 0) continue;   // empty
+        frame.bounds   = SDL_Rect{minX, minY, maxX - minX + 1, maxY - minY + 1};
+        frame.coverage = partial ? Coverage::Translucent : holes ? Coverage::Keyed : Coverage::Opaque;
+        sheet.m_coverage = std::max(sheet.m_coverage, frame.coverage);
+    }
+    return sheet;
+}
+
+int SpriteSheet::frameAt(const SDL_FRect& src) const
+{
+    if (empty()) return 0;
+    const int column = static_cast<int>(src.x) / m_frameWidth;
+    const int row    = static_cast<int>(src.y) / m_frameHeight;
+    // strips that step past the sheet width wrap like a flat frame index
+    return (row * m_columns + column) % frameCount();
+}
+
+bool SpriteSheet::trim(const SDL_FRect* src, const SDL_FRect& dst, SDL_FRect& trimmedSrc, SDL_FRect& trimmedDst) const
+{
+    const SDL_FRect cell = src ? *src
+                               : SDL_FRect{0.0f, 0.0f, static_cast<float>(m_sheetWidth), static_cast<float>(m_sheetHeight)};
+    const bool oneFrame = src ? cell.w == m_frameWidth && cell.h == m_frameHeight : frameCount() == 1;
+    if (empty() || !oneFrame) {
+        // not one measured frame: draw as asked
+        trimmedSrc = cell;
+        trimmedDst = dst;
+        return true;
+    }
+
+    const SDL_Rect& b = bounds(frameAt(cell));
+    if (b.w == 0) return false;
+
+    // multiply before dividing: an unscaled draw moves by whole pixels exactly
+    trimmedSrc = SDL_FRect{cell.x + b.x, cell.y + b.y, static_cast<float>(b.w), static_cast<float>(b.h)};
+    trimmedDst = SDL_FRect{dst.x + b.x * dst.w / cell.w, dst.y + b.y * dst.h / cell.h,
+                           b.w * dst.w / cell.w, b.h * dst.h / cell.h};
+    return true;
+}
+
+uint64_t SpriteSheet::cellPixels() const
+{
+    return static_cast<uint64_t>(m_frameWidth) * m_frameHeight * m_frames.size();
+}
+
+uint64_t SpriteSheet::trimmedPixels() const
+{
+    uint64_t pixels = 0;
+    for (const Frame& f : m_frames) pixels += static_cast<uint64_t>(f.bounds.w) * f.bounds.h;
+    return pixels;
+}
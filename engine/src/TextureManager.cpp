@@ -1,6 +1,6 @@
 #include "Engine/TextureManager.hpp"
-
-#include <iostream>
+#include "Engine/Log.hpp"
+#include "Engine/Trace.hpp"
 
 TextureManager::~TextureManager()
 {
@@ -14,23 +14,104 @@ void TextureManager::setRenderer(SDL_Renderer* renderer)
 
 SDL_Texture* TextureManager::load(const std::string& path)
 {
+    return loadTexture(path, 0, 0, false);
+}
+
+SDL_Texture* TextureManager::load(const std::string& path, int frameWidth, int frameHeight)
+{
+    return loadTexture(path, frameWidth, frameHeight, true);
+}
+
+SDL_Texture* TextureManager::createTarget(const std::string& name, int width, int height)
+{
+    if (!m_renderer) {
+        LOG_ERROR("[TextureManager] Renderer not set");
+        return nullptr;
+    }
+
+    SDL_Texture* tex = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!tex) {
+        LOG_ERROR("[TextureManager] SDL_CreateTexture failed for %s: %s", name.c_str(), SDL_GetError());
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);
+
+    SDL_Texture*& slot = m_cache[name];
+    if (slot) {
+        m_masks.erase(slot);
+        m_sheets.erase(slot);
+        SDL_DestroyTexture(slot);
+    }
+    slot = tex;
+    return tex;
+}
+
+const CollisionMask* TextureManager::getMask(SDL_Texture* texture) const
+{
+    auto it = m_masks.find(texture);
+    return it != m_masks.end() ? &it->second : nullptr;
+}
+
+const SpriteSheet* TextureManager::getSheet(SDL_Texture* texture) const
+{
+    auto it = m_sheets.find(texture);
+    return it != m_sheets.end() ? &it->second : nullptr;
+}
+
+// Frame bounds and coverage, and the collision mask when asked for,
+// from one conversion of the pixels
+void TextureManager::inspect(SDL_Texture* texture, SDL_Surface* surface, int frameWidth, int frameHeight, bool buildMask)
+{
+    // read the pixels in a known byte order: R, G, B, A
+    SDL_Surface* rgba = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+    if (!rgba) {
+        LOG_WARN("[TextureManager] Could not convert surface for inspection: %s", SDL_GetError());
+        return;
+    }
+
+    SDL_LockSurface(rgba);
+    const uint8_t* pixels = static_cast<const uint8_t*>(rgba->pixels);
+    SpriteSheet sheet = SpriteSheet::fromRGBA(pixels, rgba->pitch, rgba->w, rgba->h, frameWidth, frameHeight);
+    if (buildMask) {
+        m_masks[texture] = CollisionMask::fromRGBA(pixels, rgba->pitch, rgba->w, rgba->h, frameWidth, frameHeight);
+    }
+    SDL_UnlockSurface(rgba);
+    SDL_DestroySurface(rgba);
+
+    // a keyed surface makes a blended texture; nothing to blend in an opaque one
+    SDL_SetTextureBlendMode(texture, sheet.coverage() == Coverage::Opaque ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+    if (!sheet.empty()) m_sheets[texture] = std::move(sheet);
+}
+
+SDL_Texture* TextureManager::loadTexture(const std::string& path, int frameWidth, int frameHeight, bool wantMask)
+{
+    TRACE_ZONE("TextureManager::load", "assets");
+
     // Check if renderer is set
     if (!m_renderer) {
-        std::cerr << "[TextureManager] Renderer not set\n";
+        LOG_ERROR("[TextureManager] Renderer not set");
         return nullptr;
     }
 
     // Check cache first
     auto it = m_cache.find(path);
     if (it != m_cache.end()) {
+        if (wantMask && it->second && !m_masks.count(it->second)) {
+            // cached without a mask: decode once more to build it, and
+            // measure the frames on this grid
+            if (SDL_Surface* surface = SDL_LoadBMP(path.c_str())) {
+                inspect(it->second, surface, frameWidth, frameHeight, true);
+                SDL_DestroySurface(surface);
+            }
+        }
         return it->second;
     }
 
     // Load BMP surface
     SDL_Surface* surface = SDL_LoadBMP(path.c_str());
     if (!surface) {
-        std::cerr << "[TextureManager] SDL_LoadBMP failed for " << path
-                  << ": " << SDL_GetError() << "\n";
+        LOG_ERROR("[TextureManager] SDL_LoadBMP failed for %s: %s", path.c_str(), SDL_GetError());
         return nullptr;
     }
 
@@ -50,12 +131,10 @@ SDL_Texture* TextureManager::load(const std::string& path)
 
         // Set the color key on the surface
         if (!SDL_SetSurfaceColorKey(surface, true, colorkey)) {
-             std::cerr << "[TextureManager] Warning: SDL_SetSurfaceColorKey failed: " 
-                       << SDL_GetError() << "\n";
+             LOG_WARN("[TextureManager] SDL_SetSurfaceColorKey failed: %s", SDL_GetError());
         }
     } else {
-        std::cerr << "[TextureManager] Failed to get pixel format details: " 
-                  << SDL_GetError() << "\n";
+        LOG_WARN("[TextureManager] Failed to get pixel format details: %s", SDL_GetError());
     }
     
     // --- FIX ENDS HERE ---
@@ -63,8 +142,7 @@ SDL_Texture* TextureManager::load(const std::string& path)
     // Create texture from the surface (now with color key set)
     SDL_Texture* tex = SDL_CreateTextureFromSurface(m_renderer, surface);
     if (!tex) {
-        std::cerr << "[TextureManager] SDL_CreateTextureFromSurface failed: "
-                  << SDL_GetError() << "\n";
+        LOG_ERROR("[TextureManager] SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
         SDL_DestroySurface(surface);
         return nullptr;
     }
@@ -72,6 +150,10 @@ SDL_Texture* TextureManager::load(const std::string& path)
     // Scale mode: Nearest pixel sampling to keep pixel art sharp
     SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);
 
+    // Frame bounds and, when asked for, a collision mask per animation
+    // frame from the magenta key
+    inspect(tex, surface, frameWidth, frameHeight, wantMask);
+
     // Clean up surface
     SDL_DestroySurface(surface);
 
@@ -91,4 +173,6 @@ void TextureManager::clear()
         }
     }
     m_cache.clear();
+    m_masks.clear();
+    m_sheets.clear();
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "Engine/ThreadPool.hpp"
+
+#include "Engine/Trace.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    m_workers.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; ++i) {
+        m_workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_workers) t.join();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn)
+{
+    if (count == 0) return;
+
+    // not worth waking anyone for
+    if (m_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fn    = &fn;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy  = static_cast<unsigned>(m_workers.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runItems();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_fn = nullptr;
+}
+
+void ThreadPool::runItems()
+{
+    TRACE_ZONE("ThreadPool::job", "engine");
+    for (;;) {
+        const size_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= m_count) break;
+        (*m_fn)(i);
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    trace::setThreadName("worker");
+
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+
+        runItems();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busy == 0) m_done.notify_one();
+        }
+    }
+}
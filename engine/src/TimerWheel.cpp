@@ -0,0 +1,310 @@
+#include "Engine/TimerWheel.hpp"
+
+#include "Engine/Log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+
+namespace timer {
+
+Wheel::Wheel(size_t capacity)
+{
+    m_nodes.reserve(capacity);
+    m_free.reserve(capacity);
+    m_firing.reserve(capacity);
+    std::fill(std::begin(m_heads), std::end(m_heads), NIL);
+}
+
+void Wheel::reset(uint64_t now)
+{
+    for (uint32_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].list != FREE) release(i);
+    }
+    std::fill(std::begin(m_heads), std::end(m_heads), NIL);
+    m_occupied = 0;
+    m_firing.clear();
+    m_now = now;
+}
+
+// ------------------------------------------------------------
+// Lists
+// ------------------------------------------------------------
+
+void Wheel::link(uint32_t node, uint16_t list)
+{
+    Node& n = m_nodes[node];
+    n.list  = list;
+    n.prev  = NIL;
+    n.next  = m_heads[list];
+    if (n.next != NIL) m_nodes[n.next].prev = node;
+    m_heads[list] = node;
+    if (list < SLOTS) m_occupied |= uint64_t{1} << list;
+}
+
+void Wheel::unlink(uint32_t node)
+{
+    Node& n = m_nodes[node];
+    if (n.prev != NIL) {
+        m_nodes[n.prev].next = n.next;
+    } else {
+        m_heads[n.list] = n.next;
+        if (n.list < SLOTS && n.next == NIL) m_occupied &= ~(uint64_t{1} << n.list);
+    }
+    if (n.next != NIL) m_nodes[n.next].prev = n.prev;
+    n.prev = n.next = NIL;
+}
+
+void Wheel::release(uint32_t node)
+{
+    Node& n = m_nodes[node];
+    n.list = FREE;
+    ++n.generation;   // outstanding ids go stale
+    m_free.push_back(node);
+    --m_count;
+}
+
+// The lowest level whose current block holds the tick; a tick past
+// every level's block waits in DISTANT
+void Wheel::place(uint32_t node)
+{
+    const uint64_t tick = m_nodes[node].tick;
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        const unsigned block = SLOT_BITS * (level + 1);
+        if ((tick >> block) == (m_now >> block)) {
+            const unsigned slot = static_cast<unsigned>(tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+            link(node, static_cast<uint16_t>(level * SLOTS + slot));
+            return;
+        }
+    }
+    link(node, DISTANT);
+}
+
+void Wheel::cascade(uint16_t list)
+{
+    uint32_t node = m_heads[list];
+    m_heads[list] = NIL;
+    while (node != NIL) {
+        const uint32_t next = m_nodes[node].next;
+        place(node);
+        node = next;
+    }
+}
+
+// ------------------------------------------------------------
+// Timers
+// ------------------------------------------------------------
+
+bool Wheel::valid(TimerId id) const
+{
+    return id.index < m_nodes.size() && m_nodes[id.index].generation == id.generation &&
+           m_nodes[id.index].list != FREE;
+}
+
+TimerId Wheel::schedule(uint64_t tick, Timer timer)
+{
+    uint32_t index;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    Node& n = m_nodes[index];
+    n.tick  = tick;
+    n.order = m_order++;
+    n.timer = timer;
+    ++m_count;
+
+    if (tick <= m_now) {
+        link(index, OVERDUE);
+    } else {
+        place(index);
+    }
+    return TimerId{index, n.generation};
+}
+
+bool Wheel::cancel(TimerId id)
+{
+    if (!valid(id)) return false;
+    // a timer taken out for firing is only in m_firing, which skips it once freed
+    if (m_nodes[id.index].list != FIRING) unlink(id.index);
+    release(id.index);
+    return true;
+}
+
+bool Wheel::pending(TimerId id) const
+{
+    return valid(id);
+}
+
+uint64_t Wheel::dueTick(TimerId id) const
+{
+    return valid(id) ? m_nodes[id.index].tick : 0;
+}
+
+// ------------------------------------------------------------
+// Advancing
+// ------------------------------------------------------------
+
+uint64_t Wheel::nextTick() const
+{
+    const uint64_t next = m_now + 1;
+    const unsigned slot = static_cast<unsigned>(next) & (SLOTS - 1);
+    if (slot == 0) return next;   // a block starts: cascade
+
+    // level 0 only holds ticks of the current block after m_now
+    const uint64_t ahead = m_occupied >> slot;
+    if (ahead != 0) return next + static_cast<unsigned>(std::countr_zero(ahead));
+    return (next | (SLOTS - 1)) + 1;
+}
+
+bool Wheel::takeOverdue()
+{
+    if (m_heads[OVERDUE] == NIL) return false;
+    for (uint32_t node = m_heads[OVERDUE]; node != NIL; node = m_nodes[node].next) {
+        m_nodes[node].list = FIRING;
+        m_firing.push_back(node);
+    }
+    m_heads[OVERDUE] = NIL;
+    sortFiring();
+    return true;
+}
+
+void Wheel::takeTick(uint64_t tick)
+{
+    m_now = tick;
+
+    // the start of a block at every level it begins, widest first, so
+    // a timer can drop through several levels in one tick
+    if ((tick & (SLOTS - 1)) == 0) {
+        if ((tick & ((uint64_t{1} << (SLOT_BITS * LEVELS)) - 1)) == 0) cascade(DISTANT);
+        for (unsigned level = LEVELS - 1; level > 0; --level) {
+            const unsigned shift = SLOT_BITS * level;
+            if ((tick & ((uint64_t{1} << shift) - 1)) != 0) continue;
+            cascade(static_cast<uint16_t>(level * SLOTS + ((tick >> shift) & (SLOTS - 1))));
+        }
+    }
+
+    const uint16_t slot = static_cast<uint16_t>(tick & (SLOTS - 1));
+    for (uint32_t node = m_heads[slot]; node != NIL; node = m_nodes[node].next) {
+        m_nodes[node].list = FIRING;
+        m_firing.push_back(node);
+    }
+    m_heads[slot] = NIL;
+    m_occupied &= ~(uint64_t{1} << slot);
+    sortFiring();
+}
+
+void Wheel::sortFiring()
+{
+    std::sort(m_firing.begin(), m_firing.end(), [this](uint32_t a, uint32_t b) {
+        const Node& x = m_nodes[a];
+        const Node& y = m_nodes[b];
+        return x.tick != y.tick ? x.tick < y.tick : x.order < y.order;
+    });
+}
+
+void Wheel::list(std::vector<Pending>& out) const
+{
+    out.clear();
+    for (uint32_t i = 0; i < m_nodes.size(); ++i) {
+        const Node& n = m_nodes[i];
+        if (n.list != FREE) out.push_back(Pending{TimerId{i, n.generation}, n.tick, n.timer});
+    }
+    std::sort(out.begin(), out.end(), [this](const Pending& a, const Pending& b) {
+        return a.tick != b.tick ? a.tick < b.tick : m_nodes[a.id.index].order < m_nodes[b.id.index].order;
+    });
+}
+
+// ------------------------------------------------------------
+// Snapshots
+//
+// [now][order][nodeCount][freeCount][timerCount]
+// [generation] per node, [index] per free node, then per timer in
+// node order: [index][tick][order][kind][arg]. Restoring the nodes
+// and free list as they were keeps ids valid and the order of later
+// schedules the same.
+// ------------------------------------------------------------
+
+void Wheel::save(snapshot::Writer& out) const
+{
+    out.put(m_now);
+    out.put(m_order);
+    out.put(static_cast<uint32_t>(m_nodes.size()));
+    out.put(static_cast<uint32_t>(m_free.size()));
+    out.put(static_cast<uint32_t>(m_count));
+
+    for (const Node& n : m_nodes) out.put(n.generation);
+    out.bytes(m_free.data(), m_free.size() * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < m_nodes.size(); ++i) {
+        const Node& n = m_nodes[i];
+        if (n.list == FREE) continue;
+        // field by field: no padding reaches the bytes
+        out.put(i);
+        out.put(n.tick);
+        out.put(n.order);
+        out.put(n.timer.kind);
+        out.put(n.timer.arg);
+    }
+}
+
+bool Wheel::load(snapshot::Reader& in)
+{
+    auto fail = [this] {
+        m_nodes.clear();
+        m_free.clear();
+        m_count = 0;
+        reset(m_now);
+        LOG_ERROR("[Timer] Malformed wheel snapshot");
+        return false;
+    };
+
+    uint64_t now = 0, order = 0;
+    uint32_t nodeCount = 0, freeCount = 0, timerCount = 0;
+    if (!in.get(now) || !in.get(order) || !in.get(nodeCount) || !in.get(freeCount) || !in.get(timerCount)) {
+        return fail();
+    }
+    if (freeCount > nodeCount || timerCount > nodeCount) return fail();
+
+    m_nodes.assign(nodeCount, Node{});
+    for (Node& n : m_nodes) in.get(n.generation);
+    const std::byte* freeIndices = in.take(static_cast<size_t>(freeCount) * sizeof(uint32_t));
+    if (!in.ok()) return fail();
+
+    m_free.resize(freeCount);
+    std::memcpy(m_free.data(), freeIndices, freeCount * sizeof(uint32_t));
+    std::fill(std::begin(m_heads), std::end(m_heads), NIL);
+    m_occupied = 0;
+    m_firing.clear();
+    m_now      = now;
+    m_order    = order;
+    m_count    = 0;
+
+    for (uint32_t t = 0; t < timerCount; ++t) {
+        uint32_t index = 0;
+        in.get(index);
+        if (!in.ok() || index >= nodeCount || m_nodes[index].list != FREE) return fail();
+
+        Node& n = m_nodes[index];
+        in.get(n.tick);
+        in.get(n.order);
+        in.get(n.timer.kind);
+        in.get(n.timer.arg);
+        if (!in.ok()) return fail();
+
+        ++m_count;
+        if (n.tick <= m_now) {
+            link(index, OVERDUE);
+        } else {
+            place(index);
+        }
+    }
+    return true;
+}
+
+} // namespace timer
@@ -0,0 +1,310 @@
+#include "Engine/Trace.hpp"
+#include "Engine/Log.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trace {
+
+namespace detail {
+    std::atomic<bool> g_active{false};
+}
+
+namespace {
+
+    struct Event {
+        const char* name;
+        const char* category;
+        uint64_t    begin;
+        uint64_t    end;
+    };
+
+    // Single producer (the owning thread), single consumer (the writer).
+    // Taken by a thread on its first event; once the thread has exited
+    // and the writer has drained it, it goes back to g_spare for the
+    // next thread.
+    struct ThreadBuffer {
+        static constexpr uint64_t CAPACITY = 1u << 14;
+
+        Event                 events[CAPACITY];
+        std::atomic<uint64_t> head{0};   // written by the owner
+        std::atomic<uint64_t> tail{0};   // written by the writer
+        std::atomic<bool>     retired{false};   // the owner has exited
+        uint32_t              tid = 0;
+        char                  name[32] = {};    // guarded by g_registryMutex
+    };
+
+    const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+    std::mutex                                 g_registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;   // owned by a thread, or retired and not yet drained
+    std::vector<std::unique_ptr<ThreadBuffer>> g_spare;     // drained, waiting for a new thread
+    uint32_t                                   g_nextTid = 1;
+
+    // Trivially destructible, so still readable while the thread exits
+    thread_local ThreadBuffer* t_buffer = nullptr;
+    thread_local bool          t_exited = false;
+    thread_local char          t_name[32] = {};
+
+    // Hands the thread's buffer back when the thread exits
+    struct BufferOwner {
+        ~BufferOwner()
+        {
+            t_exited = true;
+            if (t_buffer) t_buffer->retired.store(true, std::memory_order_release);
+            t_buffer = nullptr;
+        }
+    };
+    thread_local BufferOwner t_owner;
+
+    std::atomic<uint64_t> g_sessionStart{0};
+    std::atomic<uint64_t> g_dropped{0};
+
+    // session state, guarded by g_sessionMutex
+    std::mutex              g_sessionMutex;
+    std::FILE*              g_file = nullptr;
+    bool                    g_firstEvent = true;
+    std::thread             g_writer;
+    std::mutex              g_wakeMutex;
+    std::condition_variable g_wake;
+    bool                    g_stopWriter = false;
+
+    // nullptr once the thread's thread_locals are being destroyed
+    ThreadBuffer* threadBuffer()
+    {
+        if (t_buffer || t_exited) return t_buffer;
+
+        (void)t_owner;   // registers the exit hook
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        std::unique_ptr<ThreadBuffer> buffer;
+        if (!g_spare.empty()) {
+            buffer = std::move(g_spare.back());
+            g_spare.pop_back();
+            buffer->retired.store(false, std::memory_order_relaxed);
+        } else {
+            buffer = std::make_unique<ThreadBuffer>();
+        }
+        buffer->tid = g_nextTid++;
+        std::memcpy(buffer->name, t_name, sizeof(t_name));
+        t_buffer = buffer.get();
+        g_buffers.push_back(std::move(buffer));
+        return t_buffer;
+    }
+
+    // Moves a drained, retired buffer to g_spare. Only the consumer
+    // calls this, so no other reader holds the pointer.
+    void recycle(ThreadBuffer* b)
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (auto it = g_buffers.begin(); it != g_buffers.end(); ++it) {
+            if (it->get() != b) continue;
+            g_spare.push_back(std::move(*it));
+            g_buffers.erase(it);
+            return;
+        }
+    }
+
+    std::vector<ThreadBuffer*> snapshotBuffers()
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        std::vector<ThreadBuffer*> out;
+        out.reserve(g_buffers.size());
+        for (const auto& b : g_buffers) out.push_back(b.get());
+        return out;
+    }
+
+    void writeSeparator()
+    {
+        if (!g_firstEvent) std::fputs(",\n", g_file);
+        g_firstEvent = false;
+    }
+
+    void writeThreadName(ThreadBuffer* b)
+    {
+        char name[sizeof(b->name)];
+        {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            std::memcpy(name, b->name, sizeof(name));
+        }
+        if (name[0] == '\0') return;
+        writeSeparator();
+        std::fprintf(g_file,
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            b->tid, name);
+    }
+
+    // Writer thread side; g_file is only touched by one thread at a time
+    void drain()
+    {
+        const uint64_t sessionStart = g_sessionStart.load(std::memory_order_relaxed);
+
+        for (ThreadBuffer* b : snapshotBuffers()) {
+            // read before head: a retired owner has written its last event
+            const bool     retired = b->retired.load(std::memory_order_acquire);
+            uint64_t       tail    = b->tail.load(std::memory_order_relaxed);
+            const uint64_t head    = b->head.load(std::memory_order_acquire);
+
+            for (; tail != head; ++tail) {
+                const Event& ev = b->events[tail % ThreadBuffer::CAPACITY];
+                if (ev.begin < sessionStart) continue;   // began before start()
+
+                writeSeparator();
+                std::fprintf(g_file,
+                    "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                    ev.name, ev.category,
+                    static_cast<double>(ev.begin - sessionStart) / 1000.0,
+                    static_cast<double>(ev.end - ev.begin) / 1000.0,
+                    b->tid);
+            }
+            b->tail.store(tail, std::memory_order_release);
+
+            if (retired) {
+                // the thread is gone: label it now, the buffer is reused
+                writeThreadName(b);
+                recycle(b);
+            }
+        }
+    }
+
+    // Outside a session nobody drains; events a thread left behind
+    // before exiting are older than any new session, so drop them
+    void recycleRetired()
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (size_t i = 0; i < g_buffers.size();) {
+            ThreadBuffer* b = g_buffers[i].get();
+            if (!b->retired.load(std::memory_order_acquire)) {
+                ++i;
+                continue;
+            }
+            b->tail.store(b->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            g_spare.push_back(std::move(g_buffers[i]));
+            g_buffers[i] = std::move(g_buffers.back());
+            g_buffers.pop_back();
+        }
+    }
+
+    void writerLoop()
+    {
+        std::unique_lock<std::mutex> lock(g_wakeMutex);
+        while (!g_stopWriter) {
+            g_wake.wait_for(lock, std::chrono::milliseconds(20));
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+}
+
+namespace detail {
+
+uint64_t now()
+{
+    // +1 keeps 0 free as the "not recording" marker in Zone
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - g_epoch).count()) + 1;
+}
+
+void record(const char* name, const char* category, uint64_t begin, uint64_t end)
+{
+    ThreadBuffer* b = threadBuffer();
+    if (!b) return;
+
+    const uint64_t head = b->head.load(std::memory_order_relaxed);
+    const uint64_t tail = b->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= ThreadBuffer::CAPACITY) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    b->events[head % ThreadBuffer::CAPACITY] = Event{name, category, begin, end};
+    b->head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+bool start(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(g_sessionMutex);
+    if (g_file) return false;
+
+    g_file = std::fopen(path.c_str(), "wb");
+    if (!g_file) {
+        LOG_ERROR("[Trace] Cannot open %s", path.c_str());
+        return false;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", g_file);
+    recycleRetired();
+    g_firstEvent = true;
+    g_dropped.store(0, std::memory_order_relaxed);
+    g_sessionStart.store(detail::now(), std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> wake(g_wakeMutex);
+        g_stopWriter = false;
+    }
+    g_writer = std::thread(writerLoop);
+
+    detail::g_active.store(true, std::memory_order_relaxed);
+    LOG_INFO("[Trace] Recording to %s", path.c_str());
+    return true;
+}
+
+void stop()
+{
+    std::lock_guard<std::mutex> lock(g_sessionMutex);
+    if (!g_file) return;
+
+    detail::g_active.store(false, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> wake(g_wakeMutex);
+        g_stopWriter = true;
+    }
+    g_wake.notify_one();
+    g_writer.join();
+
+    // whatever landed between the writer's last pass and now
+    drain();
+
+    // threads that exited were labelled when their buffer was recycled
+    for (ThreadBuffer* b : snapshotBuffers()) writeThreadName(b);
+
+    const uint64_t dropped = g_dropped.load(std::memory_order_relaxed);
+    std::fprintf(g_file, "\n],\"otherData\":{\"droppedEvents\":%llu}}\n",
+                 static_cast<unsigned long long>(dropped));
+    std::fclose(g_file);
+    g_file = nullptr;
+
+    if (dropped > 0) LOG_WARN("[Trace] Stopped (%llu events dropped)", static_cast<unsigned long long>(dropped));
+    else             LOG_INFO("[Trace] Stopped");
+}
+
+bool isActive()
+{
+    return detail::g_active.load(std::memory_order_relaxed);
+}
+
+void setThreadName(const char* name)
+{
+    // kept until the thread records its first event
+    std::strncpy(t_name, name, sizeof(t_name) - 1);
+    if (!t_buffer) return;
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    std::memcpy(t_buffer->name, t_name, sizeof(t_name));
+}
+
+uint64_t droppedEvents()
+{
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace trace
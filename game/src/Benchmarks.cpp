@@ -0,0 +1,1843 @@
+#include "Benchmarks.hpp"
+#include "Policies.hpp"
+#include "VecEnv.hpp"
+#include "XenonGame.hpp"
+
+#include "Engine/Audio.hpp"
+#include "Engine/Benchmark.hpp"
+#include "Engine/Bullets.hpp"
+#include "Engine/Capture.hpp"
+#include "Engine/CollisionMask.hpp"
+#include "Engine/Cpu.hpp"
+#include "Engine/Draw.hpp"
+#include "Engine/Engine.hpp"
+#include "Engine/EntitySystem.hpp"
+#include "Engine/Log.hpp"
+#include "Engine/Memory.hpp"
+#include "Engine/Path.hpp"
+#include "Engine/PhysicsScheduler.hpp"
+#include "Engine/RectBatch.hpp"
+#include "Engine/Script.hpp"
+#include "Engine/SharedFrames.hpp"
+#include "Engine/SpatialGrid.hpp"
+#include "Engine/SpriteSheet.hpp"
+#include "Engine/TimerWheel.hpp"
+#include "Engine/Trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Sheet of 'frames' filled circles on a magenta background, like an asteroid strip
+CollisionMask circleSheet(int size, int frames)
+{
+    const int width = size * frames;
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * size * 4);
+    const float r = size * 0.45f;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const float dx = (x % size) - size * 0.5f + 0.5f;
+            const float dy = y - size * 0.5f + 0.5f;
+            const bool solid = dx * dx + dy * dy <= r * r;
+            uint8_t* px = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+            px[0] = solid ? 128 : 255;
+            px[1] = 0;
+            px[2] = solid ? 64 : 255;
+            px[3] = 255;
+        }
+    }
+    return CollisionMask::fromRGBA(pixels.data(), width * 4, width, size, size, size);
+}
+
+// The mixer without a device: the SIMD mix against the one-voice-at-
+// a-time reference on the same command stream, voice stealing, and the
+// cost of a block with every voice busy. Then the same mixer on SDL's
+// dummy driver, which runs the real callback thread headless.
+int benchAudio()
+{
+    constexpr int BLOCK = 512;
+
+    std::mt19937 rng(40);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<std::vector<float>> sounds(8);
+    for (size_t i = 0; i < sounds.size(); ++i) {
+        sounds[i].resize(static_cast<size_t>(audio::Mixer::SAMPLE_RATE) / 2 * (i + 1) + 13 * i);
+        for (float& v : sounds[i]) v = 0.25f * unit(rng);
+    }
+    auto makeMixer = [&]() {
+        auto mixer = std::make_unique<audio::Mixer>();
+        for (const auto& s : sounds) mixer->add(s.data(), s.size());
+        mixer->openOffline();
+        return mixer;
+    };
+
+    // identical commands into a mixer per SIMD level and the scalar
+    // reference; blocks of odd sizes exercise the tails
+    const cpu::Simd widest = cpu::detected();
+    std::vector<std::unique_ptr<audio::Mixer>> levels;
+    for (int level = 0; level <= static_cast<int>(widest); ++level) levels.push_back(makeMixer());
+    audio::Mixer& simd = *levels.back();
+    auto scalar = makeMixer();
+    std::vector<float> a(BLOCK * 2), b(BLOCK * 2);
+    uint64_t mismatches = 0;
+    for (int block = 0; block < 400; ++block) {
+        const int plays = static_cast<int>(rng() % 4);
+        for (int p = 0; p < plays; ++p) {
+            const audio::SoundId id = static_cast<audio::SoundId>(rng() % sounds.size());
+            const float   volume    = 0.5f + 0.5f * unit(rng);
+            const float   pan       = unit(rng);
+            const uint8_t priority  = static_cast<uint8_t>(rng() % 3);
+            for (auto& mixer : levels) mixer->play(id, volume, pan, priority);
+            scalar->play(id, volume, pan, priority);
+        }
+        const int frames = BLOCK - static_cast<int>(rng() % 8);
+        scalar->mixScalar(b.data(), frames);
+        for (size_t level = 0; level < levels.size(); ++level) {
+            cpu::limitSimd(static_cast<cpu::Simd>(level));
+            levels[level]->mix(a.data(), frames);
+            for (int i = 0; i < frames * 2; ++i) {
+                if (std::fabs(a[i] - b[i]) > 1e-6f) ++mismatches;
+            }
+        }
+    }
+    cpu::limitSimd(widest);
+    const audio::MixerStats mixed = simd.stats();
+    std::printf("%-40s %10" PRIu64 " voices stolen, %" PRIu64 " mismatches (scalar to %s)\n", "audio mix vs scalar",
+                mixed.voicesStolen, mismatches, cpu::simdName(widest));
+    if (mismatches > 0) {
+        LOG_ERROR("[Bench] SIMD audio mix differs from the scalar mix");
+        return 1;
+    }
+
+    // a full house of priority 1: priority 0 is turned away, priority 2 steals
+    auto stealing = makeMixer();
+    for (int i = 0; i < audio::Mixer::MAX_VOICES; ++i) stealing->play(7, 1.0f, 0.0f, 1);
+    stealing->mix(a.data(), BLOCK);
+    stealing->play(0, 1.0f, 0.0f, 0);
+    stealing->mix(a.data(), BLOCK);
+    stealing->play(0, 1.0f, 0.0f, 2);
+    stealing->mix(a.data(), BLOCK);
+    const audio::MixerStats stolen = stealing->stats();
+    std::printf("%-40s %10" PRIu64 " stolen, %" PRIu64 " turned away, %d active\n", "audio voice stealing",
+                stolen.voicesStolen, stolen.soundsDropped, stolen.activeVoices);
+    if (stolen.voicesStolen != 1 || stolen.soundsDropped != 1 || stolen.activeVoices != audio::Mixer::MAX_VOICES) {
+        LOG_ERROR("[Bench] audio voice stealing is wrong");
+        return 1;
+    }
+
+    // every voice busy for the whole timed run
+    auto busy = makeMixer(), busyScalar = makeMixer();
+    for (int i = 0; i < audio::Mixer::MAX_VOICES; ++i) {
+        busy->play(7, 0.5f, 0.0f, 0);
+        busyScalar->play(7, 0.5f, 0.0f, 0);
+    }
+    const double mixNs    = bench::nsPerOp(100, [&](uint64_t) { busy->mix(a.data(), BLOCK); });
+    const double scalarNs = bench::nsPerOp(100, [&](uint64_t) { busyScalar->mixScalar(b.data(), BLOCK); });
+    bench::report("audio mix 512 frames x 32 voices", mixNs);
+    bench::report("audio mix 512 frames x 32 voices scalar", scalarNs);
+    std::printf("%-40s %10.2f %% of the block's play time\n", "audio mix load",
+                mixNs / (1.0e9 * BLOCK / audio::Mixer::SAMPLE_RATE) * 100.0);
+    bench::keep(static_cast<uint64_t>(a[0] * 1000.0f + b[0] * 1000.0f));
+
+    // the real path, headless
+    SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+    if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+        std::printf("%-40s %10s (%s)\n", "audio dummy device", "skipped", SDL_GetError());
+        return 0;
+    }
+    int result = 0;
+    {
+        audio::Mixer device;
+        for (const auto& s : sounds) device.add(s.data(), s.size());
+        if (device.open()) {
+            for (int i = 0; i < 200; ++i) device.play(static_cast<audio::SoundId>(i % sounds.size()), 0.5f, 0.0f, 0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            const audio::MixerStats s = device.stats();
+            std::printf("%-40s %10" PRIu64 " callbacks, %.1f us average, %.1f us max, %" PRIu64 " dropped\n",
+                        "audio dummy device", s.callbacks, s.averageUs, s.maxUs, s.commandsDropped);
+            if (s.callbacks == 0) {
+                LOG_ERROR("[Bench] the audio callback never ran on the dummy driver");
+                result = 1;
+            }
+        } else {
+            std::printf("%-40s %10s\n", "audio dummy device", "skipped");
+        }
+    }
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    return result;
+}
+
+// A full bullet pool: spirals, aimed fans and splitting rings kept at
+// the 20k cap over an 800x600 field. Replaying from a snapshot must
+// give the same bytes; then the per-tick simulation is timed against a
+// budget, and the software renderer draws the pool in one call.
+int benchBullets()
+{
+    constexpr double BUDGET_MS = 2.0;   // an eighth of a 60 Hz frame
+
+    bullet::BulletSystem bullets(20000);
+    bullet::Pattern spiral;
+    spiral.count    = 9;
+    spiral.speed    = 30.0f;
+    spiral.spin     = 7.0f;
+    spiral.interval = 1;
+    spiral.volleys  = 0;
+    const bullet::PatternId spiralId = bullets.define(spiral);
+
+    bullet::Pattern fan;
+    fan.shape    = bullet::Shape::Fan;
+    fan.aimed    = true;
+    fan.count    = 7;
+    fan.speed    = 60.0f;
+    fan.interval = 10;
+    fan.volleys  = 0;
+    const bullet::PatternId fanId = bullets.define(fan);
+
+    bullet::Pattern shard;
+    shard.count = 6;
+    shard.speed = 25.0f;
+    bullet::Pattern splitter;
+    splitter.count      = 8;
+    splitter.speed      = 50.0f;
+    splitter.interval   = 30;
+    splitter.volleys    = 0;
+    splitter.child      = bullets.define(shard);
+    splitter.childDelay = 90;
+    const bullet::PatternId splitterId = bullets.define(splitter);
+
+    for (int i = 0; i < 4; ++i) bullets.start(spiralId, 160.0f + 160.0f * i, 150.0f + 100.0f * (i % 2), 0);
+    bullets.start(fanId, 400.0f, 60.0f, 0);
+    bullets.start(splitterId, 400.0f, 300.0f, 0);
+
+    const SDL_FRect bounds{-32.0f, -32.0f, 864.0f, 664.0f};
+    uint64_t now  = 0;
+    uint64_t hits = 0;
+    auto step = [&]() {
+        const SDL_FPoint ship{400.0f + 300.0f * std::sin(now * 0.02f), 540.0f};
+        bullets.update(Engine::s_fixedTimeStep, now, ship, bounds);
+        hits += bullets.collide(SDL_FRect{ship.x - 12.0f, ship.y - 12.0f, 24.0f, 24.0f});
+        ++now;
+    };
+    while (now < 1200) step();
+
+    // same state, same ticks: same bytes
+    snapshot::Buffer start, first, second;
+    snapshot::Writer startOut(start);
+    bullets.save(startOut);
+    const uint64_t startTick = now;
+    for (int i = 0; i < 120; ++i) step();
+    snapshot::Writer firstOut(first);
+    bullets.save(firstOut);
+
+    snapshot::Reader in(start.data(), start.size());
+    const bool loaded = bullets.load(in) && in.finished();
+    now = startTick;
+    for (int i = 0; i < 120; ++i) step();
+    snapshot::Writer secondOut(second);
+    bullets.save(secondOut);
+
+    std::printf("%-40s %10zu bullets, %zu emitters, replay %s\n", "bullet pool", bullets.size(),
+                bullets.emitterCount(), loaded && first == second ? "identical" : "DIFFERENT");
+    if (!loaded || first != second) {
+        LOG_ERROR("[Bench] bullet replay from a snapshot diverged");
+        return 1;
+    }
+
+    const double tickNs = bench::nsPerOp(600, [&](uint64_t) { step(); });
+    bench::report("bullets per tick (update + collide)", tickNs);
+    bench::report("bullets per bullet", tickNs / static_cast<double>(bullets.size()));
+    bench::keep(hits);
+
+    SDL_Surface* target = SDL_CreateSurface(800, 600, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Surface* image  = SDL_CreateSurface(8, 8, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (renderer && image) {
+        SDL_FillSurfaceRect(image, nullptr, 0xFFFFFFFFu);
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, image);
+        draw::resetCounters();
+        const double renderNs = bench::nsPerOp(20, [&](uint64_t) {
+            bullets.render(renderer, texture, SDL_FRect{0.0f, 0.0f, 8.0f, 8.0f});
+        });
+        std::printf("%-40s %10" PRIu64 " draw calls for 20 frames\n", "bullet render (software)", draw::counters().drawCalls);
+        bench::report("bullet render per frame", renderNs);
+        SDL_DestroyTexture(texture);
+    }
+    if (renderer) SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(image);
+    SDL_DestroySurface(target);
+
+    if (tickNs / 1.0e6 > BUDGET_MS) {
+        LOG_ERROR("[Bench] bullet simulation over budget: %.3f ms per tick (budget %.1f ms)", tickNs / 1.0e6, BUDGET_MS);
+        return 1;
+    }
+    return 0;
+}
+
+// RGBA -> I420: the SIMD conversion against the scalar reference on
+// random images, odd sizes and row padding included, then its cost on
+// a full frame. Then 240 frames pushed at capture::Recorder as fast as
+// it takes them: every frame is written or dropped, the file holds
+// exactly the written ones, and capturing one costs the frame thread
+// only a copy.
+int benchCapture()
+{
+    std::mt19937 rng{47};
+    const int sizes[][2] = {{1, 1}, {2, 2}, {3, 5}, {17, 3}, {31, 33}, {64, 64}, {801, 599}};
+    uint64_t mismatches = 0;
+    for (const auto& size : sizes) {
+        const int    w = size[0], h = size[1];
+        const size_t pitch = static_cast<size_t>(w) * 4 + 12;
+        std::vector<uint8_t> rgba(pitch * h);
+        for (uint8_t& b : rgba) b = static_cast<uint8_t>(rng());
+
+        const size_t planeBytes = static_cast<size_t>(w) * h + 2 * static_cast<size_t>((w + 1) / 2) * ((h + 1) / 2);
+        std::vector<uint8_t> fast(planeBytes), ref(planeBytes);
+        const size_t chroma = (planeBytes - static_cast<size_t>(w) * h) / 2;
+        capture::rgbaToI420(rgba.data(), pitch, w, h, fast.data(), fast.data() + w * h, fast.data() + w * h + chroma);
+        capture::rgbaToI420Scalar(rgba.data(), pitch, w, h, ref.data(), ref.data() + w * h, ref.data() + w * h + chroma);
+        for (size_t i = 0; i < planeBytes; ++i) mismatches += fast[i] != ref[i];
+    }
+
+    // white and black land on the ends of the limited range
+    const uint8_t white[4] = {255, 255, 255, 255}, black[4] = {0, 0, 0, 255};
+    uint8_t wy, wu, wv, by, bu, bv;
+    capture::rgbaToI420(white, 4, 1, 1, &wy, &wu, &wv);
+    capture::rgbaToI420(black, 4, 1, 1, &by, &bu, &bv);
+    const bool range = wy == 235 && by == 16 && wu == 128 && wv == 128 && bu == 128 && bv == 128;
+
+    std::printf("%-40s %10" PRIu64 " mismatches, range %s\n", "rgba->i420 simd vs scalar", mismatches, range ? "ok" : "WRONG");
+    if (mismatches > 0 || !range) {
+        LOG_ERROR("[Bench] RGBA to I420 conversion disagrees with the reference");
+        return 1;
+    }
+
+    const int w = 800, h = 600;
+    std::vector<uint8_t> frame(static_cast<size_t>(w) * h * 4);
+    for (uint8_t& b : frame) b = static_cast<uint8_t>(rng());
+    std::vector<uint8_t> planes(static_cast<size_t>(w) * h * 3 / 2);
+    uint8_t* y = planes.data();
+    const double simdNs = bench::nsPerOp(50, [&](uint64_t) {
+        capture::rgbaToI420(frame.data(), w * 4, w, h, y, y + w * h, y + w * h * 5 / 4);
+        bench::keep(planes[0]);
+    });
+    const double scalarNs = bench::nsPerOp(50, [&](uint64_t) {
+        capture::rgbaToI420Scalar(frame.data(), w * 4, w, h, y, y + w * h, y + w * h * 5 / 4);
+        bench::keep(planes[0]);
+    });
+    bench::report("rgba->i420 800x600 (simd)", simdNs);
+    bench::report("rgba->i420 800x600 (scalar)", scalarNs);
+
+    SDL_Surface* surface = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) return 1;
+    for (int row = 0; row < h; ++row) {
+        std::memcpy(static_cast<uint8_t*>(surface->pixels) + row * surface->pitch, frame.data() + row * w * 4, w * 4);
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "xenon_bench_capture.y4m").string();
+    capture::CaptureConfig config;
+    config.path = path;
+    capture::Recorder recorder;
+    if (!recorder.start(config, w, h)) {
+        SDL_DestroySurface(surface);
+        return 1;
+    }
+    const uint64_t frames = 240;
+    const double captureNs = bench::nsPerOp(frames, [&](uint64_t) { recorder.captureSurface(surface); });
+    recorder.stop();
+    SDL_DestroySurface(surface);
+
+    const capture::CaptureStats stats = recorder.stats();
+    std::error_code ec;
+    const uintmax_t fileBytes = std::filesystem::file_size(path, ec);
+    std::filesystem::remove(path, ec);
+
+    const uintmax_t header   = std::string("YUV4MPEG2 W800 H600 F60:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n").size();
+    const uintmax_t expected = header + stats.written * (6 + planes.size());
+    const bool accounted = stats.written + stats.dropped == frames && stats.captured == stats.written;
+    std::printf("%-40s %10" PRIu64 " written, %" PRIu64 " dropped, file %s\n", "capture 240 frames flat out",
+                stats.written, stats.dropped, fileBytes == expected ? "complete" : "WRONG SIZE");
+    bench::report("capture per frame (frame thread)", captureNs);
+
+    if (!accounted || fileBytes != expected || stats.written == 0) {
+        LOG_ERROR("[Bench] capture lost or mangled frames");
+        return 1;
+    }
+    return 0;
+}
+
+// Narrow-phase cost per candidate pair. Positions are drawn so the
+// AABBs always overlap, which is the only case that reaches masksOverlap.
+int benchCollisionMask()
+{
+    const CollisionMask ship     = circleSheet(64, 7);
+    const CollisionMask asteroid = circleSheet(96, 16);
+    const CollisionMask boss     = circleSheet(128, 1);
+
+    struct Pair { const CollisionMask* other; int frame; int x; int y; };
+    std::mt19937 rng{1234};
+    std::vector<Pair> pairs(4096);
+    for (auto& p : pairs) {
+        p.other = (rng() & 1) ? &asteroid : &boss;
+        p.frame = static_cast<int>(rng() % p.other->frameCount());
+        p.x = static_cast<int>(rng() % (64 + p.other->frameWidth())) - p.other->frameWidth();
+        p.y = static_cast<int>(rng() % (64 + p.other->frameHeight())) - p.other->frameHeight();
+    }
+
+    // every kernel this CPU runs against the scalar reference, for
+    // every ship frame over every pair
+    const cpu::Simd widest = cpu::detected();
+    uint64_t checked = 0, hits = 0, mismatches = 0;
+    for (int level = 0; level <= static_cast<int>(widest); ++level) {
+        cpu::limitSimd(static_cast<cpu::Simd>(level));
+        for (int frame = 0; frame < ship.frameCount(); ++frame) {
+            for (const Pair& p : pairs) {
+                const bool hit      = masksOverlap(ship, frame, 0, 0, *p.other, p.frame, p.x, p.y);
+                const bool expected = masksOverlapScalar(ship, frame, 0, 0, *p.other, p.frame, p.x, p.y);
+                mismatches += hit != expected;
+                hits       += expected;
+                ++checked;
+            }
+        }
+    }
+    cpu::limitSimd(widest);
+    std::printf("%-40s %10" PRIu64 " pairs, %" PRIu64 " hits, %" PRIu64 " mismatches (scalar to %s)\n",
+                "collision-mask vs scalar", checked, hits, mismatches, cpu::simdName(widest));
+    if (mismatches > 0) {
+        LOG_ERROR("[Bench] collision-mask kernels disagree with the scalar reference");
+        return 1;
+    }
+
+    const uint64_t iterations = 2'000'000;
+    auto run = [&](bool simd) {
+        return bench::nsPerOp(iterations, [&](uint64_t i) {
+            const Pair& p = pairs[i & (pairs.size() - 1)];
+            const bool hit = simd ? masksOverlap(ship, 3, 0, 0, *p.other, p.frame, p.x, p.y)
+                                  : masksOverlapScalar(ship, 3, 0, 0, *p.other, p.frame, p.x, p.y);
+            bench::keep(hit);
+        });
+    };
+
+    const double simdNs   = run(true);
+    const double scalarNs = run(false);
+    bench::report((std::string("collision-mask pair (") + cpu::simdName(widest) + ")").c_str(), simdNs);
+    bench::report("collision-mask pair (scalar)", scalarNs);
+
+    // budget: well under a microsecond per candidate pair
+    if (simdNs > 250.0) {
+        LOG_ERROR("[Bench] collision-mask over budget (250 ns)");
+        return 1;
+    }
+    return 0;
+}
+
+// Movement and culling over 10k entities in three archetypes, three
+// ways: per-entity each() callbacks, hand-written chunk loops, and
+// EntitySystems built from the game's policies. All three must leave
+// byte-identical worlds, and the generated loops must be at least as
+// fast as the hand-written ones, within 3% of timer noise on the
+// median of 1000 side-by-side steps.
+int benchEntitySystem()
+{
+    constexpr int    ENTITIES = 10000;
+    constexpr int    ROUNDS   = 1000;
+    constexpr double NOISE    = 1.03;
+
+    auto populate = [](ecs::World& world, bool leaving) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        CullBounds bounds;
+        if (leaving) bounds = CullBounds{-100.0f, -100.0f, 900.0f, 700.0f};
+        for (int i = 0; i < ENTITIES; ++i) {
+            const Transform t{{400.0f + 300.0f * unit(rng), 300.0f + 200.0f * unit(rng), 16.0f, 16.0f}};
+            const Velocity  v{200.0f * unit(rng), 200.0f * unit(rng)};
+            switch (i % 3) {
+            case 0:  world.create(t, v, bounds, MissileTag{}); break;
+            case 1:  world.create(t, v, bounds, EnemyProjectileTag{}); break;
+            default: world.create(t, v, bounds, AsteroidTag{}); break;
+            }
+        }
+    };
+
+    constexpr float DT = Engine::s_fixedTimeStep;
+
+    // as the game used to do it: a callback per entity
+    struct Callbacks {
+        ecs::World& world;
+        ecs::Query<Transform, const Velocity>         movers{world};
+        ecs::Query<const Transform, const CullBounds> culled{world};
+
+        void step()
+        {
+            movers.each([](ecs::Entity, Transform& t, const Velocity& v) {
+                t.rect.x += v.x * DT;
+                t.rect.y += v.y * DT;
+            });
+            culled.each([this](ecs::Entity e, const Transform& t, const CullBounds& b) {
+                const SDL_FRect& r = t.rect;
+                if (r.x < b.minX || r.x > b.maxX || r.y + r.h < b.minY || r.y > b.maxY) world.destroyDeferred(e);
+            });
+            world.flush();
+        }
+    };
+
+    // written out per chunk by hand
+    struct HandWritten {
+        ecs::World& world;
+        ecs::Query<Transform, const Velocity>         movers{world};
+        ecs::Query<const Transform, const CullBounds> culled{world};
+
+        void step()
+        {
+            movers.eachChunk([](uint32_t n, const ecs::Entity*, Transform* t, const Velocity* v) {
+                for (uint32_t i = 0; i < n; ++i) {
+                    t[i].rect.x += v[i].x * DT;
+                    t[i].rect.y += v[i].y * DT;
+                }
+            });
+            culled.eachChunk([this](uint32_t n, const ecs::Entity* e, const Transform* t, const CullBounds* b) {
+                for (uint32_t i = 0; i < n; ++i) {
+                    const SDL_FRect& r = t[i].rect;
+                    if (r.x < b[i].minX || r.x > b[i].maxX || r.y + r.h < b[i].minY || r.y > b[i].maxY) {
+                        world.destroyDeferred(e[i]);
+                    }
+                }
+            });
+            world.flush();
+        }
+    };
+
+    // the game's systems
+    struct Generated {
+        ecs::World& world;
+        ecs::EntitySystem<ecs::Components<Transform, const Velocity>, Integrate>           movement{world, Integrate{}};
+        ecs::EntitySystem<ecs::Components<const Transform, const CullBounds>, CullOutside> culling{world, CullOutside{&world}};
+
+        void step()
+        {
+            movement.run(DT);
+            culling.run(DT);
+            world.flush();
+        }
+    };
+
+    // 300 ticks with entities leaving the field: same worlds at the end
+    ecs::World worlds[3];
+    for (ecs::World& w : worlds) populate(w, true);
+    Callbacks   callbacks{worlds[0]};
+    HandWritten handWritten{worlds[1]};
+    Generated   generated{worlds[2]};
+    for (int i = 0; i < 300; ++i) {
+        callbacks.step();
+        handWritten.step();
+        generated.step();
+    }
+    snapshot::Buffer saved[3];
+    for (int i = 0; i < 3; ++i) {
+        snapshot::Writer out(saved[i]);
+        worlds[i].save(out);
+    }
+    const bool same = saved[0] == saved[1] && saved[1] == saved[2];
+    std::printf("%-40s %10zu entities left, %s\n", "entity systems after 300 ticks",
+                worlds[2].entityCount(), same ? "identical" : "DIFFERENT");
+    if (!same) {
+        LOG_ERROR("[Bench] generated entity systems changed the simulation");
+        return 1;
+    }
+
+    // steady state: nothing leaves, so only the loops are measured, all
+    // on the same world so they walk the same chunks
+    ecs::World timed;
+    populate(timed, false);
+    Callbacks   callbacksTimed{timed};
+    HandWritten handWrittenTimed{timed};
+    Generated   generatedTimed{timed};
+
+    // fastest step of each for the report; the gate compares each
+    // generated step with the hand-written step next to it, taking
+    // turns at going first, so bursts of machine noise hit both
+    double callbackNs = 1e30, handNs = 1e30, generatedNs = 1e30;
+    std::vector<double> ratios;
+    ratios.reserve(ROUNDS);
+    for (int round = 0; round < ROUNDS; ++round) {
+        callbackNs = std::min(callbackNs, bench::nsPerOp(1, [&](uint64_t) { callbacksTimed.step(); }));
+        double hand = 0.0, gen = 0.0;
+        if (round % 2 == 0) {
+            hand = bench::nsPerOp(1, [&](uint64_t) { handWrittenTimed.step(); });
+            gen  = bench::nsPerOp(1, [&](uint64_t) { generatedTimed.step(); });
+        } else {
+            gen  = bench::nsPerOp(1, [&](uint64_t) { generatedTimed.step(); });
+            hand = bench::nsPerOp(1, [&](uint64_t) { handWrittenTimed.step(); });
+        }
+        handNs      = std::min(handNs, hand);
+        generatedNs = std::min(generatedNs, gen);
+        ratios.push_back(gen / hand);
+    }
+    std::nth_element(ratios.begin(), ratios.begin() + ratios.size() / 2, ratios.end());
+    const double ratio = ratios[ratios.size() / 2];
+
+    bench::report("move + cull 10k, each() callbacks", callbackNs);
+    bench::report("move + cull 10k, hand-written chunks", handNs);
+    bench::report("move + cull 10k, EntitySystem", generatedNs);
+    std::printf("%-40s %10.3f\n", "EntitySystem / hand-written (median)", ratio);
+
+    if (ratio > NOISE) {
+        LOG_ERROR("[Bench] EntitySystem loops slower than hand-written: %.1f%% over", (ratio - 1.0) * 100.0);
+        return 1;
+    }
+    return 0;
+}
+
+// Randomized agreement check of the batched box test against
+// SDL_HasRectIntersectionFloat, then its cost next to per-pair SDL calls.
+// Coordinates are small integers most of the time so edges and corners
+// touch often; zero, negative, infinite and NaN sizes are mixed in.
+int benchRectBatch()
+{
+    std::mt19937 rng{42};
+    auto value = [&rng](bool size) {
+        switch (rng() % 24) {
+        case 0:  return std::nanf("");
+        case 1:  return -0.0f;
+        case 2:  return INFINITY;
+        case 3:  return size ? -1.0f : -INFINITY;
+        case 4:  return 0.0f;
+        default: break;
+        }
+        if (rng() % 2) return static_cast<float>(rng() % 16);
+        return std::uniform_real_distribution<float>(-4.0f, 20.0f)(rng);
+    };
+    auto randomRect = [&value]() { return SDL_FRect{value(false), value(false), value(true), value(true)}; };
+
+    RectBatch batch;
+    std::vector<SDL_FRect> rects;
+    std::vector<uint64_t> hits;
+    uint64_t checked = 0, mismatches = 0;
+
+    // every kernel this CPU runs, each against SDL on the same rects
+    const cpu::Simd widest = cpu::detected();
+    for (int round = 0; round < 20000; ++round) {
+        const size_t n = rng() % 200;
+        batch.clear();
+        rects.clear();
+        for (size_t i = 0; i < n; ++i) {
+            rects.push_back(randomRect());
+            batch.push(rects.back());
+        }
+
+        const SDL_FRect a = randomRect();
+        for (int level = 0; level <= static_cast<int>(widest); ++level) {
+            cpu::limitSimd(static_cast<cpu::Simd>(level));
+            batch.overlaps(a, hits);
+            for (size_t i = 0; i < n; ++i) {
+                const bool expected = SDL_HasRectIntersectionFloat(&a, &rects[i]);
+                const bool simd     = (hits[i / 64] >> (i % 64)) & 1;
+                const bool inlined  = rectsIntersect(a, rects[i]);
+                if (simd != expected || inlined != expected) ++mismatches;
+                ++checked;
+            }
+        }
+    }
+    cpu::limitSimd(widest);
+    std::printf("%-40s %10" PRIu64 " pairs, %" PRIu64 " mismatches (scalar to %s)\n", "rect-batch vs SDL", checked,
+                mismatches, cpu::simdName(widest));
+    if (mismatches > 0) {
+        LOG_ERROR("[Bench] rect-batch disagrees with SDL_HasRectIntersectionFloat");
+        return 1;
+    }
+
+    // timing: one ship-sized rect against a screenful of targets
+    std::uniform_real_distribution<float> pos(0.0f, 800.0f);
+    batch.clear();
+    rects.clear();
+    for (int i = 0; i < 1024; ++i) {
+        rects.push_back(SDL_FRect{pos(rng), pos(rng), 32.0f, 32.0f});
+        batch.push(rects.back());
+    }
+    const SDL_FRect ship{400.0f, 400.0f, 64.0f, 64.0f};
+    const uint64_t iterations = 20000;
+
+    for (int level = static_cast<int>(widest); level >= 0; --level) {
+        cpu::limitSimd(static_cast<cpu::Simd>(level));
+        const double batchNs = bench::nsPerOp(iterations, [&](uint64_t) {
+            batch.overlaps(ship, hits);
+            bench::keep(hits[0]);
+        }) / rects.size();
+        bench::report((std::string("rect-batch per rect (") + cpu::simdName(cpu::simd()) + ")").c_str(), batchNs);
+    }
+    cpu::limitSimd(widest);
+    const double sdlNs = bench::nsPerOp(iterations, [&](uint64_t) {
+        uint64_t count = 0;
+        for (const SDL_FRect& r : rects) count += SDL_HasRectIntersectionFloat(&ship, &r);
+        bench::keep(count);
+    }) / rects.size();
+
+    bench::report("SDL_HasRectIntersectionFloat per rect", sdlNs);
+    return 0;
+}
+
+// Batched path evaluation for 10k followers spread over several curves
+// and start ticks, checked against the one-at-a-time lookup and timed
+// next to it.
+int benchPaths()
+{
+    path::PathLibrary paths;
+    const SDL_FPoint dive[] = {{0.0f, 0.0f}, {0.0f, 180.0f}, {60.0f, 380.0f}, {-40.0f, 560.0f}, {0.0f, 800.0f}};
+    const path::PathId ids[] = {
+        paths.sineSweep(1000.0f, 200.0f, 40.0f, 2.0f, 600),
+        paths.sineSweep(-1000.0f, 200.0f, 40.0f, 2.0f, 600),
+        paths.spline(dive, std::size(dive), 156),
+        paths.spline(dive, std::size(dive), 240, true),
+        paths.line(0.0f, 900.0f, 180),
+    };
+
+    std::mt19937 rng{5};
+    std::vector<path::Follower> followers(10000);
+    for (path::Follower& f : followers) {
+        f.originX   = static_cast<float>(rng() % 800);
+        f.originY   = static_cast<float>(rng() % 600);
+        f.startTick = 1000 + rng() % 1200;   // some not started yet
+        f.path      = ids[rng() % std::size(ids)];
+    }
+
+    std::vector<SDL_FPoint> out(followers.size());
+    uint64_t mismatches = 0;
+    for (uint64_t now = 900; now < 3000; now += 7) {
+        paths.evaluate(followers.size(), followers.data(), now, out.data());
+        for (size_t i = 0; i < followers.size(); ++i) {
+            const SDL_FPoint ref = paths.position(followers[i], now);
+            if (ref.x != out[i].x || ref.y != out[i].y) ++mismatches;
+        }
+    }
+    std::printf("%-40s %10zu samples, %" PRIu64 " mismatches\n", "paths batched vs single", paths.sampleCount(), mismatches);
+    if (mismatches > 0) {
+        LOG_ERROR("[Bench] batched path evaluation disagrees with PathLibrary::position");
+        return 1;
+    }
+
+    const uint64_t iterations = 2000;
+    const double batchNs = bench::nsPerOp(iterations, [&](uint64_t i) {
+        paths.evaluate(followers.size(), followers.data(), 1500 + i, out.data());
+        bench::keep(static_cast<uint64_t>(out[i % out.size()].x));
+    }) / followers.size();
+    const double singleNs = bench::nsPerOp(iterations, [&](uint64_t i) {
+        for (size_t k = 0; k < followers.size(); ++k) out[k] = paths.position(followers[k], 1500 + i);
+        bench::keep(static_cast<uint64_t>(out[i % out.size()].x));
+    }) / followers.size();
+
+    bench::report("path follower (batched)", batchNs);
+    bench::report("path follower (one at a time)", singleNs);
+    return 0;
+}
+
+// Physics scheduling: the catch-up cap, skipped steps in an empty and
+// in a sleeping world, the substep policy, then 800 boxes bouncing in
+// a walled arena stepped inline and on the worker next to a fixed
+// amount of game work per frame. Both runs must end bit-identical.
+int benchPhysics()
+{
+    int failures = 0;
+
+    physics::Scheduler capped;
+    const int burst = capped.advance(1.0f);
+    std::printf("%-40s %10d steps, %" PRIu64 " dropped\n", "physics after a 1 s stall", burst, capped.droppedSteps());
+    if (burst != capped.config().maxStepsPerFrame) ++failures;
+
+    auto makeWorld = [](int boxes, bool moving) {
+        b2WorldDef def = b2DefaultWorldDef();
+        def.gravity = b2Vec2{0.0f, 0.0f};
+        const b2WorldId world = b2CreateWorld(&def);
+
+        const b2ShapeDef shape = b2DefaultShapeDef();
+        const b2Vec2 walls[] = {{0.0f, -41.0f}, {0.0f, 41.0f}, {-41.0f, 0.0f}, {41.0f, 0.0f}};
+        for (int i = 0; i < 4; ++i) {
+            b2BodyDef body = b2DefaultBodyDef();
+            body.position = walls[i];
+            const b2Polygon wall = i < 2 ? b2MakeBox(42.0f, 1.0f) : b2MakeBox(1.0f, 42.0f);
+            b2CreatePolygonShape(b2CreateBody(world, &body), &shape, &wall);
+        }
+
+        std::mt19937 rng(41);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        const b2Polygon box = b2MakeBox(0.4f, 0.4f);
+        for (int i = 0; i < boxes; ++i) {
+            b2BodyDef body = b2DefaultBodyDef();
+            body.type     = b2_dynamicBody;
+            body.position = b2Vec2{-38.0f + 2.0f * (i % 39), -38.0f + 2.0f * (i / 39)};
+            if (moving) body.linearVelocity = b2Vec2{20.0f * unit(rng), 20.0f * unit(rng)};
+            b2CreatePolygonShape(b2CreateBody(world, &body), &shape, &box);
+        }
+        return world;
+    };
+
+    // nothing to step: empty, then resting boxes once they fall asleep
+    physics::Scheduler scheduler;
+    const b2WorldId empty = makeWorld(0, false);
+    scheduler.setWorld(empty);
+    scheduler.step(60);
+    const physics::StepReport emptyReport = scheduler.report();
+    b2DestroyWorld(empty);
+
+    const b2WorldId resting = makeWorld(200, false);
+    scheduler.setWorld(resting);
+    scheduler.step(120);
+    const physics::StepReport restingReport = scheduler.report();
+    b2DestroyWorld(resting);
+
+    std::printf("%-40s %10d run, %d skipped\n", "physics empty world, 60 steps", emptyReport.steps, emptyReport.skipped);
+    std::printf("%-40s %10d run, %d skipped\n", "physics resting boxes, 120 steps", restingReport.steps, restingReport.skipped);
+    if (emptyReport.steps != 0 || restingReport.skipped == 0) ++failures;
+
+    std::printf("%-40s %10d / %d / %d substeps\n", "physics idle / fast / crowd",
+                scheduler.subStepsFor(10, 0.0f), scheduler.subStepsFor(10, 100.0f), scheduler.subStepsFor(20000, 0.0f));
+
+    // a frame: ~1 ms of stand-in game logic plus one fixed step
+    auto gameWork = []() {
+        uint64_t h = 1469598103934665603ull;
+        for (int i = 0; i < 200000; ++i) h = (h ^ static_cast<uint64_t>(i)) * 1099511628211ull;
+        bench::keep(h);
+    };
+    auto run = [&](bool async, std::vector<b2Vec2>& positions, double& physicsMs) {
+        physics::Scheduler s;
+        const b2WorldId world = makeWorld(800, true);
+        s.setWorld(world);
+        s.setAsync(async);
+        physicsMs = 0.0;
+
+        const double frameNs = bench::nsPerOp(300, [&](uint64_t) {
+            s.sync();
+            physicsMs += s.report().ms;
+            const int steps = s.advance(Engine::s_fixedTimeStep);
+            if (!async) {
+                s.step(steps);
+                physicsMs += s.report().ms;
+            }
+            gameWork();
+            if (async) s.launch(steps);
+        });
+        s.sync();
+        physicsMs += async ? s.report().ms : 0.0;
+
+        positions.clear();
+        const b2BodyEvents events = b2World_GetBodyEvents(world);
+        for (int i = 0; i < events.moveCount; ++i) positions.push_back(events.moveEvents[i].transform.p);
+        s.setAsync(false);
+        b2DestroyWorld(world);
+        return frameNs;
+    };
+
+    std::vector<b2Vec2> inlinePositions, asyncPositions;
+    double inlinePhysicsMs = 0.0, asyncPhysicsMs = 0.0;
+    const double inlineNs = run(false, inlinePositions, inlinePhysicsMs);
+    const double asyncNs  = run(true, asyncPositions, asyncPhysicsMs);
+    const bool same = inlinePositions.size() == asyncPositions.size() &&
+                      std::memcmp(inlinePositions.data(), asyncPositions.data(),
+                                  inlinePositions.size() * sizeof(b2Vec2)) == 0;
+
+    bench::report("physics frame, inline step", inlineNs);
+    bench::report("physics frame, async step", asyncNs);
+    std::printf("%-40s %10.3f ms per step, %zu bodies moved, %s\n", "physics 800 boxes",
+                inlinePhysicsMs / 300.0, inlinePositions.size(), same ? "identical" : "DIFFERENT");
+    if (!same) ++failures;
+
+    if (failures > 0) {
+        LOG_ERROR("[Bench] physics scheduling checks failed (%d)", failures);
+        return 1;
+    }
+    return 0;
+}
+
+// Spatial grid with 10k moving entities over a 2000x2000 field: every
+// query kind checked against its brute-force reference, before and
+// after a run of incremental moves and removals, then both timed.
+int benchSpatial()
+{
+    const float field = 2000.0f;
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<float> pos(0.0f, field);
+    std::uniform_real_distribution<float> size(8.0f, 96.0f);
+    std::uniform_real_distribution<float> speed(-120.0f, 120.0f);
+
+    struct Body { ecs::Entity entity; SDL_FRect rect; float vx, vy; };
+    std::vector<Body> bodies(10000);
+    spatial::Grid grid(64.0f);
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const float s = size(rng);
+        bodies[i] = Body{ecs::Entity{static_cast<uint32_t>(i), 1}, SDL_FRect{pos(rng), pos(rng), s, s}, speed(rng), speed(rng)};
+        grid.update(bodies[i].entity, bodies[i].rect);
+    }
+
+    auto byIndex = [](const ecs::Entity& a, const ecs::Entity& b) { return a.index < b.index; };
+    std::vector<ecs::Entity> found, expected;
+    std::vector<spatial::Neighbour> near, nearRef;
+    uint64_t queries = 0, mismatches = 0;
+
+    auto check = [&](int count) {
+        for (int q = 0; q < count; ++q, queries += 3) {
+            const float x = pos(rng), y = pos(rng);
+
+            const float r = 20.0f + static_cast<float>(rng() % 200);
+            grid.radius(x, y, r, found);
+            grid.radiusLinear(x, y, r, expected);
+            std::sort(found.begin(), found.end(), byIndex);
+            std::sort(expected.begin(), expected.end(), byIndex);
+            if (found != expected) ++mismatches;
+
+            const size_t k = 1 + rng() % 16;
+            grid.nearest(x, y, k, near);
+            grid.nearestLinear(x, y, k, nearRef);
+            if (near.size() != nearRef.size()) ++mismatches;
+            else for (size_t i = 0; i < near.size(); ++i) {
+                if (near[i].entity != nearRef[i].entity || near[i].distance != nearRef[i].distance) { ++mismatches; break; }
+            }
+
+            const float x1 = x + speed(rng) * 5.0f, y1 = y + speed(rng) * 5.0f;
+            spatial::SegmentHit hit, hitRef;
+            const bool a = grid.segment(x, y, x1, y1, hit);
+            const bool b = grid.segmentLinear(x, y, x1, y1, hitRef);
+            if (a != b || (a && (hit.entity != hitRef.entity || hit.t != hitRef.t))) ++mismatches;
+        }
+    };
+    auto step = [&](float dt) {
+        for (Body& b : bodies) {
+            b.rect.x += b.vx * dt;
+            b.rect.y += b.vy * dt;
+            if (b.rect.x < 0.0f || b.rect.x > field) b.vx = -b.vx;
+            if (b.rect.y < 0.0f || b.rect.y > field) b.vy = -b.vy;
+            grid.update(b.entity, b.rect);
+        }
+    };
+
+    check(1000);
+    for (int tick = 0; tick < 120; ++tick) {
+        step(1.0f / 60.0f);
+        // a few die and their slots come back as new entities
+        for (int i = 0; i < 20; ++i) {
+            Body& b = bodies[rng() % bodies.size()];
+            grid.remove(b.entity);
+            ++b.entity.generation;
+            b.rect.x = pos(rng);
+            b.rect.y = pos(rng);
+            grid.update(b.entity, b.rect);
+        }
+    }
+    check(1000);
+    if (grid.size() != bodies.size()) ++mismatches;
+
+    std::printf("%-40s %10" PRIu64 " queries, %" PRIu64 " mismatches\n", "spatial grid vs brute force", queries, mismatches);
+    if (mismatches > 0) {
+        LOG_ERROR("[Bench] spatial grid disagrees with the brute-force queries");
+        return 1;
+    }
+
+    const uint64_t iterations = 2000;
+    const double updateNs = bench::nsPerOp(200, [&](uint64_t) { step(1.0f / 60.0f); }) / bodies.size();
+    bench::report("spatial update per entity", updateNs);
+
+    auto time = [&](const char* name, auto&& query) {
+        bench::report(name, bench::nsPerOp(iterations, [&](uint64_t i) {
+            const float x = static_cast<float>((i * 7919) % 2000), y = static_cast<float>((i * 104729) % 2000);
+            query(x, y);
+        }));
+    };
+    time("spatial radius 100 (grid)",    [&](float x, float y) { grid.radius(x, y, 100.0f, found); bench::keep(found.size()); });
+    time("spatial radius 100 (linear)",  [&](float x, float y) { grid.radiusLinear(x, y, 100.0f, found); bench::keep(found.size()); });
+    time("spatial nearest 8 (grid)",     [&](float x, float y) { grid.nearest(x, y, 8, near); bench::keep(near.size()); });
+    time("spatial nearest 8 (linear)",   [&](float x, float y) { grid.nearestLinear(x, y, 8, near); bench::keep(near.size()); });
+    spatial::SegmentHit hit;
+    time("spatial segment 400 (grid)",   [&](float x, float y) { bench::keep(grid.segment(x, y, x + 280.0f, y - 280.0f, hit)); });
+    time("spatial segment 400 (linear)", [&](float x, float y) { bench::keep(grid.segmentLinear(x, y, x + 280.0f, y - 280.0f, hit)); });
+    return 0;
+}
+
+// Scripted offscreen frames of XenonGame::render through the software
+// renderer, at several entity densities. The framebuffer checksums of
+// each density must match the reference file checked in with the
+// source, so a change that alters pixels fails the benchmark until it
+// is re-recorded with --record on purpose.
+#ifndef XENON_RENDER_REFERENCE
+#define XENON_RENDER_REFERENCE "game/bench/render_reference.txt"
+#endif
+
+BenchOptions s_options;   // of the current runBenchmark()
+
+// "density checksum" lines, checksums in hex; '#' starts a comment
+bool readRenderReference(const char* path, std::map<int, uint64_t>& out)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        int                density  = 0;
+        unsigned long long checksum = 0;
+        if (std::sscanf(line.c_str(), "%d %llx", &density, &checksum) == 2) out[density] = checksum;
+    }
+    return true;
+}
+
+bool writeRenderReference(const char* path, const std::map<int, uint64_t>& checksums)
+{
+    std::ofstream out(path);
+    out << "# xenon_game --bench render: framebuffer checksum per entity density.\n"
+        << "# Re-record with --bench render --record only when pixels are meant to change.\n";
+    for (const auto& [density, checksum] : checksums) {
+        out << density << " " << std::hex << checksum << std::dec << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+int benchRender()
+{
+    const char* referencePath = s_options.renderReference ? s_options.renderReference : XENON_RENDER_REFERENCE;
+    std::map<int, uint64_t> reference;
+    if (!s_options.record && !readRenderReference(referencePath, reference)) {
+        LOG_ERROR("[Bench] No render reference at %s (--reference <file>, or --record to write one)", referencePath);
+        return 1;
+    }
+    if (!s_options.record && reference.empty()) {
+        // the checked-in file before anyone ran --record; rendering would only fail later
+        LOG_ERROR("[Bench] %s has no checksums yet: run --bench render --record and commit the file", referencePath);
+        return 1;
+    }
+
+    XenonGame game;
+    Engine engine(800, 600, "render benchmark", game);
+    if (!engine.initOffscreen()) return 1;
+
+    const int densities[] = {0, 250, 1000, 4000};
+    const int frames      = 120;
+
+    std::map<int, uint64_t> results;
+    int failed = 0;
+
+    std::printf("%8s %12s %12s %10s %18s\n", "entities", "draws/frame", "submit ms", "Mpix/s", "checksum");
+    for (int density : densities) {
+        game.populateBenchmarkScene(density, 1234u + static_cast<uint32_t>(density));
+
+        double   submitMs = 0.0;
+        uint64_t draws    = 0;
+        uint64_t pixels   = 0;
+        uint64_t checksum = 14695981039346656037ull;
+        for (int f = 0; f < frames; ++f) {
+            const Engine::OffscreenFrame frame = engine.renderOffscreenFrame();
+            submitMs += frame.submitMs;
+            draws    += frame.drawCalls;
+            pixels   += frame.pixels;
+            checksum  = (checksum ^ frame.checksum) * 1099511628211ull;
+        }
+        results[density] = checksum;
+
+        std::printf("%8d %12.1f %12.3f %10.1f %18" PRIx64 "\n", density,
+                    static_cast<double>(draws) / frames, submitMs / frames,
+                    submitMs > 0.0 ? static_cast<double>(pixels) / (submitMs * 1000.0) : 0.0,
+                    checksum);
+
+        if (s_options.record) continue;
+        auto it = reference.find(density);
+        if (it == reference.end()) {
+            LOG_ERROR("[Bench] %s has no checksum for %d entities", referencePath, density);
+            failed = 1;
+        } else if (it->second != checksum) {
+            LOG_ERROR("[Bench] render output changed at %d entities", density);
+            failed = 1;
+        }
+    }
+
+    if (s_options.record) {
+        if (!writeRenderReference(referencePath, results)) {
+            LOG_ERROR("[Bench] Could not write %s", referencePath);
+            return 1;
+        }
+        LOG_INFO("[Bench] Recorded reference checksums to %s", referencePath);
+    }
+    return failed;
+}
+
+// Wakes every 'period' ticks until stopped
+script::Task ticker(uint64_t period, uint64_t& wakes)
+{
+    for (;;) {
+        ++wakes;
+        co_await script::waitTicks(period);
+    }
+}
+
+// 5000 scripts on periods of 1 to 60 ticks, the scale of a crowded
+// wave. The runtime must resume each exactly as often as its period
+// says, allocate nothing once started, reuse the pooled frames when
+// the scripts are replaced, and save the same bytes after a load.
+int benchScripts()
+{
+    const size_t   count = 5000;
+    const uint64_t ticks = 600;
+
+    uint64_t wakes = 0;
+    script::Runtime runtime(1.0f / 60.0f, count);
+    const auto startAll = [&] {
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t period = 1 + i % 60;
+            runtime.start([&] { return ticker(period, wakes); }, 0, script::Tag{0, period});
+        }
+    };
+
+    startAll();
+    const memory::AllocationCounters before = memory::allocationCounters();
+    for (uint64_t now = 0; now < ticks; ++now) runtime.run(now);
+    const uint64_t runAllocations = memory::allocationCounters().allocations - before.allocations;
+
+    uint64_t expected = 0;
+    for (size_t i = 0; i < count; ++i) expected += (ticks - 1) / (1 + i % 60) + 1;
+
+    runtime.stopAll();
+    const memory::AllocationCounters beforeRespawn = memory::allocationCounters();
+    startAll();
+    const uint64_t respawnAllocations = memory::allocationCounters().allocations - beforeRespawn.allocations;
+
+    snapshot::Buffer first, second;
+    snapshot::Writer firstOut(first);
+    runtime.save(firstOut);
+    const auto make = [&](script::Tag tag) { return ticker(tag.arg, wakes); };
+    snapshot::Reader reader(first.data(), first.size());
+    const bool loaded = runtime.load(reader, make) && reader.finished();
+    snapshot::Writer secondOut(second);
+    runtime.save(secondOut);
+    const bool roundTrip = loaded && first.size() == second.size() &&
+                           std::memcmp(first.data(), second.data(), first.size()) == 0;
+
+    std::printf("%-40s %10" PRIu64 " of %" PRIu64 "\n", "resumes", wakes, expected);
+    std::printf("%-40s %10" PRIu64 "\n", "allocations while running", runAllocations);
+    std::printf("%-40s %10" PRIu64 "\n", "allocations starting again", respawnAllocations);
+    std::printf("%-40s %10s\n", "save/load/save", roundTrip ? "ok" : "FAILED");
+    std::printf("%-40s %10.1f KB\n", "frame pool", runtime.poolBytes() / 1024.0);
+
+    if (wakes != expected || runAllocations > 0 || respawnAllocations > 0 || !roundTrip) {
+        LOG_ERROR("[Bench] script runtime checks failed");
+        return 1;
+    }
+
+    const uint64_t resumesBefore = runtime.resumes();
+    const double tickNs = bench::nsPerOp(ticks, [&](uint64_t i) { runtime.run(ticks + i); });
+    const double perTick = static_cast<double>(runtime.resumes() - resumesBefore) / ticks;
+    bench::report("script resume", tickNs / std::max(perTick, 1.0));
+    bench::report("script tick (5000 scripts)", tickNs);
+    return 0;
+}
+
+// Fills every pixel byte of 'surface' with 'value'
+void fillSurface(SDL_Surface* surface, uint8_t value)
+{
+    for (int row = 0; row < surface->h; ++row) {
+        std::memset(static_cast<uint8_t*>(surface->pixels) + row * surface->pitch, value, surface->w * 4);
+    }
+}
+
+// Whether every pixel byte of 'frame' is 'value'
+bool framePixelsAre(const shm::FrameView& frame, uint8_t value)
+{
+    for (int row = 0; row < frame.height; ++row) {
+        const uint8_t* p = frame.pixels + static_cast<size_t>(row) * frame.pitch;
+        for (int x = 0; x < frame.width * 4; ++x) {
+            if (p[x] != value) return false;
+        }
+    }
+    return true;
+}
+
+int benchSharedFrames()
+{
+    const std::string name = "/xenon_bench_frames";
+    const int slots = 4;
+
+    // --- In order: round trip, lapping, close ---
+    SDL_Surface* small = SDL_CreateSurface(31, 17, SDL_PIXELFORMAT_RGBA32);
+    if (!small) return 1;
+    shm::Publisher publisher;
+    shm::Reader    reader;
+    if (!publisher.start(name, small->w, small->h, slots) || !reader.open(name)) {
+        SDL_DestroySurface(small);
+        return 1;
+    }
+
+    shm::FrameView view;
+    bool ordered = !reader.latest(view);   // nothing yet
+    for (uint64_t seq = 1; seq <= 3; ++seq) {
+        fillSurface(small, static_cast<uint8_t>(seq * 40));
+        shm::GameState state;
+        state.tick  = seq;
+        state.score = static_cast<int32_t>(seq * 100);
+        ordered &= publisher.publish(small, seq + 10, state);
+    }
+    ordered &= reader.latest(view) && view.sequence == 3 && view.frameIndex == 13 && view.state.tick == 3 &&
+               view.state.score == 300 && view.width == 31 && view.height == 17 && framePixelsAre(view, 120);
+    ordered &= !reader.latest(view, 3);   // nothing newer
+
+    // the game needs slots - 1 more frames to come round to the held one
+    bool lapped = true;
+    for (int i = 0; i < slots; ++i) {
+        lapped &= reader.valid(view) == (i < slots);
+        fillSurface(small, 0);
+        publisher.publish(small, 0, shm::GameState{});
+        lapped &= reader.valid(view) == (i < slots - 1);
+    }
+
+    publisher.stop();
+    const bool closed = reader.closed() && reader.latest(view) && view.sequence == 3 + slots;
+    reader.close();
+    SDL_DestroySurface(small);
+
+    std::printf("%-40s %10s\n", "publish/read in order", ordered ? "ok" : "FAILED");
+    std::printf("%-40s %10s\n", "lapped frame goes stale", lapped ? "ok" : "FAILED");
+    std::printf("%-40s %10s\n", "closed, frames still mapped", closed ? "ok" : "FAILED");
+    if (!ordered || !lapped || !closed) {
+        LOG_ERROR("[Bench] shared frame ring checks failed");
+        return 1;
+    }
+
+    // --- Racing a reader: no torn frame passes valid() ---
+    SDL_Surface* frame = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_RGBA32);
+    if (!frame) return 1;
+    if (!publisher.start(name, frame->w, frame->h, slots) || !reader.open(name)) {
+        SDL_DestroySurface(frame);
+        return 1;
+    }
+    const uint64_t maxFrames = 200000;
+    std::atomic<bool>     done{false};
+    std::atomic<uint64_t> read{0};
+    uint64_t torn = 0, accepted = 0;
+    std::thread consumer([&] {
+        shm::FrameView v;
+        uint64_t last = 0;
+        while (!done.load(std::memory_order_acquire) || reader.latest(v, last)) {
+            if (!reader.latest(v, last)) continue;
+            last = v.sequence;
+            const bool whole = framePixelsAre(v, static_cast<uint8_t>(v.sequence)) && v.state.tick == v.sequence;
+            if (!reader.valid(v)) {
+                ++torn;
+                continue;
+            }
+            accepted += !whole;
+            read.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    // until the reader has had a good look; never waiting for it
+    uint64_t published = 0;
+    while (published < maxFrames && read.load(std::memory_order_relaxed) < 5000) {
+        ++published;
+        fillSurface(frame, static_cast<uint8_t>(published));
+        shm::GameState state;
+        state.tick = published;
+        publisher.publish(frame, published, state);
+        if (published % 16 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    publisher.stop();
+    reader.close();
+    SDL_DestroySurface(frame);
+
+    const uint64_t frames = read.load();
+    std::printf("%-40s %10" PRIu64 " read, %" PRIu64 " torn, %" PRIu64 " skipped\n", "racing reader", frames, torn,
+                published - frames - torn);
+    std::printf("%-40s %10" PRIu64 "\n", "torn frames accepted", accepted);
+    if (accepted > 0 || frames == 0) {
+        LOG_ERROR("[Bench] a reader accepted a frame the game was rewriting");
+        return 1;
+    }
+
+    // --- What a frame costs the game ---
+    SDL_Surface* screen = SDL_CreateSurface(800, 600, SDL_PIXELFORMAT_RGBA32);
+    if (!screen || !publisher.start(name, screen->w, screen->h, slots)) {
+        SDL_DestroySurface(screen);
+        return 1;
+    }
+    fillSurface(screen, 7);
+    shm::GameState state;
+    const double publishNs = bench::nsPerOp(240, [&](uint64_t i) {
+        state.tick = i;
+        publisher.publish(screen, i, state);
+    });
+    publisher.stop();
+    SDL_DestroySurface(screen);
+    bench::report("publish 800x600 frame", publishNs);
+    return 0;
+}
+
+// Sprite sheet measurement on a synthetic sheet with empty, opaque,
+// keyed and translucent frames: bounds and coverage against a brute
+// force scan, and trimmed draws (plain and at twice the size) leaving
+// the same pixels on a canvas as untrimmed ones. Then the share of
+// each game sheet's cell area that trimming leaves to fill.
+int benchSpriteSheets()
+{
+    const int frameW = 48, frameH = 40, columns = 8, rows = 4;
+    const int width  = frameW * columns, height = frameH * rows;
+    std::mt19937 rng{49};
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    const auto pixel = [&](int x, int y) { return &pixels[(static_cast<size_t>(y) * width + x) * 4]; };
+
+    for (int f = 0; f < columns * rows; ++f) {
+        const int ox = (f % columns) * frameW, oy = (f / columns) * frameH;
+        // frame 0 empty, 1 opaque, 2 translucent, the rest a keyed blob
+        int x0 = 0, x1 = frameW, y0 = 0, y1 = frameH;
+        if (f != 1) {
+            x0 = static_cast<int>(rng() % frameW);
+            y0 = static_cast<int>(rng() % frameH);
+            x1 = x0 + 1 + static_cast<int>(rng() % (frameW - x0));
+            y1 = y0 + 1 + static_cast<int>(rng() % (frameH - y0));
+        }
+        for (int y = 0; y < frameH; ++y) {
+            for (int x = 0; x < frameW; ++x) {
+                uint8_t* px = pixel(ox + x, oy + y);
+                const bool solid = f != 0 && x >= x0 && x < x1 && y >= y0 && y < y1 && (f == 1 || rng() % 4 != 0);
+                px[0] = solid ? static_cast<uint8_t>(rng() % 200) : 255;
+                px[1] = solid ? static_cast<uint8_t>(rng()) : 0;
+                px[2] = solid ? static_cast<uint8_t>(rng()) : 255;
+                px[3] = solid && f == 2 ? 128 : 255;
+            }
+        }
+    }
+    const SpriteSheet sheet = SpriteSheet::fromRGBA(pixels.data(), width * 4, width, height, frameW, frameH);
+
+    // brute force: bounds and coverage of every frame
+    int wrong = 0;
+    for (int f = 0; f < sheet.frameCount(); ++f) {
+        const int ox = (f % columns) * frameW, oy = (f / columns) * frameH;
+        int minX = frameW, minY = frameH, maxX = -1, maxY = -1, holes = 0, partial = 0;
+        for (int y = 0; y < frameH; ++y) {
+            for (int x = 0; x < frameW; ++x) {
+                const uint8_t* px = pixel(ox + x, oy + y);
+                if (px[0] == 255 && px[1] == 0 && px[2] == 255) { ++holes; continue; }
+                partial += px[3] != 255;
+                minX = std::min(minX, x); maxX = std::max(maxX, x);
+                minY = std::min(minY, y); maxY = std::max(maxY, y);
+            }
+        }
+        const SDL_Rect& b = sheet.bounds(f);
+        const Coverage expected = maxX < 0 ? Coverage::Empty : partial ? Coverage::Translucent
+                                : holes ? Coverage::Keyed : Coverage::Opaque;
+        if (sheet.coverage(f) != expected) ++wrong;
+        if (maxX >= 0 && (b.x != minX || b.y != minY || b.w != maxX - minX + 1 || b.h != maxY - minY + 1)) ++wrong;
+        if (maxX < 0 && b.w != 0) ++wrong;
+    }
+
+    // nearest-neighbour blit that skips the key, like a colour-keyed draw
+    const int canvasW = 160, canvasH = 120;
+    std::vector<uint32_t> plain(canvasW * canvasH), trimmed(canvasW * canvasH);
+    const auto blit = [&](std::vector<uint32_t>& canvas, const SDL_FRect& src, const SDL_FRect& dst) {
+        const int dx = static_cast<int>(dst.x), dy = static_cast<int>(dst.y);
+        const int dw = static_cast<int>(dst.w), dh = static_cast<int>(dst.h);
+        for (int y = 0; y < dh; ++y) {
+            for (int x = 0; x < dw; ++x) {
+                const int sx = static_cast<int>(src.x) + x * static_cast<int>(src.w) / dw;
+                const int sy = static_cast<int>(src.y) + y * static_cast<int>(src.h) / dh;
+                const uint8_t* px = pixel(sx, sy);
+                if ((px[0] == 255 && px[1] == 0 && px[2] == 255) || px[3] == 0) continue;
+                if (dx + x < 0 || dy + y < 0 || dx + x >= canvasW || dy + y >= canvasH) continue;
+                uint32_t value;
+                std::memcpy(&value, px, 4);
+                canvas[(dy + y) * canvasW + dx + x] = value;
+            }
+        }
+    };
+    uint64_t cellArea = 0, trimmedArea = 0;
+    for (int scale = 1; scale <= 2; ++scale) {
+        for (int f = 0; f < sheet.frameCount(); ++f) {
+            std::fill(plain.begin(), plain.end(), 0u);
+            std::fill(trimmed.begin(), trimmed.end(), 0u);
+            const SDL_FRect cell{static_cast<float>((f % columns) * frameW), static_cast<float>((f / columns) * frameH),
+                                 static_cast<float>(frameW), static_cast<float>(frameH)};
+            const SDL_FRect dst{static_cast<float>(rng() % 40), static_cast<float>(rng() % 30),
+                                cell.w * scale, cell.h * scale};
+            blit(plain, cell, dst);
+            cellArea += static_cast<uint64_t>(dst.w * dst.h);
+
+            SDL_FRect src, at;
+            if (sheet.trim(&cell, dst, src, at)) {
+                blit(trimmed, src, at);
+                trimmedArea += static_cast<uint64_t>(at.w * at.h);
+            }
+            if (plain != trimmed) ++wrong;
+        }
+    }
+
+    std::printf("%-40s %10s\n", "bounds, coverage and trimmed draws", wrong == 0 ? "ok" : "FAILED");
+    std::printf("%-40s %9.1f%%\n", "synthetic area left after trimming", 100.0 * trimmedArea / std::max<uint64_t>(cellArea, 1));
+    if (wrong != 0) {
+        LOG_ERROR("[Bench] sprite sheet checks failed (%d)", wrong);
+        return 1;
+    }
+
+    // the game's sheets, cut as XenonGame draws them
+    struct Source { const char* path; int frameWidth, frameHeight; };
+    const Source sources[] = {
+        {"graphics/galaxy2.bmp", 0, 0},    {"graphics/bosseyes2.bmp", 0, 0}, {"graphics/Ship1.bmp", 64, 64},
+        {"graphics/LonerA.bmp", 64, 64},   {"graphics/rusher.bmp", 64, 64},  {"graphics/explode64.bmp", 64, 64},
+        {"graphics/GAster96.bmp", 96, 96}, {"graphics/MAster64.bmp", 64, 64}, {"graphics/SAster64.bmp", 32, 32},
+        {"graphics/PUShield.bmp", 32, 32}, {"graphics/missile.bmp", 8, 16},
+    };
+    std::printf("%-26s %11s %6s %10s %10s %7s\n", "sheet", "coverage", "frames", "cell px", "trimmed px", "left");
+    for (const Source& source : sources) {
+        SDL_Surface* surface = SDL_LoadBMP(source.path);
+        SDL_Surface* rgba    = surface ? SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32) : nullptr;
+        if (!rgba) {
+            LOG_WARN("[Bench] Could not load %s", source.path);
+            SDL_DestroySurface(surface);
+            continue;
+        }
+        SDL_LockSurface(rgba);
+        const SpriteSheet s = SpriteSheet::fromRGBA(static_cast<const uint8_t*>(rgba->pixels), rgba->pitch,
+                                                    rgba->w, rgba->h, source.frameWidth, source.frameHeight);
+        SDL_UnlockSurface(rgba);
+        SDL_DestroySurface(rgba);
+        SDL_DestroySurface(surface);
+
+        const uint64_t cell = s.cellPixels() / std::max(s.frameCount(), 1);
+        const uint64_t trim = s.trimmedPixels() / std::max(s.frameCount(), 1);
+        std::printf("%-26s %11s %6d %10" PRIu64 " %10" PRIu64 " %6.1f%%\n", source.path, coverageName(s.coverage()),
+                    s.frameCount(), cell, trim, 100.0 * trim / std::max<uint64_t>(cell, 1));
+    }
+    return 0;
+}
+
+// Random schedules and cancels on the timing wheel, near and beyond
+// every level, overdue ones and reschedules from inside the callback,
+// checked step by step against a sorted map on (tick, schedule order).
+// Half way the wheel is saved and the rest runs on the loaded copy.
+// Then schedule+cancel and a quiet tick are timed under 100k timers.
+int benchTimers()
+{
+    std::mt19937_64 rng{48};
+    const auto below = [&rng](uint64_t n) { return rng() % n; };
+
+    using Key = std::pair<uint64_t, uint64_t>;   // tick, schedule order
+    std::map<Key, uint64_t> reference;           // -> argument
+    std::vector<std::pair<timer::TimerId, Key>> handles;
+    uint64_t order = 0, serial = 0, mismatches = 0, fired = 0;
+
+    timer::Wheel wheel(4096);
+    const auto schedule = [&](uint64_t tick) {
+        const uint64_t arg = serial++;
+        const Key      key{tick, order++};
+        reference.emplace(key, arg);
+        handles.emplace_back(wheel.schedule(tick, timer::Timer{0, arg}), key);
+    };
+    const auto fire = [&](timer::TimerId, const timer::Timer& t) {
+        ++fired;
+        if (reference.empty() || reference.begin()->second != t.arg) {
+            ++mismatches;
+            return;
+        }
+        reference.erase(reference.begin());
+        if (t.arg % 4 == 0) schedule(wheel.now() + 1 + t.arg % 200);
+    };
+
+    bool roundTrip = true, idsKept = true;
+    uint64_t now = 0;
+    for (int step = 0; step < 20000; ++step) {
+        now += step % 5000 == 4999 ? (uint64_t{1} << 25) : below(4);
+
+        for (int n = 0; n < 3; ++n) {
+            const uint64_t kind = below(10);
+            uint64_t tick;
+            if (kind < 3)      tick = now + below(64);
+            else if (kind < 6) tick = now + 64 + below(4096);
+            else if (kind < 8) tick = now + below(uint64_t{1} << 20);
+            else if (kind < 9) tick = now + below(uint64_t{1} << 26);
+            else               tick = now - std::min<uint64_t>(now, below(100));
+            schedule(tick);
+        }
+        if (!handles.empty() && below(2) == 0) {
+            const size_t i = below(handles.size());
+            const bool   cancelled = wheel.cancel(handles[i].first);
+            if (cancelled != (reference.erase(handles[i].second) == 1)) ++mismatches;
+            handles[i] = handles.back();
+            handles.pop_back();
+        }
+
+        wheel.advance(now, fire);
+        if ((!reference.empty() && reference.begin()->first.first <= now) || wheel.size() != reference.size()) {
+            ++mismatches;
+        }
+        if (handles.size() > 8192) {
+            std::erase_if(handles, [&](const auto& h) { return !wheel.pending(h.first); });
+        }
+
+        if (step == 10000) {
+            snapshot::Buffer first, second;
+            snapshot::Writer firstOut(first);
+            wheel.save(firstOut);
+            timer::Wheel loaded;
+            snapshot::Reader reader(first.data(), first.size());
+            const bool ok = loaded.load(reader) && reader.finished();
+            snapshot::Writer secondOut(second);
+            loaded.save(secondOut);
+            roundTrip = ok && first.size() == second.size() &&
+                        std::memcmp(first.data(), second.data(), first.size()) == 0;
+            for (const auto& h : handles) {
+                if (loaded.pending(h.first) != wheel.pending(h.first) ||
+                    loaded.dueTick(h.first) != wheel.dueTick(h.first)) idsKept = false;
+            }
+            wheel = std::move(loaded);
+        }
+    }
+
+    std::printf("%-40s %10" PRIu64 "\n", "timers fired", fired);
+    std::printf("%-40s %10zu\n", "timers pending", wheel.size());
+    std::printf("%-40s %10s\n", "firing order", mismatches == 0 ? "ok" : "FAILED");
+    std::printf("%-40s %10s\n", "save/load/save", roundTrip ? "ok" : "FAILED");
+    std::printf("%-40s %10s\n", "ids after load", idsKept ? "ok" : "FAILED");
+
+    if (mismatches != 0 || !roundTrip || !idsKept) {
+        LOG_ERROR("[Bench] timer wheel checks failed");
+        return 1;
+    }
+
+    // 100k timers spread over the next ten minutes of ticks
+    const uint64_t idle = 100000;
+    timer::Wheel busy(idle + 1);
+    for (uint64_t i = 0; i < idle; ++i) busy.schedule(1 + below(36000), timer::Timer{0, i});
+
+    const uint64_t iterations = 1000000;
+    const double scheduleNs = bench::nsPerOp(iterations, [&](uint64_t i) {
+        busy.cancel(busy.schedule(1 + i % 36000, timer::Timer{}));
+    });
+    uint64_t due = 0;
+    const double tickNs = bench::nsPerOp(36000, [&](uint64_t i) {
+        busy.advance(i + 1, [&](timer::TimerId, const timer::Timer&) { ++due; });
+    });
+    bench::keep(due);
+    bench::report("timer schedule+cancel (100k pending)", scheduleNs);
+    bench::report("timer tick (100k over 36000 ticks)", tickNs);
+    return 0;
+}
+
+// What tracing adds to a game frame. The same 120 frames (update and
+// render of a 1000-entity scene) run with and without a session,
+// interleaved, keeping the fastest of each. A 1% difference is within
+// run-to-run noise, so the budget is checked on the estimate instead:
+// zones recorded per frame times the cost of one recorded zone.
+int benchTrace()
+{
+    XenonGame game(11);
+    Engine engine(800, 600, "trace benchmark", game);
+    if (!engine.initOffscreen()) return 1;
+
+    game.populateBenchmarkScene(1000, 11);
+    GameSnapshot start;
+    game.saveState(start);
+
+    const int frames = 120;
+    const int rounds = 5;
+    auto frameMs = [&] {
+        game.restoreState(start);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f) {
+            engine.stepOffscreen();
+            engine.renderOffscreenFrame();
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / frames;
+    };
+
+    const std::string path = (std::filesystem::temp_directory_path() / "xenon_bench_trace.json").string();
+    if (!trace::start(path)) return 1;
+    trace::stop();   // the first session pays for the buffer and the writer thread
+
+    double offMs = 1e30, onMs = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        offMs = std::min(offMs, frameMs());
+        trace::start(path);
+        onMs = std::min(onMs, frameMs());
+        trace::stop();
+    }
+
+    // the last session's file holds one round of frames
+    uint64_t zones = 0;
+    {
+        std::ifstream in(path);
+        const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        for (size_t at = text.find("\"ph\":\"X\""); at != std::string::npos; at = text.find("\"ph\":\"X\"", at + 1)) ++zones;
+    }
+
+    // fewer zones than a ring holds, so none is dropped
+    const uint64_t iterations = 10000;
+    const double idleNs = bench::nsPerOp(iterations, [](uint64_t) { TRACE_ZONE("bench", "bench"); });
+    trace::start(path);
+    const double zoneNs = bench::nsPerOp(iterations, [](uint64_t) { TRACE_ZONE("bench", "bench"); });
+    trace::stop();
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    const double zonesPerFrame = static_cast<double>(zones) / frames;
+    const double estimate      = zonesPerFrame * zoneNs / (offMs * 1e6) * 100.0;
+
+    bench::report("zone, no session", idleNs);
+    bench::report("zone, recording", zoneNs);
+    std::printf("%-40s %10.1f\n", "zones per frame", zonesPerFrame);
+    std::printf("%-40s %10.3f ms\n", "frame, no session", offMs);
+    std::printf("%-40s %10.3f ms (%+.2f%%)\n", "frame, recording", onMs, (onMs / offMs - 1.0) * 100.0);
+    std::printf("%-40s %10.3f %%\n", "estimated tracing cost", estimate);
+
+    if (estimate > 1.0) {
+        LOG_ERROR("[Bench] tracing costs %.2f%% of a frame (budget 1%%)", estimate);
+        return 1;
+    }
+    return 0;
+}
+
+// Save and restore cost of the whole game state with 10k entities,
+// plus correctness checks: a restore followed by a save gives the
+// same bytes, re-simulating from a snapshot (rollback) reaches the
+// same state as the first run, and a corrupt world snapshot is refused.
+int benchSnapshot()
+{
+    XenonGame game(7);
+    Engine engine(800, 600, "snapshot benchmark", game);
+    if (!engine.initOffscreen()) return 1;
+
+    game.populateBenchmarkScene(10000, 7);
+
+    GameSnapshot start, end, check;
+    game.saveState(start);
+
+    // the engine tick moves with every update, so timers, scripts,
+    // paths, clips, bullets and lifetimes all run
+    const PlayerInput input{1, -1, true};
+    auto simulate = [&game, &engine, &input] {
+        for (int f = 0; f < 60; ++f) {
+            game.applyInput(input);
+            engine.stepOffscreen();
+        }
+    };
+
+    simulate();
+    game.saveState(end);
+    const bool advanced = end.hash() != start.hash();
+
+    game.restoreState(start);
+    game.saveState(check);
+    const bool roundTrip = check.bytes == start.bytes && check.hash() == start.hash();
+
+    simulate();
+    game.saveState(check);
+    const bool rollback = check.hash() == end.hash();
+
+    // a world snapshot whose mask names an unregistered component, or
+    // claims more rows than records, is refused and leaves the world empty
+    ecs::World world;
+    world.create(Transform{}, Velocity{});
+    snapshot::Buffer saved;
+    snapshot::Writer worldOut(saved);
+    world.save(worldOut);
+    // [records][frees][archetypes][generation] precede the first mask
+    const size_t maskAt = 4 * sizeof(uint32_t);
+    auto refuses = [&](size_t offset, const auto& value) {
+        snapshot::Buffer bad = saved;
+        std::memcpy(bad.data() + offset, &value, sizeof(value));
+        snapshot::Reader badIn(bad.data(), bad.size());
+        return !world.load(badIn) && world.entityCount() == 0;
+    };
+    const bool rejected = refuses(maskAt, ecs::ComponentMask{1} << 63) &&
+                          refuses(maskAt + sizeof(ecs::ComponentMask), uint32_t{1000});
+
+    const uint64_t iterations = 200;
+    const double saveNs    = bench::nsPerOp(iterations, [&](uint64_t) { game.saveState(check); });
+    const double restoreNs = bench::nsPerOp(iterations, [&](uint64_t) { game.restoreState(start); });
+    const double hashNs    = bench::nsPerOp(iterations, [&](uint64_t) { bench::keep(start.hash()); });
+
+    std::printf("%-40s %10zu bytes\n", "snapshot size (10k entities)", start.bytes.size());
+    std::printf("%-40s %10.1f us\n", "snapshot save", saveNs / 1000.0);
+    std::printf("%-40s %10.1f us\n", "snapshot restore", restoreNs / 1000.0);
+    std::printf("%-40s %10.1f us\n", "snapshot hash", hashNs / 1000.0);
+    std::printf("%-40s %10s\n", "restore/save round trip", roundTrip ? "ok" : "FAILED");
+    std::printf("%-40s %10s\n", "simulation changed the state", advanced ? "ok" : "FAILED");
+    std::printf("%-40s %10s\n", "rollback re-simulation", rollback ? "ok" : "FAILED");
+    std::printf("%-40s %10s\n", "malformed world refused", rejected ? "ok" : "FAILED");
+
+    if (!roundTrip || !advanced || !rollback || !rejected) {
+        LOG_ERROR("[Bench] snapshot does not reproduce the game state");
+        return 1;
+    }
+    // budget: 50 us each way; reported, not failed, as shared machines vary
+    if (saveNs > 50'000.0 || restoreNs > 50'000.0) {
+        LOG_WARN("[Bench] snapshot over budget (50 us)");
+    }
+    return 0;
+}
+
+// Environment steps per second of VecEnv with random actions, from one
+// thread up to every hardware thread. Efficiency is the speed-up over
+// one thread divided by the thread count.
+// Same action for the same step and session on every run
+PlayerInput scriptedAction(int step, int session)
+{
+    PlayerInput a;
+    a.moveX = static_cast<int8_t>((step / 7 + session) % 3 - 1);
+    a.moveY = static_cast<int8_t>((step / 11 + session * 2) % 3 - 1);
+    a.fire  = (step + session) % 4 != 0;
+    return a;
+}
+
+int benchEnv()
+{
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const int      sessions = 64;
+    const int      steps    = 500;
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < hardware; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hardware);
+
+    std::printf("%8s %14s %12s\n", "threads", "env-steps/s", "efficiency");
+    double single = 0.0;
+    for (unsigned threads : threadCounts) {
+        VecEnvConfig config;
+        config.count     = sessions;
+        config.threads   = threads;
+        config.obsWidth  = 80;
+        config.obsHeight = 60;
+        VecEnv env(config);
+        if (!env.init()) return 1;
+
+        std::mt19937 rng{99};
+        std::vector<PlayerInput> actions(sessions);
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        for (int s = 0; s < steps; ++s) {
+            for (PlayerInput& a : actions) {
+                a.moveX = static_cast<int8_t>(static_cast<int>(rng() % 3) - 1);
+                a.moveY = static_cast<int8_t>(static_cast<int>(rng() % 3) - 1);
+                a.fire  = (rng() & 1) != 0;
+            }
+            env.step(actions.data());
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const double rate    = static_cast<double>(env.totalSteps()) / seconds;
+        if (threads == 1) single = rate;
+
+        std::printf("%8u %14.0f %11.0f%%\n", threads, rate, single > 0.0 ? 100.0 * rate / (single * threads) : 0.0);
+    }
+
+    const auto run = [](VecEnv& env, int from, int steps) {
+        std::vector<PlayerInput> actions(env.count());
+        for (int s = from; s < from + steps; ++s) {
+            for (int i = 0; i < env.count(); ++i) actions[i] = scriptedAction(s, i);
+            env.step(actions.data());
+        }
+    };
+
+    VecEnvConfig config;
+    config.count = 16;
+
+    // Sessions are independent: the same seeds and actions give the
+    // same scores and states whether one thread steps them or four
+    VecEnvCheckpoint states[2];
+    std::vector<int> scores[2];
+    const unsigned   threads[2] = {1, 4};
+    for (int k = 0; k < 2; ++k) {
+        config.threads = threads[k];
+        VecEnv env(config);
+        if (!env.init()) return 1;
+        run(env, 0, 300);
+        env.save(states[k]);
+        scores[k].assign(env.scores(), env.scores() + env.count());
+    }
+    int differ = 0;
+    for (int i = 0; i < config.count; ++i) {
+        differ += scores[0][i] != scores[1][i] || states[0].games[i].hash() != states[1].games[i].hash();
+    }
+    std::printf("%-40s %10d of %d\n", "sessions differing, 1 vs 4 threads", differ, config.count);
+    if (differ > 0) {
+        LOG_ERROR("[Bench] VecEnv sessions depend on the thread count");
+        return 1;
+    }
+
+    // Sessions land on whichever worker is free, so loner scripts are
+    // started on one thread and stopped by a restore on another; a
+    // rollback must replay the steps it undid exactly
+    config.threads = 4;
+    VecEnv env(config);
+    if (!env.init()) return 1;
+
+    VecEnvCheckpoint mark, ahead, replayed;
+    run(env, 0, 150);
+    env.save(mark);
+    run(env, 150, 150);
+    env.save(ahead);
+    env.restore(mark);
+    run(env, 150, 150);
+    env.save(replayed);
+
+    int diverged = 0;
+    for (int i = 0; i < env.count(); ++i) diverged += ahead.games[i].hash() != replayed.games[i].hash();
+    std::printf("%-40s %10d of %d\n", "sessions diverged after rollback", diverged, env.count());
+    if (diverged > 0) {
+        LOG_ERROR("[Bench] VecEnv rollback across threads did not replay the same game");
+        return 1;
+    }
+    return 0;
+}
+
+struct Entry {
+    const char* name;
+    int (*fn)();
+};
+
+const Entry s_benchmarks[] = {
+    {"audio",          benchAudio},
+    {"bullets",        benchBullets},
+    {"capture",        benchCapture},
+    {"collision-mask", benchCollisionMask},
+    {"entity-system",  benchEntitySystem},
+    {"env",            benchEnv},
+    {"paths",          benchPaths},
+    {"physics",        benchPhysics},
+    {"rect-batch",     benchRectBatch},
+    {"render",         benchRender},
+    {"scripts",        benchScripts},
+    {"shared-frames",  benchSharedFrames},
+    {"snapshot",       benchSnapshot},
+    {"spatial",        benchSpatial},
+    {"sprite-sheets",  benchSpriteSheets},
+    {"timers",         benchTimers},
+    {"trace",          benchTrace},
+};
+
+} // namespace
+
+int runBenchmark(const char* name, const BenchOptions& options)
+{
+    s_options = options;
+    const bool all = std::strcmp(name, "all") == 0;
+    int result = 0;
+    bool found = false;
+    for (const Entry& e : s_benchmarks) {
+        if (all || std::strcmp(name, e.name) == 0) {
+            found = true;
+            result |= e.fn();
+        }
+    }
+    if (!found) {
+        std::cerr << "[Bench] Unknown benchmark '" << name << "'. Available:";
+        for (const Entry& e : s_benchmarks) std::cerr << " " << e.name;
+        std::cerr << "\n";
+        return 2;
+    }
+    return result;
+}
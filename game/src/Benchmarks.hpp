@@ -0,0 +1,16 @@
+#pragma once
+
+// Micro-benchmarks, run with: xenon_game --bench <name|all> [options]
+//
+//     --reference <file>  render checksums to compare against; the
+//                         default is game/bench/render_reference.txt
+//     --record            write the render checksums to that file
+//                         instead, after a change that means to
+//                         alter pixels
+struct BenchOptions {
+    const char* renderReference = nullptr;   // nullptr: the default
+    bool        record          = false;
+};
+
+// Returns the process exit code; non-zero when a check fails
+int runBenchmark(const char* name, const BenchOptions& options = {});
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+
+#include "Engine/Animation.hpp"
+#include "Engine/CollisionMask.hpp"
+#include "Engine/Path.hpp"
+
+// ------------------------------------------------------------
+// ECS components for XenonGame. Plain data only: the engine
+// moves them around with memcpy, and game snapshots hash the raw
+// bytes, so components must not contain padding.
+// ------------------------------------------------------------
+
+enum class EnemyType   { Loner, Rusher };
+enum class PowerUpType { Weapon, Shield, Score, Life };
+
+// draw order of sprite entities, lowest first
+enum class SpriteLayer : uint8_t {
+    Asteroid,
+    PowerUp,
+    Enemy,
+    Missile,
+    EnemyProjectile,
+    Explosion
+};
+
+struct Transform {
+    SDL_FRect rect{};
+};
+
+struct Velocity {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Scripted movement: path::Follower (Engine/Path.hpp) is used as a
+// component directly and sets Transform's position every tick
+
+// The source rect comes from the clip at draw time; still images
+// are single-frame clips
+struct Sprite {
+    SDL_Texture* texture   = nullptr;
+    uint64_t     startTick = 0;   // game tick the clip started on
+    anim::ClipId clip      = 0;
+    SpriteLayer  layer     = SpriteLayer::Asteroid;
+    uint8_t      reserved[5]{};   // explicit, so no padding bytes
+};
+
+// Entity is destroyed once the game tick reaches endTick
+struct Lifetime {
+    uint64_t endTick = 0;
+};
+
+// Pixel mask for the narrow-phase; the frame follows the sprite's clip
+struct Collider {
+    const CollisionMask* mask = nullptr;
+};
+
+struct Health {
+    int hp = 1;
+};
+
+// Entity is destroyed once its rect leaves this region
+struct CullBounds {
+    float minX = -1.0e9f;   // rect.x < minX
+    float minY = -1.0e9f;   // rect.y + rect.h < minY
+    float maxX =  1.0e9f;   // rect.x > maxX
+    float maxY =  1.0e9f;   // rect.y > maxY
+};
+
+// What an enemy does beyond its path (firing) is a script; see XenonGame::lonerFire
+struct Enemy {
+    EnemyType type = EnemyType::Loner;
+};
+
+struct PowerUp {
+    PowerUpType type = PowerUpType::Score;
+};
+
+// Tags
+struct MissileTag {};
+struct EnemyProjectileTag {};
+struct AsteroidTag {};
+
+// sizes equal to the sum of the fields: no padding (64-bit targets)
+static_assert(sizeof(Transform)  == 16);
+static_assert(sizeof(Velocity)   == 8);
+static_assert(sizeof(Sprite)     == 24);
+static_assert(sizeof(Lifetime)   == 8);
+static_assert(sizeof(Health)     == 4);
+static_assert(sizeof(CullBounds) == 16);
+static_assert(sizeof(Enemy)      == 4);
+static_assert(sizeof(PowerUp)    == 4);
+static_assert(sizeof(path::Follower) == 24);
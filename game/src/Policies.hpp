@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Components.hpp"
+#include "Engine/Animation.hpp"
+#include "Engine/Draw.hpp"
+#include "Engine/EntitySystem.hpp"
+
+// ------------------------------------------------------------
+// Policies for ecs::EntitySystem (Engine/EntitySystem.hpp). Each
+// one is a column loop over a chunk; XenonGame composes them into
+// its movement, culling, expiry and sprite systems.
+//
+// ExpireAt counts the due entities first, one compare per entity
+// with no branch, and only a chunk that loses one takes the destroy
+// path. CullOutside tests with || like a hand-written loop: counting
+// first evaluated all four compares for every entity and measured a
+// third slower in --bench entity-system.
+// ------------------------------------------------------------
+
+// Motion: Transform += Velocity * dt
+struct Integrate {
+    template <typename View>
+    void run(const View& chunk, float dt) const
+    {
+        Transform*      t = chunk.template column<Transform>();
+        const Velocity* v = chunk.template column<Velocity>();
+        for (uint32_t i = 0; i < chunk.count; ++i) {
+            t[i].rect.x += v[i].x * dt;
+            t[i].rect.y += v[i].y * dt;
+        }
+    }
+};
+
+// Bounds: destroys entities whose rect has left their CullBounds
+struct CullOutside {
+    ecs::World* world = nullptr;
+
+    template <typename View>
+    void run(const View& chunk, float) const
+    {
+        const Transform*   t = chunk.template column<Transform>();
+        const CullBounds*  b = chunk.template column<CullBounds>();
+        const ecs::Entity* e = chunk.entities;
+        const uint32_t     n = chunk.count;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (isOutside(t[i].rect, b[i])) world->destroyDeferred(e[i]);
+        }
+    }
+
+    static bool isOutside(const SDL_FRect& r, const CullBounds& b)
+    {
+        return r.x < b.minX || r.x > b.maxX || r.y + r.h < b.minY || r.y > b.maxY;
+    }
+};
+
+// Lifetime: destroys entities once the game tick reaches their end
+struct ExpireAt {
+    ecs::World* world = nullptr;
+    uint64_t    now   = 0;   // set before every run
+
+    template <typename View>
+    void run(const View& chunk, float) const
+    {
+        const Lifetime* l = chunk.template column<Lifetime>();
+        uint32_t due = 0;
+        for (uint32_t i = 0; i < chunk.count; ++i) due += static_cast<uint32_t>(now >= l[i].endTick);
+        if (due == 0) return;
+
+        for (uint32_t i = 0; i < chunk.count; ++i) {
+            if (now >= l[i].endTick) world->destroyDeferred(chunk.entities[i]);
+        }
+    }
+};
+
+// Render: draws the sprites of one layer with the current frame of their
+// clip, trimmed to the pixels it draws
+struct DrawSprites {
+    const anim::ClipLibrary* clips    = nullptr;
+    SDL_Renderer*            renderer = nullptr;   // the rest is set before every run
+    SpriteLayer              layer    = SpriteLayer::Asteroid;
+    uint64_t                 now      = 0;
+
+    template <typename View>
+    void run(const View& chunk, float) const
+    {
+        const Transform* t = chunk.template column<Transform>();
+        const Sprite*    s = chunk.template column<Sprite>();
+        const SDL_FRect* src;
+        SDL_FRect        at;
+        for (uint32_t i = 0; i < chunk.count; ++i) {
+            if (s[i].layer != layer || !s[i].texture) continue;
+            if (!clips->trimmed(s[i].clip, s[i].startTick, now, t[i].rect, src, at)) continue;
+            draw::texture(renderer, s[i].texture, src, &at);
+        }
+    }
+};
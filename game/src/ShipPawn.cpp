@@ -1,5 +1,7 @@
 #include "ShipPawn.hpp"
-#include <iostream>
+#include "Engine/Draw.hpp"
+#include "Engine/Log.hpp"
+
 #include <string>
 
 bool ShipPawn::init(TextureManager* textures,
@@ -14,7 +16,7 @@ bool ShipPawn::init(TextureManager* textures,
     m_frameHeight = frameHeight;
 
     if (!m_textures) {
-        std::cerr << "[ShipPawn] No TextureManager\n";
+        LOG_ERROR("[ShipPawn] No TextureManager");
         return false;
     }
 
@@ -22,14 +24,16 @@ bool ShipPawn::init(TextureManager* textures,
     std::string fullPath = "graphics/";
     fullPath += spriteName;
 
-    std::cout << "[ShipPawn] loading sprite: " << fullPath << "\n";
+    LOG_DEBUG("[ShipPawn] loading sprite: %s", fullPath.c_str());
+
+    m_texture = m_textures->load(fullPath, frameWidth, frameHeight);
 
-    m_texture = m_textures->load(fullPath);
-    
     if (!m_texture) {
-        std::cerr << "[ShipPawn] Failed to load sprite: " << fullPath << "\n";
+        LOG_ERROR("[ShipPawn] Failed to load sprite: %s", fullPath.c_str());
         return false;
     }
+    m_mask  = m_textures->getMask(m_texture);
+    m_sheet = m_textures->getSheet(m_texture);
 
     // position at bottom center
     m_rect.w = static_cast<float>(m_frameWidth);
@@ -75,5 +79,43 @@ void ShipPawn::render(SDL_Renderer* renderer)
     src.x = static_cast<float>(m_currentFrame * m_frameWidth);
     src.y = 0.0f;
 
-    SDL_RenderTexture(renderer, m_texture, &src, &m_rect);
+    SDL_FRect trimmedSrc, at;
+    if (!m_sheet) {
+        draw::texture(renderer, m_texture, &src, &m_rect);
+    } else if (m_sheet->trim(&src, m_rect, trimmedSrc, at)) {
+        draw::texture(renderer, m_texture, &trimmedSrc, &at);
+    }
+}
+
+void ShipPawn::saveState(snapshot::Writer& out) const
+{
+    // field by field: bools as bytes, nothing that could be padding
+    out.put(m_rect);
+    out.put(m_velocity);
+    out.put(static_cast<uint8_t>(m_alive));
+    out.put(m_currentFrame);
+    out.put(m_speed);
+    out.put(m_animFrame);
+    const uint8_t moves[4] = {m_moveLeft, m_moveRight, m_moveUp, m_moveDown};
+    out.put(moves);
+}
+
+bool ShipPawn::loadState(snapshot::Reader& in)
+{
+    uint8_t alive = 0;
+    uint8_t moves[4] = {};
+    in.get(m_rect);
+    in.get(m_velocity);
+    in.get(alive);
+    in.get(m_currentFrame);
+    in.get(m_speed);
+    in.get(m_animFrame);
+    in.get(moves);
+
+    m_alive     = alive != 0;
+    m_moveLeft  = moves[0] != 0;
+    m_moveRight = moves[1] != 0;
+    m_moveUp    = moves[2] != 0;
+    m_moveDown  = moves[3] != 0;
+    return in.ok();
 }
@@ -1,12 +1,13 @@
 #pragma once
 
 #include "Engine/Pawn.hpp"
+#include "Engine/Snapshot.hpp"
 #include "Engine/TextureManager.hpp"
 
 class ShipPawn : public Pawn {
 public:
     ShipPawn() = default;
-    ~ShipPawn() override = default;
+    ~ShipPawn() = default;
 
     bool init(TextureManager* textures,
               const char* spritePath,
@@ -23,12 +24,22 @@ public:
     void setMoveUp(bool v)    { m_moveUp    = v; }
     void setMoveDown(bool v)  { m_moveDown  = v; }
 
-    void update(float dt) override;
-    void render(SDL_Renderer* renderer) override;
+    void update(float dt);
+    void render(SDL_Renderer* renderer);
+
+    // per-frame collision mask of the sprite sheet, may be nullptr
+    const CollisionMask* getMask() const { return m_mask; }
+    int getFrame() const { return m_currentFrame; }
+
+    // Position, motion, animation and held input; the sprite stays
+    void saveState(snapshot::Writer& out) const;
+    bool loadState(snapshot::Reader& in);
 
 private:
     TextureManager* m_textures = nullptr;
     SDL_Texture*    m_texture  = nullptr;
+    const CollisionMask* m_mask = nullptr;
+    const SpriteSheet*   m_sheet = nullptr;   // trims each frame for drawing
 
     int   m_frameWidth  = 0;
     int   m_frameHeight = 0;
@@ -41,7 +52,4 @@ private:
     bool m_moveRight = false;
     bool m_moveUp    = false;
     bool m_moveDown  = false;
-
-
-    
 };
@@ -0,0 +1,155 @@
+#include "VecEnv.hpp"
+
+#include "Engine/Log.hpp"
+#include "Engine/Trace.hpp"
+
+VecEnv::VecEnv(const VecEnvConfig& config)
+    : m_config(config)
+    , m_pool(config.threads)
+{
+}
+
+VecEnv::~VecEnv()
+{
+    m_sessions.clear();
+    m_textures.clear();
+
+    if (m_renderer) SDL_DestroyRenderer(m_renderer);
+    if (m_surface)  SDL_DestroySurface(m_surface);
+    if (m_renderer || m_surface) SDL_Quit();
+}
+
+bool VecEnv::init()
+{
+    // the renderer only hosts the textures, so a 1x1 target is enough
+    if (!SDL_Init(0)) {
+        LOG_ERROR("[VecEnv] SDL_Init failed: %s", SDL_GetError());
+        return false;
+    }
+    m_surface = SDL_CreateSurface(1, 1, SDL_PIXELFORMAT_ARGB8888);
+    m_renderer = m_surface ? SDL_CreateSoftwareRenderer(m_surface) : nullptr;
+    if (!m_renderer) {
+        LOG_ERROR("[VecEnv] Software renderer failed: %s", SDL_GetError());
+        return false;
+    }
+    m_textures.setRenderer(m_renderer);
+
+    const int n = m_config.count;
+    m_rewards.assign(n, 0.0f);
+    m_dones.assign(n, 0);
+    m_scores.assign(n, 0);
+    if (m_config.obsWidth > 0 && m_config.obsHeight > 0) {
+        m_observations.assign(static_cast<size_t>(n) * m_config.obsWidth * m_config.obsHeight, 0);
+    }
+
+    m_sessions.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        auto session = std::make_unique<Session>(m_config.seed + static_cast<uint32_t>(i));
+
+        EngineContext ctx;
+        ctx.width      = m_config.width;
+        ctx.height     = m_config.height;
+        ctx.textures   = &m_textures;
+        ctx.frameArena = &session->arena;
+        ctx.stats      = &session->stats;
+        ctx.tick       = &session->tick;
+
+        if (!session->game.init(ctx)) {
+            LOG_ERROR("[VecEnv] Session %d failed to init", i);
+            return false;
+        }
+        m_sessions.push_back(std::move(session));
+    }
+
+    reset();
+    return true;
+}
+
+void VecEnv::reset()
+{
+    for (int i = 0; i < count(); ++i) {
+        Session& s = *m_sessions[i];
+        s.episode = 0;
+        s.game.reset(m_config.seed + static_cast<uint32_t>(i));
+        m_rewards[i] = 0.0f;
+        m_dones[i]   = 0;
+        m_scores[i]  = 0;
+        observe(i);
+    }
+}
+
+void VecEnv::step(const PlayerInput* actions)
+{
+    TRACE_ZONE("VecEnv::step", "env");
+    m_pool.parallelFor(static_cast<size_t>(count()), [this, actions](size_t i) {
+        stepSession(static_cast<int>(i), actions[i]);
+    });
+    m_totalSteps += static_cast<uint64_t>(count());
+}
+
+void VecEnv::stepSession(int i, const PlayerInput& action)
+{
+    Session& s = *m_sessions[i];
+    const int before = s.game.score();
+
+    s.game.applyInput(action);
+    for (int f = 0; f < m_config.frameSkip && !s.game.finished(); ++f) {
+        ++s.tick;
+        s.game.update(Engine::s_fixedTimeStep);
+        s.arena.reset();
+    }
+
+    m_scores[i]  = s.game.score();
+    m_rewards[i] = static_cast<float>(m_scores[i] - before);
+    m_dones[i]   = s.game.finished() ? 1 : 0;
+
+    if (m_dones[i]) {
+        // new episode, new but reproducible random stream
+        ++s.episode;
+        s.game.reset(m_config.seed + static_cast<uint32_t>(i) + s.episode * static_cast<uint32_t>(count()));
+    }
+    observe(i);
+}
+
+void VecEnv::save(VecEnvCheckpoint& out)
+{
+    TRACE_ZONE("VecEnv::save", "env");
+    out.games.resize(m_sessions.size());
+    out.episodes.resize(m_sessions.size());
+    m_pool.parallelFor(m_sessions.size(), [this, &out](size_t i) {
+        m_sessions[i]->game.saveState(out.games[i]);
+        out.episodes[i] = m_sessions[i]->episode;
+    });
+}
+
+void VecEnv::restore(const VecEnvCheckpoint& in)
+{
+    TRACE_ZONE("VecEnv::restore", "env");
+    if (in.games.size() != m_sessions.size() || in.episodes.size() != m_sessions.size()) {
+        LOG_ERROR("[VecEnv] Checkpoint of %zu sessions, have %zu", in.games.size(), m_sessions.size());
+        return;
+    }
+    m_pool.parallelFor(m_sessions.size(), [this, &in](size_t i) {
+        Session& s = *m_sessions[i];
+        s.game.restoreState(in.games[i]);
+        s.episode    = in.episodes[i];
+        m_rewards[i] = 0.0f;
+        m_dones[i]   = 0;
+        m_scores[i]  = s.game.score();
+        observe(static_cast<int>(i));
+    });
+}
+
+void VecEnv::observe(int i)
+{
+    if (m_observations.empty()) return;
+    m_sessions[i]->game.writeObservation(
+        m_observations.data() + static_cast<size_t>(i) * m_config.obsWidth * m_config.obsHeight,
+        m_config.obsWidth, m_config.obsHeight);
+}
+
+const uint8_t* VecEnv::observation(int i) const
+{
+    if (m_observations.empty()) return nullptr;
+    return m_observations.data() + static_cast<size_t>(i) * m_config.obsWidth * m_config.obsHeight;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Engine/Engine.hpp"
+#include "Engine/Memory.hpp"
+#include "Engine/TextureManager.hpp"
+#include "Engine/ThreadPool.hpp"
+#include "XenonGame.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ------------------------------------------------------------
+// VecEnv: N independent XenonGame sessions stepped together,
+// for bots and balance sweeps. There are no windows: the
+// sessions share one software renderer only to own the
+// textures and collision masks, which are read-only after
+// init. Each step runs every session on the thread pool.
+// ------------------------------------------------------------
+struct VecEnvConfig {
+    int      count     = 8;
+    unsigned threads   = 0;     // 0: every hardware thread
+    int      frameSkip = 4;     // simulation ticks per step, same input held
+    int      obsWidth  = 0;     // downsampled observation; 0 disables it
+    int      obsHeight = 0;
+    int      width     = 800;   // playfield size
+    int      height    = 600;
+    uint32_t seed      = 1;     // session i uses seed + i
+};
+
+// Every session's state, for rollback and branching
+struct VecEnvCheckpoint {
+    std::vector<GameSnapshot> games;
+    std::vector<uint32_t>     episodes;   // decide the seed of the next restart
+};
+
+class VecEnv {
+public:
+    explicit VecEnv(const VecEnvConfig& config);
+    ~VecEnv();
+
+    VecEnv(const VecEnv&)            = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    // Loads assets and starts every session. Call from the main thread.
+    bool init();
+
+    // Restarts every session with fresh seeds
+    void reset();
+
+    // One action per session. Finished sessions report done and
+    // restart on their own, so the next step starts a new episode.
+    void step(const PlayerInput* actions);
+
+    int count() const { return m_config.count; }
+
+    // Per-session results of the last step
+    const float*   rewards() const { return m_rewards.data(); }   // score gained
+    const uint8_t* dones() const   { return m_dones.data(); }
+    const int*     scores() const  { return m_scores.data(); }    // before any restart
+
+    // Saves or restores every session on the thread pool. A restore
+    // brings back the observations; rewards and dones read zero.
+    void save(VecEnvCheckpoint& out);
+    void restore(const VecEnvCheckpoint& in);
+
+    // obsWidth * obsHeight bytes for session i, or nullptr if disabled
+    const uint8_t* observation(int i) const;
+
+    uint64_t totalSteps() const { return m_totalSteps; }
+
+private:
+    struct Session {
+        explicit Session(uint32_t seed) : game(seed) {}
+
+        XenonGame          game;
+        memory::FrameArena arena{16 * 1024};
+        FrameStats         stats{};
+        uint64_t           tick = 0;
+        uint32_t           episode = 0;
+    };
+
+    void stepSession(int i, const PlayerInput& action);
+    void observe(int i);
+
+    VecEnvConfig m_config;
+    ThreadPool   m_pool;
+
+    SDL_Surface*   m_surface  = nullptr;
+    SDL_Renderer*  m_renderer = nullptr;
+    TextureManager m_textures;
+
+    std::vector<std::unique_ptr<Session>> m_sessions;
+    std::vector<float>   m_rewards;
+    std::vector<uint8_t> m_dones;
+    std::vector<int>     m_scores;
+    std::vector<uint8_t> m_observations;
+    uint64_t             m_totalSteps = 0;
+};
@@ -1,25 +1,108 @@
 #include "XenonGame.hpp"
 #include "ShipPawn.hpp"
-#include "Engine/TextureManager.hpp" 
+#include "Engine/Draw.hpp"
+#include "Engine/Log.hpp"
+#include "Engine/TextureManager.hpp"
 
-#include <iostream>
 #include <random>
 #include <string>
 #include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <type_traits>
 
 namespace {
     constexpr float MISSILE_WIDTH  = 8.0f;
     constexpr float MISSILE_HEIGHT = 16.0f;
     constexpr float MISSILE_SPEED  = 500.0f;
-    
-    std::mt19937 rng{std::random_device{}()};
-    float randomFloat(float min, float max) {
-        std::uniform_real_distribution<float> dist(min, max);
-        return dist(rng);
+
+    // An entity as a script::Tag argument
+    uint64_t packEntity(ecs::Entity e)
+    {
+        return (static_cast<uint64_t>(e.generation) << 32) | e.index;
+    }
+
+    ecs::Entity unpackEntity(uint64_t arg)
+    {
+        return ecs::Entity{static_cast<uint32_t>(arg), static_cast<uint32_t>(arg >> 32)};
+    }
+
+    // Stand-in effects for when there are no sound files: a falling
+    // chirp, filtered noise and a rising arpeggio
+    constexpr float SOUND_PI   = 3.14159265f;
+    constexpr float SOUND_RATE = static_cast<float>(audio::Mixer::SAMPLE_RATE);
+
+    std::vector<float> synthMissile()
+    {
+        std::vector<float> s(static_cast<size_t>(0.12f * SOUND_RATE));
+        float phase = 0.0f;
+        for (size_t i = 0; i < s.size(); ++i) {
+            const float t = i / SOUND_RATE;
+            phase += 2.0f * SOUND_PI * (1400.0f - 7500.0f * t) / SOUND_RATE;
+            s[i] = 0.5f * std::sin(phase) * std::exp(-25.0f * t);
+        }
+        return s;
+    }
+
+    std::vector<float> synthExplosion()
+    {
+        std::vector<float> s(static_cast<size_t>(0.6f * SOUND_RATE));
+        uint32_t noise = 0x1234567u;   // not the game's rng: that would change the simulation
+        float    low   = 0.0f;
+        for (size_t i = 0; i < s.size(); ++i) {
+            const float t = i / SOUND_RATE;
+            noise = noise * 1664525u + 1013904223u;
+            const float white = static_cast<float>(noise >> 8) / 8388608.0f - 1.0f;
+            low += (0.02f + 0.2f * std::exp(-8.0f * t)) * (white - low);
+            s[i] = 0.9f * low * std::exp(-6.0f * t);
+        }
+        return s;
+    }
+
+    std::vector<float> synthPowerUp()
+    {
+        const float notes[] = {523.25f, 659.25f, 783.99f, 1046.5f};
+        const size_t noteLength = static_cast<size_t>(0.07f * SOUND_RATE);
+        std::vector<float> s(noteLength * std::size(notes));
+        for (size_t i = 0; i < s.size(); ++i) {
+            const float t    = (i % noteLength) / SOUND_RATE;
+            const float note = notes[i / noteLength];
+            s[i] = 0.35f * std::sin(2.0f * SOUND_PI * note * t) * std::exp(-20.0f * t);
+        }
+        return s;
     }
 }
 
+XenonGame::XenonGame()
+    : XenonGame(std::random_device{}())
+{
+}
+
+XenonGame::XenonGame(uint32_t seed)
+    : m_rng(seed)
+{
+}
+
+const XenonGame::QualitySettings XenonGame::s_quality[FrameGovernor::LEVEL_COUNT] = {
+    // dust  explosions  galaxy
+    {   3,   1000,       true  },   // full
+    {   3,     32,       true  },   // reduced
+    {   2,     12,       true  },   // low
+    {   0,      4,       false },   // minimal
+};
+
+const XenonGame::DustLayer XenonGame::s_dustLayers[] = {
+    // sprite                count  speed  alpha
+    {"graphics/GDust.bmp",   20,    50.0f, 150},
+    {"graphics/MDust.bmp",   20,    70.0f, 180},
+    {"graphics/SDust.bmp",   20,    90.0f, 210},
+};
+
+float XenonGame::randomFloat(float min, float max) {
+    std::uniform_real_distribution<float> dist(min, max);
+    return dist(m_rng);
+}
+
 XenonGame::~XenonGame() {}
 
 bool XenonGame::init(const EngineContext& ctx)
@@ -34,25 +117,31 @@ bool XenonGame::init(const EngineContext& ctx)
     m_ship.setSpeed(350.0f);
 
     // Projectiles & Effects
-    m_missileTexture         = m_ctx.textures->load("graphics/missile.bmp");
-    m_enemyProjectileTexture = m_ctx.textures->load("graphics/EnWeap6.bmp");
-    m_explosionTexture       = m_ctx.textures->load("graphics/explode64.bmp");
+    m_missileTexture         = m_ctx.textures->load("graphics/missile.bmp", 8, 16);
+    m_enemyProjectileTexture = m_ctx.textures->load("graphics/EnWeap6.bmp", 0, 0);
+    m_explosionTexture       = m_ctx.textures->load("graphics/explode64.bmp", 64, 64);
 
     // Enemies
-    m_lonerTexture  = m_ctx.textures->load("graphics/LonerA.bmp");
-    m_rusherTexture = m_ctx.textures->load("graphics/rusher.bmp");
-    m_bossTexture   = m_ctx.textures->load("graphics/bosseyes2.bmp");
+    m_lonerTexture  = m_ctx.textures->load("graphics/LonerA.bmp", 64, 64);
+    m_rusherTexture = m_ctx.textures->load("graphics/rusher.bmp", 64, 64);
+    m_bossTexture   = m_ctx.textures->load("graphics/bosseyes2.bmp", 0, 0);
 
     // Asteroids
-    m_asteroidSTexture = m_ctx.textures->load("graphics/SAster64.bmp");
-    m_asteroidMTexture = m_ctx.textures->load("graphics/MAster64.bmp"); 
-    m_asteroidGTexture = m_ctx.textures->load("graphics/GAster96.bmp");
+    m_asteroidSTexture = m_ctx.textures->load("graphics/SAster64.bmp", 32, 32);
+    m_asteroidMTexture = m_ctx.textures->load("graphics/MAster64.bmp", 64, 64);
+    m_asteroidGTexture = m_ctx.textures->load("graphics/GAster96.bmp", 96, 96);
+
+    // Sprites drawn stretched get a mask at their draw size
+    if (const CollisionMask* mask = m_ctx.textures->getMask(m_bossTexture))
+        m_bossMask = mask->resampled(0, 128, 128);
+    if (const CollisionMask* mask = m_ctx.textures->getMask(m_enemyProjectileTexture))
+        m_enemyProjectileMask = mask->resampled(0, 8, 8);
 
     // PowerUps
-    m_puWeaponTexture = m_ctx.textures->load("graphics/PUWeapon.bmp");
-    m_puShieldTexture = m_ctx.textures->load("graphics/PUShield.bmp");
-    m_puScoreTexture  = m_ctx.textures->load("graphics/PUScore.bmp");
-    m_puLifeTexture   = m_ctx.textures->load("graphics/PULife.bmp");
+    m_puWeaponTexture = m_ctx.textures->load("graphics/PUWeapon.bmp", 32, 32);
+    m_puShieldTexture = m_ctx.textures->load("graphics/PUShield.bmp", 32, 32);
+    m_puScoreTexture  = m_ctx.textures->load("graphics/PUScore.bmp", 32, 32);
+    m_puLifeTexture   = m_ctx.textures->load("graphics/PULife.bmp", 32, 32);
 
     // UI & Background
     m_fontTexture     = m_ctx.textures->load("graphics/Font8x8.bmp");
@@ -62,44 +151,214 @@ bool XenonGame::init(const EngineContext& ctx)
     if (m_fontTexture) SDL_SetTextureBlendMode(m_fontTexture, SDL_BLENDMODE_BLEND);
 
     // Timers
-    m_lonerSpawnTimer  = 1.0f;
-    m_rusherSpawnTimer = 3.0f;
-    m_asteroidSpawnTimer = 2.0f;
+    m_timers.reset(tick());
+    scheduleTimer(TimerKind::LonerWave, 1.0f);
+    scheduleTimer(TimerKind::RusherWave, 3.0f);
+    scheduleTimer(TimerKind::AsteroidWave, 2.0f);
 
     initDustBackground();
+    defineClips();
+    definePaths();
+    definePatterns();
+    defineSounds();
+    registerSystems();
+
+    if (m_ctx.recorder) {
+        m_entityCounter    = m_ctx.recorder->defineCounter("entities");
+        m_bulletCounter    = m_ctx.recorder->defineCounter("bullets");
+        m_explosionCounter = m_ctx.recorder->defineCounter("explosions");
+    }
 
+    saveState(m_initialState);
     return true;
 }
 
+void XenonGame::registerSystems()
+{
+    m_simulation.add<Transform, const path::Follower>("paths", [this](ecs::World&, float) {
+        followPaths();
+    });
+    m_movement.addTo(m_simulation, "movement");
+    m_culling.addTo(m_simulation, "cull");
+    m_simulation.add(
+        "collisions",
+        ecs::accessOf<const Transform, Health, const Enemy, const PowerUp,
+                      const MissileTag, const EnemyProjectileTag, const AsteroidTag>(),
+        [this](ecs::World&, float) { checkCollisions(); });
+
+    m_effects.add<const Lifetime>("expire", [this](ecs::World&, float dt) {
+        m_expiry.policy<ExpireAt>().now = tick();
+        m_expiry.run(dt);
+    });
+}
+
+uint32_t XenonGame::ticksFor(float seconds)
+{
+    return static_cast<uint32_t>(std::lround(seconds / Engine::s_fixedTimeStep));
+}
+
+void XenonGame::defineClips()
+{
+    m_clips.clear();
+
+    m_missileClip         = m_clips.still({0.0f, 0.0f, 8.0f, 16.0f});
+    m_enemyProjectileClip = m_clips.still({});
+    m_lonerClip           = m_clips.still({0.0f, 0.0f, 64.0f, 64.0f});
+    m_rusherClip          = m_clips.still({0.0f, 0.0f, 64.0f, 64.0f});
+
+    const uint32_t asteroidTicks = ticksFor(0.05f);
+    m_asteroidSClip = m_clips.define(m_asteroidSTexture, 32, 32, 0, 16, asteroidTicks, true);
+    m_asteroidMClip = m_clips.define(m_asteroidMTexture, 64, 64, 0, 16, asteroidTicks, true);
+    m_asteroidGClip = m_clips.define(m_asteroidGTexture, 96, 96, 0, 16, asteroidTicks, true);
+
+    const uint32_t powerUpTicks = ticksFor(0.1f);
+    m_puWeaponClip = m_clips.define(m_puWeaponTexture, 32, 32, 0, 8, powerUpTicks, true);
+    m_puShieldClip = m_clips.define(m_puShieldTexture, 32, 32, 0, 8, powerUpTicks, true);
+    m_puScoreClip  = m_clips.define(m_puScoreTexture, 32, 32, 0, 8, powerUpTicks, true);
+    m_puLifeClip   = m_clips.define(m_puLifeTexture, 32, 32, 0, 8, powerUpTicks, true);
+
+    m_explosionClip = m_clips.define(m_explosionTexture, 64, 64, 0, 8, ticksFor(0.05f), false);
+
+    // draw only what each frame covers
+    const std::pair<anim::ClipId, SDL_Texture*> sheets[] = {
+        {m_missileClip, m_missileTexture},     {m_lonerClip, m_lonerTexture},
+        {m_rusherClip, m_rusherTexture},       {m_asteroidSClip, m_asteroidSTexture},
+        {m_asteroidMClip, m_asteroidMTexture}, {m_asteroidGClip, m_asteroidGTexture},
+        {m_puWeaponClip, m_puWeaponTexture},   {m_puShieldClip, m_puShieldTexture},
+        {m_puScoreClip, m_puScoreTexture},     {m_puLifeClip, m_puLifeTexture},
+        {m_explosionClip, m_explosionTexture},
+    };
+    for (const auto& [clip, texture] : sheets) {
+        if (const SpriteSheet* sheet = m_ctx.textures->getSheet(texture)) m_clips.trim(clip, *sheet);
+    }
+}
+
+// Curves are stored as offsets from the spawn point, sampled per tick
+void XenonGame::definePaths()
+{
+    m_paths.clear();
+
+    // Loners cross the screen in ~10 s, weaving and drifting down
+    const uint32_t sweepTicks = ticksFor(10.0f);
+    m_lonerSweepRight = m_paths.sineSweep( 1000.0f, 200.0f, 40.0f, 2.0f, sweepTicks);
+    m_lonerSweepLeft  = m_paths.sineSweep(-1000.0f, 200.0f, 40.0f, 2.0f, sweepTicks);
+
+    // Rushers dive through the screen in an S, past the bottom cull line
+    const SDL_FPoint dive[] = {{0.0f, 0.0f}, {0.0f, 180.0f}, {60.0f, 380.0f}, {-40.0f, 560.0f}, {0.0f, 800.0f}};
+    SDL_FPoint mirrored[std::size(dive)];
+    for (size_t i = 0; i < std::size(dive); ++i) mirrored[i] = SDL_FPoint{-dive[i].x, dive[i].y};
+    m_rusherDiveRight = m_paths.spline(dive, std::size(dive), ticksFor(2.6f));
+    m_rusherDiveLeft  = m_paths.spline(mirrored, std::size(mirrored), ticksFor(2.6f));
+}
+
+// The boss fight: an aimed fan, a slow spiral and a ring whose
+// bullets burst into smaller rings on the way down
+void XenonGame::definePatterns()
+{
+    bullet::Pattern fan;
+    fan.shape    = bullet::Shape::Fan;
+    fan.aimed    = true;
+    fan.count    = 5;
+    fan.speed    = 260.0f;
+    fan.spread   = 40.0f;
+    fan.interval = ticksFor(1.5f);
+    fan.volleys  = 0;
+    fan.color    = SDL_FColor{1.0f, 0.8f, 0.4f, 1.0f};
+    m_bossFan = m_bullets.define(fan);
+
+    bullet::Pattern spiral;
+    spiral.count    = 4;
+    spiral.speed    = 150.0f;
+    spiral.spin     = 9.0f;
+    spiral.interval = ticksFor(0.1f);
+    spiral.volleys  = 0;
+    spiral.color    = SDL_FColor{1.0f, 0.5f, 0.9f, 1.0f};
+    m_bossSpiral = m_bullets.define(spiral);
+
+    bullet::Pattern shard;
+    shard.count  = 6;
+    shard.speed  = 90.0f;
+    shard.size   = 6.0f;
+    shard.radius = 2.0f;
+    shard.color  = SDL_FColor{0.6f, 0.9f, 1.0f, 1.0f};
+    m_bossShard = m_bullets.define(shard);
+
+    bullet::Pattern splitter;
+    splitter.count      = 8;
+    splitter.speed      = 120.0f;
+    splitter.interval   = ticksFor(3.0f);
+    splitter.volleys    = 0;
+    splitter.size       = 10.0f;
+    splitter.radius     = 4.0f;
+    splitter.color      = SDL_FColor{0.6f, 0.9f, 1.0f, 1.0f};
+    splitter.child      = m_bossShard;
+    splitter.childDelay = ticksFor(0.8f);
+    m_bossSplitter = m_bullets.define(splitter);
+}
+
+void XenonGame::defineSounds()
+{
+    if (!m_ctx.audio) return;
+
+    auto define = [this](const char* path, std::vector<float> (*synth)()) {
+        audio::SoundId id = audio::NoSound;
+        if (SDL_GetPathInfo(path, nullptr)) id = m_ctx.audio->load(path);
+        if (id == audio::NoSound) {
+            const std::vector<float> samples = synth();
+            id = m_ctx.audio->add(samples.data(), samples.size());
+        }
+        return id;
+    };
+    m_missileSound   = define("sounds/missile.wav", synthMissile);
+    m_explosionSound = define("sounds/explosion.wav", synthExplosion);
+    m_powerUpSound   = define("sounds/powerup.wav", synthPowerUp);
+}
+
+// Panned by the screen position of whatever made the sound
+void XenonGame::playSound(audio::SoundId sound, float x, float volume, uint8_t priority)
+{
+    if (!m_ctx.audio || sound == audio::NoSound) return;
+    const float pan = m_ctx.width > 0 ? std::clamp(x / m_ctx.width * 2.0f - 1.0f, -1.0f, 1.0f) * 0.7f : 0.0f;
+    m_ctx.audio->play(sound, volume, pan, priority);
+}
+
+// Every path follower in one batched pass per chunk
+void XenonGame::followPaths()
+{
+    const uint64_t now = tick();
+    m_followers.eachChunk([this, now](uint32_t count, const ecs::Entity*, Transform* transforms,
+                                      const path::Follower* followers) {
+        if (m_pathPositions.size() < count) m_pathPositions.resize(count);
+        m_paths.evaluate(count, followers, now, m_pathPositions.data());
+        for (uint32_t i = 0; i < count; ++i) {
+            transforms[i].rect.x = m_pathPositions[i].x;
+            transforms[i].rect.y = m_pathPositions[i].y;
+        }
+    });
+}
+
 void XenonGame::handleEvent(const SDL_Event& e, bool& running)
 {
-    if (m_gameState == GameState::GameOver && e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_R) {
-        // Reset Game
-        m_gameState = GameState::Playing;
-        m_lives = 3;
-        m_score = 0;
-        m_weaponLevel = 0;
-        m_hasShield = false;
-        m_enemies.clear();
-        m_asteroids.clear();
-        m_missiles.clear();
-        m_enemyProjectiles.clear();
-        m_powerups.clear();
-        m_ship.setPosition(m_ctx.width/2.0f - 32.0f, m_ctx.height - 100.0f);
-        m_ship.kill(); // Resurrect
+    // R starts over from either end screen
+    if (finished() && e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_R) {
+        restart();
         return;
     }
 
     switch (e.type) {
+    case SDL_EVENT_WINDOW_MINIMIZED:
+        if (!finished()) m_paused = true;
+        break;
     case SDL_EVENT_KEY_DOWN:
         if (e.key.repeat) break;
         switch (e.key.key) {
         case SDLK_ESCAPE: running = false; break;
+        case SDLK_P: if (!finished()) m_paused = !m_paused; break;
         case SDLK_LEFT:  case SDLK_A: m_ship.setMoveLeft(true); break;
         case SDLK_RIGHT: case SDLK_D: m_ship.setMoveRight(true); break;
         case SDLK_UP:    case SDLK_W: m_ship.setMoveUp(true); break;
         case SDLK_DOWN:  case SDLK_S: m_ship.setMoveDown(true); break;
-        case SDLK_SPACE: fireMissile(); break;
+        case SDLK_SPACE: if (!m_paused) fireMissile(); break;
         }
         break;
     case SDL_EVENT_KEY_UP:
@@ -113,17 +372,75 @@ void XenonGame::handleEvent(const SDL_Event& e, bool& running)
     }
 }
 
+void XenonGame::restart()
+{
+    // back to the state init() left, but keep the random stream
+    // going so the next round plays differently
+    const std::mt19937 rng = m_rng;
+    restoreState(m_initialState);
+    m_rng = rng;
+    m_paused = false;
+}
+
+void XenonGame::reset(uint32_t seed)
+{
+    m_rng.seed(seed);
+    restart();
+}
+
+void XenonGame::applyInput(const PlayerInput& input)
+{
+    m_ship.setMoveLeft(input.moveX < 0);
+    m_ship.setMoveRight(input.moveX > 0);
+    m_ship.setMoveUp(input.moveY < 0);
+    m_ship.setMoveDown(input.moveY > 0);
+    if (input.fire) fireMissile();
+}
+
+// Coarse picture of the playfield: every entity's box filled with a
+// per-kind intensity, later layers on top. out is width * height bytes.
+void XenonGame::writeObservation(uint8_t* out, int width, int height)
+{
+    std::fill(out, out + static_cast<size_t>(width) * height, uint8_t{0});
+
+    const float sx = (float)width / m_ctx.width;
+    const float sy = (float)height / m_ctx.height;
+    auto fill = [&](const SDL_FRect& r, uint8_t value) {
+        const int x0 = std::clamp((int)std::floor(r.x * sx), 0, width);
+        const int y0 = std::clamp((int)std::floor(r.y * sy), 0, height);
+        const int x1 = std::clamp((int)std::ceil((r.x + r.w) * sx), 0, width);
+        const int y1 = std::clamp((int)std::ceil((r.y + r.h) * sy), 0, height);
+        if (x1 <= x0) return;
+        for (int y = y0; y < y1; ++y) {
+            std::fill(out + (size_t)y * width + x0, out + (size_t)y * width + x1, value);
+        }
+    };
+
+    m_powerups.each([&](ecs::Entity, const Transform& t, const PowerUp&) { fill(t.rect, 48); });
+    m_asteroids.each([&](ecs::Entity, const Transform& t, auto&...) { fill(t.rect, 96); });
+    m_enemies.each([&](ecs::Entity, const Transform& t, auto&...) { fill(t.rect, 144); });
+    if (m_boss.active) fill(m_boss.rect, 144);
+    m_missiles.each([&](ecs::Entity, const Transform& t, auto&...) { fill(t.rect, 32); });
+    m_enemyProjectiles.each([&](ecs::Entity, const Transform& t, auto&...) { fill(t.rect, 192); });
+    m_bullets.forEachRect([&](const SDL_FRect& r) { fill(r, 192); });
+    fill(m_ship.getRect(), 255);
+}
+
 void XenonGame::update(float dt)
 {
-    updateDust(dt);
-    updateExplosions(dt);
+    updateQuality();
+
+    // spawns queued by input handling
+    m_world.flush();
+
+    m_parallax.scroll(dt);
+    if (m_paused) return;
+
+    m_effects.run(m_world, dt);
 
     if (m_gameState == GameState::GameOver || m_gameState == GameState::Victory) return;
 
-    if (m_hasShield) {
-        m_shieldTimer -= dt;
-        if (m_shieldTimer <= 0.0f) m_hasShield = false;
-    }
+    m_timers.advance(tick(), [this](timer::TimerId, const timer::Timer& t) { onTimer(t); });
 
     m_ship.update(dt);
     
@@ -135,28 +452,7 @@ void XenonGame::update(float dt)
     if (r.y + r.h > m_ctx.height) r.y = m_ctx.height - r.h;
     m_ship.setPosition(r.x, r.y);
 
-    if (m_missileCooldown > 0.0f) m_missileCooldown -= dt;
-
-    // Spawning logic
     if (m_gameState == GameState::Playing) {
-        m_lonerSpawnTimer -= dt;
-        if (m_lonerSpawnTimer <= 0) {
-            spawnLoner();
-            m_lonerSpawnTimer = 2.0f;
-        }
-
-        m_rusherSpawnTimer -= dt;
-        if (m_rusherSpawnTimer <= 0) {
-            spawnRusher();
-            m_rusherSpawnTimer = 4.0f;
-        }
-
-        m_asteroidSpawnTimer -= dt;
-        if (m_asteroidSpawnTimer <= 0) {
-            spawnAsteroid();
-            m_asteroidSpawnTimer = randomFloat(1.5f, 3.5f);
-        }
-
         // Boss trigger (Score based or just random for demo)
         if (m_score > 2000) { 
             m_gameState = GameState::BossFight;
@@ -164,56 +460,92 @@ void XenonGame::update(float dt)
         }
     }
     else if (m_gameState == GameState::BossFight) {
-        updateBoss(dt);
+        updateBoss();
     }
+    m_scripts.run(tick());
+    updateBullets(dt);
+
+    m_simulation.run(m_world, dt);
+    publishCounters();
+}
+
+// What a hitch dump shows next to the timings
+void XenonGame::publishCounters()
+{
+    if (!m_ctx.recorder) return;
+    m_ctx.recorder->setCounter(m_entityCounter, static_cast<uint32_t>(m_world.entityCount()));
+    m_ctx.recorder->setCounter(m_bulletCounter, static_cast<uint32_t>(m_bullets.size()));
+    m_ctx.recorder->setCounter(m_explosionCounter, static_cast<uint32_t>(m_expiry.count()));
+}
 
-    updateMissiles(dt);
-    updateEnemies(dt);
-    updateAsteroids(dt);
-    updateEnemyProjectiles(dt);
-    updatePowerUps(dt);
+// Full rate while anything but the dust moves: play, and the last
+// explosions after it ends. Otherwise the engine can idle; on either
+// end screen the idle wait returns for the R that restarts.
+FramePacing XenonGame::pacing()
+{
+    const bool still = m_paused || (finished() && m_expiry.count() == 0);
+    if (!still) return {};
+    return {false, quality().dustLayers > 0 ? IDLE_DUST_HZ : IDLE_STILL_HZ};
+}
 
-    checkCollisions();
+// What tools/export_reader and other shared memory readers see
+void XenonGame::exportState(shm::GameState& out)
+{
+    const SDL_FRect ship = m_ship.getRect();
+    out.phase    = static_cast<int32_t>(m_gameState);
+    out.score    = m_score;
+    out.lives    = m_lives;
+    out.shipX    = ship.x;
+    out.shipY    = ship.y;
+    out.shipW    = ship.w;
+    out.shipH    = ship.h;
+    out.entities = static_cast<uint32_t>(m_world.entityCount());
+    out.enemies  = static_cast<uint32_t>(m_enemies.count());
+    out.bullets  = static_cast<uint32_t>(m_bullets.size());
+}
+
+// Follows the engine's frame governor; logs what each change cuts
+void XenonGame::updateQuality()
+{
+    const int level = m_ctx.stats ? std::clamp(m_ctx.stats->quality, 0, FrameGovernor::LEVEL_COUNT - 1) : 0;
+    if (level == m_qualityLevel) return;
+
+    m_qualityLevel = level;
+    const QualitySettings& q = quality();
+    LOG_INFO("[XenonGame] Quality %s: %d/%zu dust layers, at most %d explosions, galaxy %s",
+             FrameGovernor::levelName(level), q.dustLayers, m_parallax.layerCount(), q.maxExplosions,
+             q.galaxy ? "on" : "off");
 }
 
 void XenonGame::render(SDL_Renderer* r)
 {
-    if (m_galaxyTexture) SDL_RenderTexture(r, m_galaxyTexture, nullptr, nullptr);
-    renderDust(r);
+    if (m_galaxyTexture && quality().galaxy) draw::texture(r, m_galaxyTexture, nullptr, nullptr);
+    m_parallax.render(r, static_cast<size_t>(quality().dustLayers));
 
-    renderAsteroids(r);
-    renderPowerUps(r);
-    renderEnemies(r);
+    renderSprites(r, SpriteLayer::Asteroid);
+    renderSprites(r, SpriteLayer::PowerUp);
+    renderSprites(r, SpriteLayer::Enemy);
     if (m_gameState == GameState::BossFight) renderBoss(r);
     
-    m_ship.render(r);
+    if (!m_gameOver) m_ship.render(r);
 
     if (m_hasShield) {
         SDL_SetRenderDrawColor(r, 0, 200, 255, 100);
         SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_BLEND);
         SDL_FRect sr = m_ship.getRect();
         sr.x -= 5; sr.y -= 5; sr.w += 10; sr.h += 10;
-        SDL_RenderFillRect(r, &sr);
+        draw::fillRect(r, &sr);
         SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_NONE);
     }
 
-    renderMissiles(r);
-    renderEnemyProjectiles(r);
-    renderExplosions(r);
+    renderSprites(r, SpriteLayer::Missile);
+    renderSprites(r, SpriteLayer::EnemyProjectile);
+    renderBullets(r);
+    renderSprites(r, SpriteLayer::Explosion);
     renderHUD(r);
 
-    renderDust(r);
-    if (!m_gameOver) m_ship.render(r);
-    renderEnemies(r);
-    renderEnemyProjectiles(r);
-    renderMissiles(r);
-    renderExplosions(r);
-
-    std::string scoreStr = "SCORE: " + std::to_string(m_score);
-    renderText(r, scoreStr, 10.0f, 10.0f);
-
     if (m_gameOver) {
-        std::string overMsg = "GAME OVER";
+        std::string_view overMsg = "GAME OVER";
         // Jednoduché vycentrovanie (ak je okno 640 široké)
         float cx = (m_ctx.width / 2.0f) - ((overMsg.length() * 8.0f) / 2.0f);
         float cy = (m_ctx.height / 2.0f) - 4.0f;
@@ -222,7 +554,7 @@ void XenonGame::render(SDL_Renderer* r)
 }
 
 // Helper to render text using a font texture (independent of XenonGame class)
-static void renderTextHelper(SDL_Renderer* renderer, SDL_Texture* fontTexture, const std::string& text, float x, float y, float scale) {
+static void renderTextHelper(SDL_Renderer* renderer, SDL_Texture* fontTexture, std::string_view text, float x, float y, float scale) {
     if (!fontTexture) return;
 
     for (size_t i = 0; i < text.length(); ++i) {
@@ -242,251 +574,284 @@ static void renderTextHelper(SDL_Renderer* renderer, SDL_Texture* fontTexture, c
             8.0f * scale 
         };
 
-        SDL_RenderTexture(renderer, fontTexture, &src, &dst);
+        draw::texture(renderer, fontTexture, &src, &dst);
     }
 }
 
 // --- Logic ---
 
+void XenonGame::renderSprites(SDL_Renderer* r, SpriteLayer layer) {
+    DrawSprites& drawing = m_spriteDrawing.policy<DrawSprites>();
+    drawing.renderer = r;
+    drawing.layer    = layer;
+    drawing.now      = tick();
+    m_spriteDrawing.run(0.0f);
+}
+
 void XenonGame::fireMissile() {
-    if (m_missileCooldown > 0.0f) return;
+    if (tick() < m_missileReadyTick) return;
     
     SDL_FRect shipRect = m_ship.getRect();
     float centerX = shipRect.x + shipRect.w * 0.5f - MISSILE_WIDTH * 0.5f;
     float topY    = shipRect.y - MISSILE_HEIGHT;
 
     auto spawn = [&](float offX, float velX) {
-        Missile m;
-        m.rect = {centerX + offX, topY, MISSILE_WIDTH, MISSILE_HEIGHT};
-        m.src = {0, 0, 8, 16}; // Assume first frame of missile strip
-        m.speedY = -MISSILE_SPEED;
-        m.speedX = velX;
-        m.alive = true;
-        m_missiles.push_back(m);
+        CullBounds bounds;
+        bounds.minY = 0.0f;
+        m_world.createDeferred(
+            Transform{{centerX + offX, topY, MISSILE_WIDTH, MISSILE_HEIGHT}},
+            Velocity{velX, -MISSILE_SPEED},
+            Sprite{m_missileTexture, tick(), m_missileClip, SpriteLayer::Missile},
+            Collider{m_ctx.textures->getMask(m_missileTexture)},
+            bounds,
+            MissileTag{});
     };
 
     spawn(0.0f, 0.0f);
     if (m_weaponLevel >= 1) { spawn(-15.0f, -50.0f); spawn(15.0f, 50.0f); }
     if (m_weaponLevel >= 2) { spawn(-30.0f, -150.0f); spawn(30.0f, 150.0f); }
 
-    m_missileCooldown = 0.15f;
+    playSound(m_missileSound, shipRect.x + shipRect.w * 0.5f, 0.4f, 0);
+    m_missileReadyTick = tick() + ticksFor(0.15f);
 }
 
-void XenonGame::updateMissiles(float dt) {
-    for (auto& m : m_missiles) {
-        if (!m.alive) continue;
-        m.rect.y += m.speedY * dt;
-        m.rect.x += m.speedX * dt;
-        if (m.rect.y + m.rect.h < 0) m.alive = false;
-    }
-    m_missiles.erase(std::remove_if(m_missiles.begin(), m_missiles.end(), [](auto& m){ return !m.alive; }), m_missiles.end());
+// Timers
+void XenonGame::scheduleTimer(TimerKind kind, float seconds) {
+    m_timers.schedule(m_timers.now() + ticksFor(seconds), {static_cast<uint16_t>(kind), 0});
 }
 
-void XenonGame::renderMissiles(SDL_Renderer* r) {
-    if(!m_missileTexture) return;
-    for (const auto& m : m_missiles) SDL_RenderTexture(r, m_missileTexture, &m.src, &m.rect);
+// Waves stop when the boss arrives; each reschedules itself from the
+// tick it was due, so waves keep their spacing whatever the frame rate
+void XenonGame::onTimer(const timer::Timer& t) {
+    const bool playing = m_gameState == GameState::Playing;
+    switch (static_cast<TimerKind>(t.kind)) {
+        case TimerKind::LonerWave:
+            if (!playing) break;
+            spawnLoner();
+            scheduleTimer(TimerKind::LonerWave, 2.0f);
+            break;
+        case TimerKind::RusherWave:
+            if (!playing) break;
+            spawnRusher();
+            scheduleTimer(TimerKind::RusherWave, 4.0f);
+            break;
+        case TimerKind::AsteroidWave:
+            if (!playing) break;
+            spawnAsteroid();
+            scheduleTimer(TimerKind::AsteroidWave, randomFloat(1.5f, 3.5f));
+            break;
+        case TimerKind::ShieldOff:
+            m_hasShield = false;
+            break;
+    }
 }
 
 // Enemies
 void XenonGame::spawnLoner() {
     if(!m_lonerTexture) return;
-    Enemy e;
-    e.type = EnemyType::Loner;
-    e.src = {0.0f, 0.0f, 64.0f, 64.0f};
-    e.rect = {0.0f, 80.0f, 64.0f, 64.0f};
     bool left = (randomFloat(0,1) > 0.5f);
-    e.rect.x = left ? -70.0f : m_ctx.width + 10.0f;
-    e.speedX = left ? 100.0f : -100.0f;
-    e.speedY = 20.0f; e.hp = 2; e.alive = true; e.shootTimer = 1.0f;
-    m_enemies.push_back(e);
+    SDL_FRect rect = {left ? -70.0f : m_ctx.width + 10.0f, 80.0f, 64.0f, 64.0f};
+    const ecs::Entity e = m_world.create(
+        Transform{rect},
+        path::Follower{rect.x, rect.y, tick(), left ? m_lonerSweepRight : m_lonerSweepLeft},
+        Sprite{m_lonerTexture, tick(), m_lonerClip, SpriteLayer::Enemy},
+        Collider{m_ctx.textures->getMask(m_lonerTexture)},
+        CullBounds{-100.0f, -1.0e9f, m_ctx.width + 100.0f, m_ctx.height + 100.0f},
+        Health{2},
+        Enemy{EnemyType::Loner});
+    m_scripts.start([&] { return lonerFire(e); }, tick() + m_scripts.ticksFor(1.0f),
+                    script::Tag{static_cast<uint16_t>(ScriptKind::LonerFire), packEntity(e)});
 }
 
 void XenonGame::spawnRusher() {
     if(!m_rusherTexture) return;
-    Enemy e;
-    e.type = EnemyType::Rusher;
-    e.src = {0.0f, 0.0f, 64.0f, 64.0f};
-    e.rect = {randomFloat(50.0f, m_ctx.width - 100.0f), -70.0f, 64.0f, 64.0f};
-    e.speedY = 300.0f; e.hp = 1; e.alive = true;
-    m_enemies.push_back(e);
-}
-
-void XenonGame::updateEnemies(float dt) {
-    for (auto& e : m_enemies) {
-        if (!e.alive) continue;
-        e.rect.x += e.speedX * dt;
-        e.rect.y += e.speedY * dt;
-        if (e.type == EnemyType::Loner) {
-            e.shootTimer -= dt;
-            if (e.shootTimer <= 0) {
-                fireEnemyProjectile(e.rect, 250.0f);
-                e.shootTimer = 1.5f;
-            }
-        }
-        if (e.rect.y > m_ctx.height + 100 || e.rect.x < -100 || e.rect.x > m_ctx.width + 100) e.alive = false;
-    }
-    m_enemies.erase(std::remove_if(m_enemies.begin(), m_enemies.end(), [](auto& e){ return !e.alive; }), m_enemies.end());
+    SDL_FRect rect = {randomFloat(50.0f, m_ctx.width - 100.0f), -70.0f, 64.0f, 64.0f};
+    const bool right = (m_rng() & 1) != 0;
+    m_world.createDeferred(
+        Transform{rect},
+        path::Follower{rect.x, rect.y, tick(), right ? m_rusherDiveRight : m_rusherDiveLeft},
+        Sprite{m_rusherTexture, tick(), m_rusherClip, SpriteLayer::Enemy},
+        Collider{m_ctx.textures->getMask(m_rusherTexture)},
+        CullBounds{-100.0f, -1.0e9f, m_ctx.width + 100.0f, m_ctx.height + 100.0f},
+        Health{1},
+        Enemy{EnemyType::Rusher});
 }
 
-void XenonGame::renderEnemies(SDL_Renderer* r) {
-    for (const auto& e : m_enemies) {
-        SDL_Texture* t = (e.type == EnemyType::Rusher) ? m_rusherTexture : m_lonerTexture;
-        SDL_RenderTexture(r, t, &e.src, &e.rect);
+// Fires until the loner is destroyed or culled
+script::Task XenonGame::lonerFire(ecs::Entity self) {
+    while (const Transform* t = m_world.get<Transform>(self)) {
+        fireEnemyProjectile(t->rect, 250.0f);
+        co_await script::wait(1.5f);
     }
 }
 
 // Projectiles
 void XenonGame::fireEnemyProjectile(const SDL_FRect& sourceRect, float speedY, float speedX) {
     if(!m_enemyProjectileTexture) return;
-    EnemyProjectile p;
-    p.rect = {sourceRect.x + sourceRect.w/2 - 4.0f, sourceRect.y + sourceRect.h, 8.0f, 8.0f};
-    p.speedY = speedY; p.speedX = speedX; p.alive = true;
-    m_enemyProjectiles.push_back(p);
-}
-
-void XenonGame::updateEnemyProjectiles(float dt) {
-    for (auto& p : m_enemyProjectiles) {
-        p.rect.x += p.speedX * dt;
-        p.rect.y += p.speedY * dt;
-        if (p.rect.y > m_ctx.height) p.alive = false;
-    }
-    m_enemyProjectiles.erase(std::remove_if(m_enemyProjectiles.begin(), m_enemyProjectiles.end(), [](auto& p){ return !p.alive; }), m_enemyProjectiles.end());
-}
-
-void XenonGame::renderEnemyProjectiles(SDL_Renderer* r) {
-    if(!m_enemyProjectileTexture) return;
-    for(const auto& p : m_enemyProjectiles) SDL_RenderTexture(r, m_enemyProjectileTexture, nullptr, &p.rect);
+    CullBounds bounds;
+    bounds.maxY = (float)m_ctx.height;
+    m_world.createDeferred(
+        Transform{{sourceRect.x + sourceRect.w/2 - 4.0f, sourceRect.y + sourceRect.h, 8.0f, 8.0f}},
+        Velocity{speedX, speedY},
+        Sprite{m_enemyProjectileTexture, tick(), m_enemyProjectileClip, SpriteLayer::EnemyProjectile},
+        Collider{m_enemyProjectileMask.empty() ? nullptr : &m_enemyProjectileMask},
+        bounds,
+        EnemyProjectileTag{});
 }
 
 // Asteroids
 void XenonGame::spawnAsteroid() {
-    Asteroid a;
-    int type = rand() % 3;
+    int type = static_cast<int>(m_rng() % 3);
     float x = randomFloat(0.0f, m_ctx.width - 50.0f);
-    a.animTimer = 0.0f; a.currentFrame = 0; a.totalFrames = 16; 
 
+    SDL_Texture* tex;
+    anim::ClipId clip;
+    float size;
+    int hp;
     if (type == 0 && m_asteroidSTexture) {
-        a.size = AsteroidSize::Small;
-        a.rect = {x, -64.0f, 32.0f, 32.0f};
-        a.src = {0.0f, 0.0f, 32.0f, 32.0f};
-        a.hp = 2;
+        tex = m_asteroidSTexture; clip = m_asteroidSClip; size = 32.0f; hp = 2;
     } else if (type == 1 && m_asteroidMTexture) {
-        a.size = AsteroidSize::Medium;
-        a.rect = {x, -64.0f, 64.0f, 64.0f};
-        a.src = {0.0f, 0.0f, 64.0f, 64.0f};
-        a.hp = 4;
+        tex = m_asteroidMTexture; clip = m_asteroidMClip; size = 64.0f; hp = 4;
     } else {
-        a.size = AsteroidSize::Large;
-        a.rect = {x, -96.0f, 96.0f, 96.0f};
-        a.src = {0.0f, 0.0f, 96.0f, 96.0f};
-        a.hp = 8;
+        tex = m_asteroidGTexture; clip = m_asteroidGClip; size = 96.0f; hp = 8;
     }
-    a.speedY = randomFloat(80.0f, 150.0f); a.alive = true;
-    m_asteroids.push_back(a);
-}
-
-void XenonGame::updateAsteroids(float dt) {
-    for(auto& a : m_asteroids) {
-        a.rect.y += a.speedY * dt;
-        a.animTimer += dt;
-        if (a.animTimer > 0.05f) {
-            a.animTimer = 0.0f;
-            a.currentFrame = (a.currentFrame + 1) % a.totalFrames;
-            a.src.x = (float)a.currentFrame * a.src.w; // Shift source rect x
-        }
-        if(a.rect.y > m_ctx.height + 100) a.alive = false;
-    }
-    m_asteroids.erase(std::remove_if(m_asteroids.begin(), m_asteroids.end(), [](auto& a){ return !a.alive; }), m_asteroids.end());
-}
 
-void XenonGame::renderAsteroids(SDL_Renderer* r) {
-    for(const auto& a : m_asteroids) {
-        SDL_Texture* t = nullptr;
-        if(a.size == AsteroidSize::Small) t = m_asteroidSTexture;
-        else if(a.size == AsteroidSize::Medium) t = m_asteroidMTexture;
-        else t = m_asteroidGTexture;
-        if(t) SDL_RenderTexture(r, t, &a.src, &a.rect);
-    }
+    CullBounds bounds;
+    bounds.maxY = m_ctx.height + 100.0f;
+    m_world.createDeferred(
+        Transform{{x, -std::max(size, 64.0f), size, size}},
+        Velocity{0.0f, randomFloat(80.0f, 150.0f)},
+        Sprite{tex, tick(), clip, SpriteLayer::Asteroid},
+        Collider{m_ctx.textures->getMask(tex)},
+        bounds,
+        Health{hp},
+        AsteroidTag{});
 }
 
 // Boss
 void XenonGame::spawnBoss() {
     m_boss.maxHp = 100; m_boss.hp = m_boss.maxHp;
     m_boss.rect = {m_ctx.width/2.0f - 64.0f, -150.0f, 128.0f, 128.0f};
-    m_boss.active = true; m_boss.dirX = 100.0f; m_boss.shootTimer = 2.0f;
-    m_enemies.clear(); m_asteroids.clear();
+    m_boss.active = true;
+    m_boss.glide = path::Glide{m_boss.rect.x, m_boss.rect.y, m_boss.rect.x, m_boss.rect.y, tick(), tick()};
+    m_bullets.clear();
+    m_scripts.stopAll();
+    m_enemies.each([this](ecs::Entity e, auto&...) { m_world.destroyDeferred(e); });
+    m_asteroids.each([this](ecs::Entity e, auto&...) { m_world.destroyDeferred(e); });
+    m_world.flush();
+    m_scripts.start([this] { return bossScript(); }, tick(), script::Tag{static_cast<uint16_t>(ScriptKind::Boss), 0});
 }
 
-void XenonGame::updateBoss(float dt) {
-    if(!m_boss.active) return;
-    if(m_boss.rect.y < 50.0f) m_boss.rect.y += 50.0f * dt;
-    else {
-        m_boss.rect.x += m_boss.dirX * dt;
-        if(m_boss.rect.x < 0 || m_boss.rect.x + m_boss.rect.w > m_ctx.width) m_boss.dirX *= -1.0f;
-        m_boss.shootTimer -= dt;
-        if(m_boss.shootTimer <= 0) {
-            fireEnemyProjectile(m_boss.rect, 300.0f, 0.0f);
-            fireEnemyProjectile(m_boss.rect, 250.0f, -100.0f);
-            fireEnemyProjectile(m_boss.rect, 250.0f, 100.0f);
-            m_boss.shootTimer = 1.5f;
+// Descends into place, opens fire, then sweeps from wall to wall.
+// Restarted from a snapshot it skips whatever the boss has done
+// already: the descent once it is in place, patterns still running.
+script::Task XenonGame::bossScript() {
+    if (m_boss.rect.y < BOSS_Y) {
+        co_await moveTo(m_boss.glide, m_boss.rect.x, BOSS_Y, (BOSS_Y - m_boss.rect.y) / 50.0f);
+    }
+
+    const bullet::PatternId patterns[] = {m_bossFan, m_bossSpiral, m_bossSplitter};
+    while (m_boss.active) {
+        for (size_t i = 0; i < std::size(patterns); ++i) {
+            if (!m_bullets.running(m_bossEmitters[i])) m_bossEmitters[i] = fire(patterns[i]);
         }
+
+        // to the far wall, at 100 px/s
+        const float toRight = m_ctx.width - m_boss.rect.w;
+        const float x = m_boss.rect.x + m_boss.rect.w * 0.5f < m_ctx.width * 0.5f ? toRight : 0.0f;
+        co_await moveTo(m_boss.glide, x, m_boss.rect.y, std::abs(x - m_boss.rect.x) / 100.0f);
+    }
+}
+
+script::Wait XenonGame::moveTo(path::Glide& glide, float x, float y, float seconds) {
+    const uint64_t now = tick();
+    const SDL_FPoint from = glide.position(now);
+    glide = path::Glide{from.x, from.y, x, y, now, now + m_scripts.ticksFor(seconds)};
+    return script::waitTicks(glide.endTick - now);
+}
+
+// Emitters sit at the boss's mouth; updateBoss() keeps them there
+bullet::EmitterId XenonGame::fire(bullet::PatternId pattern) {
+    const float gunX = m_boss.rect.x + m_boss.rect.w * 0.5f;
+    const float gunY = m_boss.rect.y + m_boss.rect.h * 0.75f;
+    return m_bullets.start(pattern, gunX, gunY, tick());
+}
+
+script::Task XenonGame::makeScript(script::Tag tag) {
+    switch (static_cast<ScriptKind>(tag.kind)) {
+    case ScriptKind::LonerFire: return lonerFire(unpackEntity(tag.arg));
+    case ScriptKind::Boss:      return bossScript();
     }
+    LOG_WARN("[XenonGame] Unknown script kind %u in snapshot", static_cast<unsigned>(tag.kind));
+    return {};
+}
+
+// Where the boss goes is bossScript()'s business; this only follows it
+void XenonGame::updateBoss() {
+    if(!m_boss.active) return;
+    const SDL_FPoint at = m_boss.glide.position(tick());
+    m_boss.rect.x = at.x;
+    m_boss.rect.y = at.y;
+
+    const float gunX = m_boss.rect.x + m_boss.rect.w * 0.5f;
+    const float gunY = m_boss.rect.y + m_boss.rect.h * 0.75f;
+    for (bullet::EmitterId emitter : m_bossEmitters) m_bullets.moveEmitter(emitter, gunX, gunY);
+}
+
+// Fired at the ship's centre; bullets are dropped a little off screen
+void XenonGame::updateBullets(float dt) {
+    const SDL_FRect ship = m_ship.getRect();
+    const SDL_FPoint target{ship.x + ship.w * 0.5f, ship.y + ship.h * 0.5f};
+    const SDL_FRect bounds{-32.0f, -32.0f, m_ctx.width + 64.0f, m_ctx.height + 64.0f};
+    m_bullets.update(dt, tick(), target, bounds);
+}
+
+// All boss bullets in one draw call, tinted per pattern
+void XenonGame::renderBullets(SDL_Renderer* r) {
+    float w = 8.0f, h = 8.0f;
+    if (m_enemyProjectileTexture) SDL_GetTextureSize(m_enemyProjectileTexture, &w, &h);
+    m_bullets.render(r, m_enemyProjectileTexture, SDL_FRect{0.0f, 0.0f, w, h});
 }
 
 void XenonGame::renderBoss(SDL_Renderer* r) {
     if(m_boss.active && m_bossTexture) {
-        SDL_RenderTexture(r, m_bossTexture, nullptr, &m_boss.rect);
+        SDL_FRect src, at;
+        const SpriteSheet* sheet = m_ctx.textures->getSheet(m_bossTexture);
+        if (!sheet) {
+            draw::texture(r, m_bossTexture, nullptr, &m_boss.rect);
+        } else if (sheet->trim(nullptr, m_boss.rect, src, at)) {
+            draw::texture(r, m_bossTexture, &src, &at);
+        }
         // HP Bar
         SDL_FRect barBg = {m_boss.rect.x, m_boss.rect.y - 15.0f, m_boss.rect.w, 10.0f};
-        SDL_SetRenderDrawColor(r, 50, 0, 0, 255); SDL_RenderFillRect(r, &barBg);
+        SDL_SetRenderDrawColor(r, 50, 0, 0, 255); draw::fillRect(r, &barBg);
         float pct = (float)m_boss.hp / (float)m_boss.maxHp;
         SDL_FRect barFg = {m_boss.rect.x + 1.0f, m_boss.rect.y - 14.0f, (m_boss.rect.w - 2.0f) * pct, 8.0f};
-        SDL_SetRenderDrawColor(r, 255, 50, 50, 255); SDL_RenderFillRect(r, &barFg);
+        SDL_SetRenderDrawColor(r, 255, 50, 50, 255); draw::fillRect(r, &barFg);
     }
 }
 
 // PowerUps
 void XenonGame::spawnPowerUp(float x, float y) {
     if (randomFloat(0,100) > 60) return;
-    PowerUp p;
-    p.rect = {x, y, 32.0f, 32.0f};
-    p.src = {0.0f, 0.0f, 32.0f, 32.0f};
-    p.alive = true; p.speedY = 100.0f;
-    p.currentFrame = 0; p.totalFrames = 8; p.animTimer = 0.0f;
-
-    int r = rand() % 10;
-    if(r < 3) p.type = PowerUpType::Score;
-    else if(r < 6) p.type = PowerUpType::Weapon;
-    else if(r < 8) p.type = PowerUpType::Shield;
-    else p.type = PowerUpType::Life;
-    m_powerups.push_back(p);
-}
-
-void XenonGame::updatePowerUps(float dt) {
-    for(auto& p : m_powerups) {
-        p.rect.y += p.speedY * dt;
-        p.animTimer += dt;
-        if(p.animTimer > 0.1f) {
-            p.animTimer = 0.0f;
-            p.currentFrame = (p.currentFrame + 1) % p.totalFrames;
-            p.src.x = (float)p.currentFrame * 32.0f;
-        }
-        if(p.rect.y > m_ctx.height) p.alive = false;
-    }
-    m_powerups.erase(std::remove_if(m_powerups.begin(), m_powerups.end(), [](auto& p){ return !p.alive; }), m_powerups.end());
-}
 
-void XenonGame::renderPowerUps(SDL_Renderer* r) {
-    for(const auto& p : m_powerups) {
-        SDL_Texture* t = nullptr;
-        switch(p.type) {
-            case PowerUpType::Weapon: t = m_puWeaponTexture; break;
-            case PowerUpType::Shield: t = m_puShieldTexture; break;
-            case PowerUpType::Life:   t = m_puLifeTexture; break;
-            case PowerUpType::Score:  t = m_puScoreTexture; break;
-        }
-        if(t) SDL_RenderTexture(r, t, &p.src, &p.rect);
-    }
+    PowerUpType type;
+    SDL_Texture* tex;
+    anim::ClipId clip;
+    int r = static_cast<int>(m_rng() % 10);
+    if(r < 3)      { type = PowerUpType::Score;  tex = m_puScoreTexture;  clip = m_puScoreClip; }
+    else if(r < 6) { type = PowerUpType::Weapon; tex = m_puWeaponTexture; clip = m_puWeaponClip; }
+    else if(r < 8) { type = PowerUpType::Shield; tex = m_puShieldTexture; clip = m_puShieldClip; }
+    else           { type = PowerUpType::Life;   tex = m_puLifeTexture;   clip = m_puLifeClip; }
+
+    CullBounds bounds;
+    bounds.maxY = (float)m_ctx.height;
+    m_world.createDeferred(
+        Transform{{x, y, 32.0f, 32.0f}},
+        Velocity{0.0f, 100.0f},
+        Sprite{tex, tick(), clip, SpriteLayer::PowerUp},
+        bounds,
+        PowerUp{type});
 }
 
 void XenonGame::applyPowerUp(PowerUpType type) {
@@ -494,65 +859,143 @@ void XenonGame::applyPowerUp(PowerUpType type) {
         case PowerUpType::Score: m_score += 500; break;
         case PowerUpType::Weapon: if(m_weaponLevel < 2) m_weaponLevel++; break;
         case PowerUpType::Life: m_lives++; break;
-        case PowerUpType::Shield: m_hasShield = true; m_shieldTimer = SHIELD_DURATION; break;
+        case PowerUpType::Shield: raiseShield(SHIELD_DURATION); break;
     }
+    playSound(m_powerUpSound, m_ctx.width * 0.5f, 0.8f, 2);
 }
 
 // Collisions
 bool XenonGame::rectsOverlap(const SDL_FRect& a, const SDL_FRect& b) {
-    return SDL_HasRectIntersectionFloat(&a, &b);
+    return rectsIntersect(a, b);
 }
 
+// AABB first, then the pixel masks. Without a mask matching the drawn
+// size on both sides the box test decides.
+bool XenonGame::pixelsOverlap(const SDL_FRect& a, const CollisionMask* maskA, int frameA,
+                              const SDL_FRect& b, const CollisionMask* maskB, int frameB) {
+    return rectsOverlap(a, b) && narrowPhase(a, maskA, frameA, b, maskB, frameB);
+}
+
+// Pixel test for a pair whose boxes are already known to overlap
+bool XenonGame::narrowPhase(const SDL_FRect& a, const CollisionMask* maskA, int frameA,
+                            const SDL_FRect& b, const CollisionMask* maskB, int frameB) {
+    auto usable = [](const SDL_FRect& r, const CollisionMask* m) {
+        return m && m->frameWidth() == (int)r.w && m->frameHeight() == (int)r.h;
+    };
+    if (!usable(a, maskA) || !usable(b, maskB)) return true;
+
+    return masksOverlap(*maskA, frameA, (int)std::floor(a.x), (int)std::floor(a.y),
+                        *maskB, frameB, (int)std::floor(b.x), (int)std::floor(b.y));
+}
+
+// Packs the boxes of every enemy, asteroid and enemy projectile once,
+// so each missile and the ship test them with one batched call.
+void XenonGame::gatherCollisionTargets() {
+    const uint64_t now = tick();
+    auto frameOf = [this, now](const Sprite& s, const Collider& c) {
+        const SDL_FRect* src = m_clips.src(s.clip, s.startTick, now);
+        return c.mask && src ? c.mask->frameAt(*src) : 0;
+    };
+
+    m_enemyTargets.clear();      m_enemyBoxes.clear();
+    m_asteroidTargets.clear();   m_asteroidBoxes.clear();
+    m_projectileTargets.clear(); m_projectileBoxes.clear();
+
+    m_enemies.each([&](ecs::Entity e, const Transform& t, const Sprite& s, const Collider& c, Health& h, Enemy&) {
+        m_enemyTargets.push_back({e, t.rect, c.mask, frameOf(s, c), &h});
+        m_enemyBoxes.push(t.rect);
+    });
+    m_asteroids.each([&](ecs::Entity a, const Transform& t, const Sprite& s, const Collider& c, Health& h, const AsteroidTag&) {
+        m_asteroidTargets.push_back({a, t.rect, c.mask, frameOf(s, c), &h});
+        m_asteroidBoxes.push(t.rect);
+    });
+    m_enemyProjectiles.each([&](ecs::Entity p, const Transform& t, const Collider& c, const EnemyProjectileTag&) {
+        m_projectileTargets.push_back({p, t.rect, c.mask, 0, nullptr});
+        m_projectileBoxes.push(t.rect);
+    });
+}
+
+// Destroyed entities stay in their chunks until the next flush,
+// so an hp of 0 marks enemies and asteroids that are already dead.
 void XenonGame::checkCollisions() {
-    SDL_FRect sRect = m_ship.getRect();
-    sRect.x += 10; sRect.w -= 20; sRect.y += 10; sRect.h -= 20;
+    const SDL_FRect sRect = m_ship.getRect();
+    const CollisionMask* sMask = m_ship.getMask();
+    const int sFrame = m_ship.getFrame();
+
+    gatherCollisionTargets();
+
+    const uint64_t now = tick();
 
     // Missiles
-    for(auto& m : m_missiles) {
-        if(!m.alive) continue;
-        for(auto& e : m_enemies) {
-            if(!e.alive) continue;
-            if(rectsOverlap(m.rect, e.rect)) {
-                m.alive = false; e.hp--;
-                if(e.hp <= 0) {
-                    e.alive = false;
+    m_missiles.each([&](ecs::Entity missile, const Transform& m, const Sprite& ms, const Collider& mc, const MissileTag&) {
+        bool alive = true;
+        const SDL_FRect* src = m_clips.src(ms.clip, ms.startTick, now);
+        const int mFrame = mc.mask && src ? mc.mask->frameAt(*src) : 0;
+
+        m_enemyBoxes.overlaps(m.rect, m_hits);
+        forEachHit(m_hits, [&](size_t i) {
+            CollisionTarget& e = m_enemyTargets[i];
+            if(!alive || e.health->hp <= 0) return;
+            if(narrowPhase(m.rect, mc.mask, mFrame, e.rect, e.mask, e.frame)) {
+                alive = false; e.health->hp--;
+                if(e.health->hp <= 0) {
+                    m_world.destroyDeferred(e.entity);
                     spawnExplosion(e.rect.x + 32, e.rect.y + 32);
                     spawnPowerUp(e.rect.x, e.rect.y);
                     m_score += 100;
                 }
-                break;
             }
-        }
-        if(!m.alive) continue;
-        for(auto& a : m_asteroids) {
-            if(!a.alive) continue;
-            if(rectsOverlap(m.rect, a.rect)) {
-                m.alive = false; a.hp--;
-                if(a.hp <= 0) {
-                    a.alive = false;
+        });
+        m_asteroidBoxes.overlaps(m.rect, m_hits);
+        forEachHit(m_hits, [&](size_t i) {
+            CollisionTarget& a = m_asteroidTargets[i];
+            if(!alive || a.health->hp <= 0) return;
+            if(narrowPhase(m.rect, mc.mask, mFrame, a.rect, a.mask, a.frame)) {
+                alive = false; a.health->hp--;
+                if(a.health->hp <= 0) {
+                    m_world.destroyDeferred(a.entity);
                     spawnExplosion(a.rect.x + a.rect.w/2, a.rect.y + a.rect.h/2);
                     m_score += 50;
                 }
-                break;
             }
-        }
-        if(m_boss.active && rectsOverlap(m.rect, m_boss.rect)) {
-            m.alive = false; m_boss.hp--;
+        });
+        const CollisionMask* bossMask = m_bossMask.empty() ? nullptr : &m_bossMask;
+        if(alive && m_boss.active && pixelsOverlap(m.rect, mc.mask, mFrame, m_boss.rect, bossMask, 0)) {
+            alive = false; m_boss.hp--;
             if(m_boss.hp <= 0) {
                 m_boss.active = false;
+                m_bullets.clear();
                 spawnExplosion(m_boss.rect.x+64, m_boss.rect.y+64);
                 m_gameState = GameState::Victory;
             }
         }
-    }
+        if(!alive) m_world.destroyDeferred(missile);
+    });
 
     // Player Hits
-    for(auto& p : m_enemyProjectiles) if(p.alive && rectsOverlap(p.rect, sRect)) { p.alive = false; onPlayerHit(); }
-    for(auto& e : m_enemies) if(e.alive && rectsOverlap(e.rect, sRect)) { e.alive = false; onPlayerHit(); spawnExplosion(e.rect.x+32, e.rect.y+32); }
-    for(auto& a : m_asteroids) if(a.alive && rectsOverlap(a.rect, sRect)) { a.alive = false; onPlayerHit(); spawnExplosion(a.rect.x+32, a.rect.y+32); }
+    m_projectileBoxes.overlaps(sRect, m_hits);
+    forEachHit(m_hits, [&](size_t i) {
+        const CollisionTarget& p = m_projectileTargets[i];
+        if(narrowPhase(p.rect, p.mask, 0, sRect, sMask, sFrame)) { m_world.destroyDeferred(p.entity); onPlayerHit(); }
+    });
+    const SDL_FRect hitbox{sRect.x + (sRect.w - BULLET_HITBOX) * 0.5f, sRect.y + (sRect.h - BULLET_HITBOX) * 0.5f,
+                           BULLET_HITBOX, BULLET_HITBOX};
+    if (m_bullets.collide(hitbox) > 0) onPlayerHit();
+    m_enemyBoxes.overlaps(sRect, m_hits);
+    forEachHit(m_hits, [&](size_t i) {
+        CollisionTarget& e = m_enemyTargets[i];
+        if(e.health->hp > 0 && narrowPhase(e.rect, e.mask, e.frame, sRect, sMask, sFrame)) { e.health->hp = 0; m_world.destroyDeferred(e.entity); onPlayerHit(); spawnExplosion(e.rect.x+32, e.rect.y+32); }
+    });
+    m_asteroidBoxes.overlaps(sRect, m_hits);
+    forEachHit(m_hits, [&](size_t i) {
+        CollisionTarget& a = m_asteroidTargets[i];
+        if(a.health->hp > 0 && narrowPhase(a.rect, a.mask, a.frame, sRect, sMask, sFrame)) { a.health->hp = 0; m_world.destroyDeferred(a.entity); onPlayerHit(); spawnExplosion(a.rect.x+32, a.rect.y+32); }
+    });
     
-    // Powerups
-    for(auto& p : m_powerups) if(p.alive && rectsOverlap(p.rect, sRect)) { p.alive = false; applyPowerUp(p.type); }
+    // Powerups: generous pickup on the ship's box
+    m_powerups.each([&](ecs::Entity p, const Transform& t, const PowerUp& pu) {
+        if(rectsOverlap(t.rect, sRect)) { m_world.destroyDeferred(p); applyPowerUp(pu.type); }
+    });
 }
 
 void XenonGame::onPlayerHit() {
@@ -560,71 +1003,164 @@ void XenonGame::onPlayerHit() {
     m_lives--;
     spawnExplosion(m_ship.getRect().x + 32, m_ship.getRect().y + 32);
     if(m_lives <= 0) m_gameState = GameState::GameOver;
-    else { m_hasShield = true; m_shieldTimer = 2.0f; }
+    else raiseShield(2.0f);
+}
+
+void XenonGame::raiseShield(float seconds) {
+    m_hasShield = true;
+    m_timers.cancel(m_shieldOff);
+    m_shieldOff = m_timers.schedule(tick() + ticksFor(seconds), {static_cast<uint16_t>(TimerKind::ShieldOff), 0});
 }
 
 // Explosions
 void XenonGame::spawnExplosion(float cx, float cy) {
     if(!m_explosionTexture) return;
-    Explosion ex;
-    ex.alive = true; ex.currentFrame = 0; ex.totalFrames = 8; ex.frameTime = 0;
-    ex.dst = {cx - 32.0f, cy - 32.0f, 64.0f, 64.0f};
-    ex.src = {0.0f, 0.0f, 64.0f, 64.0f};
-    m_explosions.push_back(ex);
-}
-
-void XenonGame::updateExplosions(float dt) {
-    for(auto& ex : m_explosions) {
-        if(!ex.alive) continue;
-        ex.frameTime += dt;
-        if(ex.frameTime >= 0.05f) {
-            ex.frameTime = 0;
-            ex.currentFrame++;
-            if(ex.currentFrame >= ex.totalFrames) ex.alive = false;
-            ex.src.x = (float)ex.currentFrame * 64.0f;
-        }
-    }
-    m_explosions.erase(std::remove_if(m_explosions.begin(), m_explosions.end(), [](auto& e){ return !e.alive; }), m_explosions.end());
+    if(m_expiry.count() >= static_cast<size_t>(quality().maxExplosions)) return;
+    m_world.createDeferred(
+        Transform{{cx - 32.0f, cy - 32.0f, 64.0f, 64.0f}},
+        Sprite{m_explosionTexture, tick(), m_explosionClip, SpriteLayer::Explosion},
+        Lifetime{tick() + m_clips.duration(m_explosionClip)});
+    playSound(m_explosionSound, cx, 0.7f, 1);
 }
 
-void XenonGame::renderExplosions(SDL_Renderer* r) {
-    for(const auto& ex : m_explosions) SDL_RenderTexture(r, m_explosionTexture, &ex.src, &ex.dst);
+// Snapshots
+//
+// Scalars are written one by one (bools as bytes) so struct padding
+// never reaches the bytes; the world writes its own columns.
+static_assert(std::is_trivially_copyable_v<std::mt19937>);
+
+void XenonGame::saveState(GameSnapshot& out) {
+    m_world.flush();
+    out.bytes.clear();
+    snapshot::Writer w(out.bytes);
+
+    w.put(tick());
+    w.put(static_cast<int32_t>(m_gameState));
+    w.put(static_cast<uint8_t>(m_gameOver));
+    w.put(m_weaponLevel);
+    w.put(m_lives);
+    w.put(m_score);
+    w.put(static_cast<uint8_t>(m_hasShield));
+    w.put(m_shieldOff);
+    w.put(m_missileReadyTick);
+    m_timers.save(w);
+
+    w.put(m_boss.rect);
+    w.put(m_boss.hp);
+    w.put(m_boss.maxHp);
+    w.put(static_cast<uint8_t>(m_boss.active));
+    w.put(m_boss.glide);
+
+    w.put(m_rng);
+    m_ship.saveState(w);
+    m_bullets.save(w);
+    w.put(m_bossEmitters);
+    m_scripts.save(w);
+
+    m_parallax.save(w);
+
+    m_world.save(w);
 }
 
-// Dust
-void XenonGame::initDustBackground() {
-    SDL_Texture* dusts[] = {
-        m_ctx.textures->load("graphics/GDust.bmp"),
-        m_ctx.textures->load("graphics/MDust.bmp"),
-        m_ctx.textures->load("graphics/SDust.bmp")
-    };
-    for(int i=0; i<3; ++i) {
-        if(!dusts[i]) continue;
-        SDL_SetTextureAlphaMod(dusts[i], 150 + i*30);
-        for(int j=0; j<20; ++j) {
-            DustParticle p;
-            p.texture = dusts[i];
-            p.rect = {randomFloat(0, m_ctx.width), randomFloat(0, m_ctx.height), 32.0f, 32.0f};
-            p.src = {0, 0, 32, 32}; 
-            p.speed = 50.0f + i*20.0f;
-            m_dustParticles.push_back(p);
-        }
+bool XenonGame::restoreState(const GameSnapshot& in) {
+    snapshot::Reader r(in.bytes.data(), in.bytes.size());
+
+    uint64_t savedTick = 0;
+    int32_t  gameState = 0;
+    uint8_t  gameOver = 0, hasShield = 0, bossActive = 0;
+    r.get(savedTick);
+    r.get(gameState);
+    r.get(gameOver);
+    r.get(m_weaponLevel);
+    r.get(m_lives);
+    r.get(m_score);
+    r.get(hasShield);
+    r.get(m_shieldOff);
+    r.get(m_missileReadyTick);
+    m_timers.load(r);
+
+    r.get(m_boss.rect);
+    r.get(m_boss.hp);
+    r.get(m_boss.maxHp);
+    r.get(bossActive);
+    r.get(m_boss.glide);
+
+    r.get(m_rng);
+    m_ship.loadState(r);
+    m_bullets.load(r);
+    r.get(m_bossEmitters);
+    m_scripts.load(r, [this](script::Tag tag) { return makeScript(tag); });
+
+    m_parallax.load(r);
+
+    if (!r.ok() || !m_world.load(r) || !r.finished()) {
+        LOG_ERROR("[XenonGame] Snapshot could not be restored");
+        return false;
     }
+
+    m_gameState  = static_cast<GameState>(gameState);
+    m_gameOver   = gameOver != 0;
+    m_hasShield  = hasShield != 0;
+    m_boss.active = bossActive != 0;
+    // wraps around when the engine is ahead of the saved tick
+    m_tickOffset = savedTick - *m_ctx.tick;
+    return true;
 }
 
-void XenonGame::updateDust(float dt) {
-    for(auto& p : m_dustParticles) {
-        p.rect.y += p.speed * dt;
-        if(p.rect.y > m_ctx.height) p.rect.y = -32.0f;
+// Benchmark scene
+void XenonGame::populateBenchmarkScene(int count, uint32_t seed) {
+    m_rng.seed(seed);
+
+    m_gameState = GameState::Playing;
+    m_boss.active = false;
+    m_bullets.clear();
+    m_scripts.stopAll();
+    m_world.clear();
+    m_parallax.resetScroll();
+
+    struct Kind { SDL_Texture* texture; anim::ClipId clip; float size; SpriteLayer layer; };
+    const Kind kinds[] = {
+        {m_asteroidSTexture,       m_asteroidSClip,       32.0f, SpriteLayer::Asteroid},
+        {m_asteroidMTexture,       m_asteroidMClip,       64.0f, SpriteLayer::Asteroid},
+        {m_asteroidGTexture,       m_asteroidGClip,       96.0f, SpriteLayer::Asteroid},
+        {m_puScoreTexture,         m_puScoreClip,         32.0f, SpriteLayer::PowerUp},
+        {m_lonerTexture,           m_lonerClip,           64.0f, SpriteLayer::Enemy},
+        {m_rusherTexture,          m_rusherClip,          64.0f, SpriteLayer::Enemy},
+        {m_missileTexture,         m_missileClip,          8.0f, SpriteLayer::Missile},
+        {m_enemyProjectileTexture, m_enemyProjectileClip,  8.0f, SpriteLayer::EnemyProjectile},
+        {m_explosionTexture,       m_explosionClip,       64.0f, SpriteLayer::Explosion},
+    };
+    constexpr int KIND_COUNT = sizeof(kinds) / sizeof(kinds[0]);
+
+    for (int i = 0; i < count; ++i) {
+        const Kind& k = kinds[i % KIND_COUNT];
+        const float h = k.layer == SpriteLayer::Missile ? 16.0f : k.size;
+        const SDL_FRect rect{randomFloat(-k.size, (float)m_ctx.width), randomFloat(-h, (float)m_ctx.height), k.size, h};
+        // spread the start ticks so the clips are out of phase
+        const uint64_t phase = m_rng() % 60;
+        const uint64_t start = tick() > phase ? tick() - phase : 0;
+        m_world.createDeferred(Transform{rect}, Sprite{k.texture, start, k.clip, k.layer});
     }
+    m_world.flush();
 }
 
-void XenonGame::renderDust(SDL_Renderer* r) {
-    for(const auto& p : m_dustParticles) SDL_RenderTexture(r, p.texture, nullptr, &p.rect);
+// Dust
+void XenonGame::initDustBackground() {
+    m_parallax.init(*m_ctx.textures, m_ctx.renderer, m_ctx.width, m_ctx.height);
+    uint32_t seed = 1;
+    for (const DustLayer& layer : s_dustLayers) {
+        parallax::LayerDesc desc;
+        desc.sprite = m_ctx.textures->load(layer.sprite);
+        desc.count  = layer.count;
+        desc.speed  = layer.speed;
+        desc.alpha  = layer.alpha;
+        desc.seed   = seed++;
+        if (!m_parallax.addLayer(desc)) LOG_WARN("[XenonGame] No dust layer from %s", layer.sprite);
+    }
 }
 
 // HUD
-void XenonGame::drawText(SDL_Renderer* r, float x, float y, const std::string& text) {
+void XenonGame::drawText(SDL_Renderer* r, float x, float y, std::string_view text) {
     if(!m_fontTexture) return;
     SDL_FRect dst = {x, y, 16.0f, 16.0f};
     SDL_FRect src = {0.0f, 0.0f, 8.0f, 8.0f};
@@ -632,24 +1168,25 @@ void XenonGame::drawText(SDL_Renderer* r, float x, float y, const std::string& t
         int idx = (unsigned char)c - 32; if(idx < 0) idx = 0;
         src.x = (idx % 16) * 8.0f;
         src.y = (idx / 16) * 8.0f;
-        SDL_RenderTexture(r, m_fontTexture, &src, &dst);
+        draw::texture(r, m_fontTexture, &src, &dst);
         dst.x += 16.0f;
     }
 }
 
 void XenonGame::renderHUD(SDL_Renderer* r) {
-    drawText(r, 10, 10, "SCORE:" + std::to_string(m_score));
+    drawText(r, 10, 10, m_ctx.frameArena->format("SCORE:%d", m_score));
     
     // Shield Bar (Green)
     float barW = 200.0f;
     SDL_FRect bg = {m_ctx.width - barW - 20, 10, barW, 20};
     SDL_SetRenderDrawColor(r, 50, 50, 50, 255);
-    SDL_RenderFillRect(r, &bg);
+    draw::fillRect(r, &bg);
     if(m_hasShield) {
-        float pct = m_shieldTimer / SHIELD_DURATION;
+        const uint64_t off = std::max(m_timers.dueTick(m_shieldOff), tick());
+        float pct = static_cast<float>(off - tick()) / ticksFor(SHIELD_DURATION);
         SDL_FRect fg = {bg.x+2, bg.y+2, (barW-4)*pct, 16};
         SDL_SetRenderDrawColor(r, 0, 255, 0, 255);
-        SDL_RenderFillRect(r, &fg);
+        draw::fillRect(r, &fg);
         drawText(r, bg.x, bg.y + 25, "SHIELD");
     } else {
         drawText(r, bg.x, bg.y + 25, "HULL");
@@ -657,9 +1194,10 @@ void XenonGame::renderHUD(SDL_Renderer* r) {
 
     if(m_gameState == GameState::GameOver) drawText(r, m_ctx.width/2-80, m_ctx.height/2, "GAME OVER - PRESS R");
     if(m_gameState == GameState::Victory) drawText(r, m_ctx.width/2-80, m_ctx.height/2, "VICTORY! - PRESS R");
+    if(m_paused) drawText(r, m_ctx.width/2-80, m_ctx.height/2, "PAUSED - PRESS P");
 }
 
-void XenonGame::renderText(SDL_Renderer* renderer, const std::string& text, float x, float y)
+void XenonGame::renderText(SDL_Renderer* renderer, std::string_view text, float x, float y)
 {
     if (!m_fontTexture) return;
 
@@ -681,6 +1219,6 @@ void XenonGame::renderText(SDL_Renderer* renderer, const std::string& text, floa
         dst.w = 8.0f;
         dst.h = 8.0f;
 
-        SDL_RenderTexture(renderer, m_fontTexture, &src, &dst);
+        draw::texture(renderer, m_fontTexture, &src, &dst);
     }
 }
\ No newline at end of file
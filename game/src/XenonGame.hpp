@@ -1,10 +1,26 @@
 #pragma once
 
+#include "Engine/Audio.hpp"
+#include "Engine/Bullets.hpp"
+#include "Engine/ECS.hpp"
+#include "Engine/EntitySystem.hpp"
 #include "Engine/Engine.hpp"
+#include "Engine/FlightRecorder.hpp"
+#include "Engine/FrameGovernor.hpp"
+#include "Engine/Parallax.hpp"
+#include "Engine/RectBatch.hpp"
+#include "Engine/Script.hpp"
+#include "Engine/Snapshot.hpp"
+#include "Engine/TimerWheel.hpp"
+#include "Components.hpp"
+#include "Policies.hpp"
 #include "ShipPawn.hpp"
 #include <SDL3/SDL.h>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
 #include <vector>
-#include <string>
+#include <string_view>
 
 enum class GameState {
     Playing,
@@ -13,20 +29,65 @@ enum class GameState {
     Victory
 };
 
+// One frame of player input, as the keyboard or a bot would give it
+struct PlayerInput {
+    int8_t moveX = 0;    // -1 left, 0, +1 right
+    int8_t moveY = 0;    // -1 up, 0, +1 down
+    bool   fire  = false;
+};
+
+// Whole game state as plain bytes: entities, timers, RNG and ship.
+// Equal states have equal bytes, so snapshots compare by hash().
+// Textures are stored as pointers: valid within this process only.
+struct GameSnapshot {
+    snapshot::Buffer bytes;
+
+    uint64_t hash() const { return snapshot::hash(bytes.data(), bytes.size()); }
+};
+
 class XenonGame : public IGame {
 public:
-    XenonGame() = default;
+    XenonGame();                          // random seed
+    explicit XenonGame(uint32_t seed);    // reproducible session
     ~XenonGame() override;
 
     bool init(const EngineContext& ctx) override;
     void handleEvent(const SDL_Event& e, bool& running) override;
     void update(float dt) override;
     void render(SDL_Renderer* renderer) override;
+    FramePacing pacing() override;
+    void exportState(shm::GameState& out) override;
+
+    // Deterministic scene for the offscreen render benchmark: 'count'
+    // sprites of every kind spread over the screen, dust reseeded.
+    void populateBenchmarkScene(int count, uint32_t seed);
+
+    // --- Scripted control (bots, VecEnv) ---
+    void restart();
+    void reset(uint32_t seed);             // restart with a new random stream
+    void applyInput(const PlayerInput& input);
+    void writeObservation(uint8_t* out, int width, int height);
+
+    // --- Snapshots (rollback, instant restart, save states) ---
+    // saveState reuses the snapshot's storage, so a kept snapshot
+    // costs no allocation after the first save.
+    void saveState(GameSnapshot& out);
+    bool restoreState(const GameSnapshot& in);
+
+    int  score() const    { return m_score; }
+    int  lives() const    { return m_lives; }
+    bool finished() const { return m_gameState == GameState::GameOver || m_gameState == GameState::Victory; }
 
 private:
     EngineContext m_ctx{};
+    std::mt19937  m_rng;                  // the only source of randomness
+    float randomFloat(float min, float max);
+
     GameState m_gameState = GameState::Playing;
 
+    // P, or the window being minimised; not part of snapshots
+    bool m_paused = false;
+
     // --- Ship ---
     ShipPawn m_ship;
     static constexpr int SHIP_FRAME_WIDTH  = 64;
@@ -38,165 +99,254 @@ private:
     
     // Shield
     bool m_hasShield = false;
-    float m_shieldTimer = 0.0f;
+    timer::TimerId m_shieldOff;
     static constexpr float SHIELD_DURATION = 10.0f;
+    void raiseShield(float seconds);
 
-    // --- Missiles ---
-    struct Missile {
-        SDL_FRect rect{};
-        SDL_FRect src{}; // Source rect for animation/frame selection
-        float speedY = 0.0f;
-        float speedX = 0.0f;
-        bool alive = false;
+    // --- Entities ---
+    // Missiles, enemies, projectiles, asteroids, power-ups and
+    // explosions all live in the ECS world; see Components.hpp.
+    // Chunks and bookkeeping come from the level pool, so steady-state
+    // spawning recycles memory instead of going to the system heap.
+    std::pmr::unsynchronized_pool_resource m_levelMemory;
+    ecs::World     m_world{&m_levelMemory};
+    ecs::Scheduler m_simulation;   // movement, enemy fire, culling, collisions
+    ecs::Scheduler m_effects;      // lifetimes, keep running after game over
+
+    // the generic passes, built from the policies in Policies.hpp
+    ecs::EntitySystem<ecs::Components<Transform, const Velocity>, Integrate>                m_movement{m_world, Integrate{}};
+    ecs::EntitySystem<ecs::Components<const Transform, const CullBounds>, CullOutside>      m_culling{m_world, CullOutside{&m_world}};
+    ecs::EntitySystem<ecs::Components<const Lifetime>, ExpireAt>                            m_expiry{m_world, ExpireAt{&m_world}};
+    ecs::EntitySystem<ecs::Components<const Transform, const Sprite>, DrawSprites>          m_spriteDrawing{m_world, DrawSprites{&m_clips}};
+
+    ecs::Query<Transform, const path::Follower>              m_followers{m_world};
+    ecs::Query<const Transform, const Sprite, const Collider, const MissileTag>          m_missiles{m_world};
+    ecs::Query<const Transform, const Sprite, const Collider, Health, Enemy>             m_enemies{m_world};
+    ecs::Query<const Transform, const Collider, const EnemyProjectileTag>                m_enemyProjectiles{m_world};
+    ecs::Query<const Transform, const Sprite, const Collider, Health, const AsteroidTag> m_asteroids{m_world};
+    ecs::Query<const Transform, const PowerUp>               m_powerups{m_world};
+
+    // --- Animation ---
+    // Every sprite entity draws through one of these clips. The game
+    // tick follows the engine tick, shifted when a snapshot is restored.
+    anim::ClipLibrary m_clips;
+    uint64_t m_tickOffset = 0;
+    uint64_t tick() const { return *m_ctx.tick + m_tickOffset; }
+    static uint32_t ticksFor(float seconds);
+
+    // --- Behaviour scripts ---
+    // Coroutines on the game tick (Engine/Script.hpp). The kind and
+    // argument are what a snapshot keeps of a script.
+    enum class ScriptKind : uint16_t {
+        LonerFire,   // arg: the loner entity
+        Boss
     };
-    std::vector<Missile> m_missiles;
+    script::Runtime m_scripts{Engine::s_fixedTimeStep};
+
+    script::Task makeScript(script::Tag tag);
+    script::Task lonerFire(ecs::Entity self);
+    script::Task bossScript();
+
+    // co_await-able: glides from where 'glide' is now to (x, y)
+    script::Wait moveTo(path::Glide& glide, float x, float y, float seconds);
+    // starts 'pattern' at the boss's gun
+    bullet::EmitterId fire(bullet::PatternId pattern);
+
+    // --- Timers ---
+    // Spawn waves and the shield on the game tick (Engine/TimerWheel.hpp)
+    enum class TimerKind : uint16_t {
+        LonerWave,
+        RusherWave,
+        AsteroidWave,
+        ShieldOff
+    };
+    timer::Wheel m_timers;
+
+    void onTimer(const timer::Timer& t);
+    void scheduleTimer(TimerKind kind, float seconds);
+
+    // --- Movement paths ---
+    // Enemies follow curves from this table; see definePaths()
+    path::PathLibrary       m_paths;
+    std::vector<SDL_FPoint> m_pathPositions;   // one chunk's worth, reused
+    path::PathId m_lonerSweepRight = 0;
+    path::PathId m_lonerSweepLeft  = 0;
+    path::PathId m_rusherDiveRight = 0;
+    path::PathId m_rusherDiveLeft  = 0;
+
+    // --- Missiles ---
     SDL_Texture* m_missileTexture = nullptr;
-    float m_missileCooldown = 0.0f;
+    anim::ClipId m_missileClip = 0;
+    uint64_t m_missileReadyTick = 0;
 
     // --- Enemies ---
-    enum class EnemyType { Loner, Rusher };
-    struct Enemy {
-        EnemyType type = EnemyType::Loner;
-        SDL_FRect src{};
-        SDL_FRect rect{};
-        float speedX = 0.0f;
-        float speedY = 0.0f;
-        int hp = 1;
-        bool alive = false;
-        float shootTimer = 0.0f;
-    };
     SDL_Texture* m_lonerTexture = nullptr;
     SDL_Texture* m_rusherTexture = nullptr;
-    std::vector<Enemy> m_enemies;
-    float m_lonerSpawnTimer = 0.0f;
-    float m_rusherSpawnTimer = 0.0f;
+    anim::ClipId m_lonerClip = 0;
+    anim::ClipId m_rusherClip = 0;
 
     // --- Enemy Projectiles ---
-    struct EnemyProjectile {
-        SDL_FRect rect{};
-        float speedY = 0.0f;
-        float speedX = 0.0f;
-        bool alive = false;
-    };
     SDL_Texture* m_enemyProjectileTexture = nullptr;
-    std::vector<EnemyProjectile> m_enemyProjectiles;
+    anim::ClipId m_enemyProjectileClip = 0;
+    CollisionMask m_enemyProjectileMask;   // scaled to the 8x8 draw size
 
     // --- Asteroids ---
-    enum class AsteroidSize { Small, Medium, Large };
-    struct Asteroid {
-        AsteroidSize size;
-        SDL_FRect rect;
-        SDL_FRect src;
-        float speedY;
-        int hp;
-        bool alive;
-        // Animation
-        int currentFrame;
-        int totalFrames;
-        float animTimer;
-    };
     SDL_Texture* m_asteroidSTexture = nullptr;
     SDL_Texture* m_asteroidMTexture = nullptr;
     SDL_Texture* m_asteroidGTexture = nullptr;
-    std::vector<Asteroid> m_asteroids;
-    float m_asteroidSpawnTimer = 0.0f;
+    anim::ClipId m_asteroidSClip = 0;
+    anim::ClipId m_asteroidMClip = 0;
+    anim::ClipId m_asteroidGClip = 0;
 
     // --- Boss ---
+    // Position follows 'glide'; where it goes is up to bossScript()
     struct Boss {
         SDL_FRect rect;
         int hp;
         int maxHp;
-        float shootTimer;
         bool active;
-        float dirX;
-    } m_boss;
+        path::Glide glide;
+    } m_boss{};
+    static constexpr float BOSS_Y = 50.0f;   // where the entry descent stops
     SDL_Texture* m_bossTexture = nullptr;
+    CollisionMask m_bossMask;              // scaled to the 128x128 draw size
+
+    // --- Boss bullets ---
+    // Pooled outside the ECS, see Engine/Bullets.hpp. The boss script
+    // opens fire once the boss is in position; the emitters ride along.
+    bullet::BulletSystem m_bullets;
+    bullet::PatternId m_bossFan      = 0;
+    bullet::PatternId m_bossSpiral   = 0;
+    bullet::PatternId m_bossSplitter = 0;
+    bullet::PatternId m_bossShard    = 0;
+    bullet::EmitterId m_bossEmitters[3];
+    static constexpr float BULLET_HITBOX = 24.0f;   // centre of the ship, bullet-hell style
 
     // --- PowerUps ---
-    enum class PowerUpType { Weapon, Shield, Score, Life };
-    struct PowerUp {
-        PowerUpType type;
-        SDL_FRect rect;
-        SDL_FRect src;
-        float speedY;
-        bool alive;
-        int currentFrame;
-        int totalFrames;
-        float animTimer;
-    };
     SDL_Texture* m_puWeaponTexture = nullptr;
     SDL_Texture* m_puShieldTexture = nullptr;
     SDL_Texture* m_puScoreTexture = nullptr;
     SDL_Texture* m_puLifeTexture = nullptr;
-    std::vector<PowerUp> m_powerups;
+    anim::ClipId m_puWeaponClip = 0;
+    anim::ClipId m_puShieldClip = 0;
+    anim::ClipId m_puScoreClip = 0;
+    anim::ClipId m_puLifeClip = 0;
 
     // --- Explosions ---
-    struct Explosion {
-        SDL_FRect src;
-        SDL_FRect dst;
-        float frameTime;
-        int currentFrame;
-        int totalFrames;
-        bool alive;
-    };
     SDL_Texture* m_explosionTexture = nullptr;
-    std::vector<Explosion> m_explosions;
+    anim::ClipId m_explosionClip = 0;
+
+    // --- Sound ---
+    // From sounds/*.wav when present, otherwise made up at init
+    audio::SoundId m_missileSound   = audio::NoSound;
+    audio::SoundId m_explosionSound = audio::NoSound;
+    audio::SoundId m_powerUpSound   = audio::NoSound;
+
+    // --- Hitch recorder counters (EngineContext::recorder) ---
+    flight::CounterId m_entityCounter    = 0;
+    flight::CounterId m_bulletCounter    = 0;
+    flight::CounterId m_explosionCounter = 0;
+
+    // --- Quality scaling ---
+    // Optional work per FrameGovernor level (FrameStats::quality).
+    // Only presentation changes, apart from the explosion cap.
+    struct QualitySettings {
+        int  dustLayers;      // nearest parallax layers drawn, of s_dustLayers
+        int  maxExplosions;   // live at once; further ones are skipped
+        bool galaxy;          // full-screen background image
+    };
+    static const QualitySettings s_quality[FrameGovernor::LEVEL_COUNT];
+    int m_qualityLevel = 0;
+    const QualitySettings& quality() const { return s_quality[m_qualityLevel]; }
+    void updateQuality();
 
     // --- Dust / Background ---
-    struct DustParticle {
-        SDL_Texture* texture = nullptr;
-        SDL_FRect rect{};
-        SDL_FRect src{}; // Added src to prevent multiplying
-        float speed = 0.0f;
+    // Parallax layers, deepest first. Each is baked into one tile, so
+    // more particles or more layers cost nothing per particle.
+    struct DustLayer {
+        const char* sprite;
+        int         count;
+        float       speed;   // pixels per second
+        uint8_t     alpha;
     };
-    std::vector<DustParticle> m_dustParticles;
+    static const DustLayer s_dustLayers[];
+    parallax::Background m_parallax;
+
+    // Refresh while paused or finished: the dust drifts on at IDLE_DUST_HZ,
+    // a scene with none drawn only needs IDLE_STILL_HZ (input redraws sooner)
+    static constexpr float IDLE_DUST_HZ  = 10.0f;
+    static constexpr float IDLE_STILL_HZ = 1.0f;
     SDL_Texture* m_galaxyTexture = nullptr;
 
     // --- Methods ---
+    void registerSystems();
+    void renderSprites(SDL_Renderer* renderer, SpriteLayer layer);
+
     void fireMissile();
-    void updateMissiles(float dt);
-    void renderMissiles(SDL_Renderer* renderer);
 
     void spawnLoner();
     void spawnRusher();
-    void updateEnemies(float dt);
-    void renderEnemies(SDL_Renderer* renderer);
 
     void fireEnemyProjectile(const SDL_FRect& sourceRect, float speedY, float speedX = 0.0f);
-    void updateEnemyProjectiles(float dt);
-    void renderEnemyProjectiles(SDL_Renderer* renderer);
 
     void spawnAsteroid();
-    void updateAsteroids(float dt);
-    void renderAsteroids(SDL_Renderer* renderer);
 
     void spawnBoss();
-    void updateBoss(float dt);
+    void updateBoss();
+    void updateBullets(float dt);
+    void renderBullets(SDL_Renderer* renderer);
     void renderBoss(SDL_Renderer* renderer);
 
     void spawnPowerUp(float x, float y);
-    void updatePowerUps(float dt);
-    void renderPowerUps(SDL_Renderer* renderer);
     void applyPowerUp(PowerUpType type);
 
     void spawnExplosion(float cx, float cy);
-    void updateExplosions(float dt);
-    void renderExplosions(SDL_Renderer* renderer);
+
+    void defineClips();
+    void definePaths();
+    void definePatterns();
+    void defineSounds();
+    void publishCounters();
+    void playSound(audio::SoundId sound, float x, float volume, uint8_t priority);
+    void followPaths();
 
     void initDustBackground();
-    void updateDust(float dt);
-    void renderDust(SDL_Renderer* renderer);
 
+    void gatherCollisionTargets();
     void checkCollisions();
     void onPlayerHit();
     bool rectsOverlap(const SDL_FRect& a, const SDL_FRect& b);
+    bool pixelsOverlap(const SDL_FRect& a, const CollisionMask* maskA, int frameA,
+                       const SDL_FRect& b, const CollisionMask* maskB, int frameB);
+    bool narrowPhase(const SDL_FRect& a, const CollisionMask* maskA, int frameA,
+                     const SDL_FRect& b, const CollisionMask* maskB, int frameB);
+
+    // Collision scratch, rebuilt by gatherCollisionTargets(); index i of
+    // a target list matches rect i of its batch
+    struct CollisionTarget {
+        ecs::Entity          entity;
+        SDL_FRect            rect;
+        const CollisionMask* mask;
+        int                  frame;
+        Health*              health;   // null for projectiles
+    };
+    std::vector<CollisionTarget> m_enemyTargets;
+    std::vector<CollisionTarget> m_asteroidTargets;
+    std::vector<CollisionTarget> m_projectileTargets;
+    RectBatch                    m_enemyBoxes;
+    RectBatch                    m_asteroidBoxes;
+    RectBatch                    m_projectileBoxes;
+    std::vector<uint64_t>        m_hits;
 
     // HUD
     SDL_Texture* m_fontTexture = nullptr;
     SDL_Texture* m_lifeIconTexture = nullptr;
-    void drawText(SDL_Renderer* r, float x, float y, const std::string& text);
+    void drawText(SDL_Renderer* r, float x, float y, std::string_view text);
     void renderHUD(SDL_Renderer* r);
 
-    void renderText(SDL_Renderer* renderer, const std::string& text, float x, float y);
+    void renderText(SDL_Renderer* renderer, std::string_view text, float x, float y);
     bool m_gameOver = false;
+
+    // state right after init(); restart() returns to it
+    GameSnapshot m_initialState;
 };
\ No newline at end of file
@@ -1,18 +1,72 @@
 #include "Engine/Engine.hpp"
+#include "Engine/Log.hpp"
+#include "Engine/Trace.hpp"
+#include "Benchmarks.hpp"
 #include "XenonGame.hpp"
 
+#include <cstdlib>
+#include <cstring>
+
 int main(int argc, char* argv[])
 {
-    (void)argc;
-    (void)argv;
+    if (argc >= 3 && std::strcmp(argv[1], "--bench") == 0) {
+        BenchOptions options;
+        for (int i = 3; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--record") == 0) {
+                options.record = true;
+            } else if (std::strcmp(argv[i], "--reference") == 0 && i + 1 < argc) {
+                options.renderReference = argv[++i];
+            }
+        }
+        return runBenchmark(argv[2], options);
+    }
+
+    // --trace <file> records from startup; F9 toggles it at runtime.
+    // --log <file> writes the log there instead of stderr.
+    // --async-physics steps Box2D on a worker thread.
+    // --hitch-ms <ms> sets the frame time that dumps the recent frames
+    // (0 turns it off), --hitch-dir <dir> where; see tools/hitch_report.
+    // --capture <file> records every frame (.y4m, otherwise raw RGBA);
+    // F10 toggles a capture at runtime.
+    // --export <name> publishes every frame and the game state to the
+    // shared memory object <name> (e.g. /xenon); see tools/export_reader.
+    // With SDL_VIDEO_DRIVER=dummy it runs headless.
+    bool asyncPhysics = false;
+    float hitchMs = flight::RecorderConfig{}.thresholdMs;
+    const char* hitchDir = ".";
+    const char* capturePath = nullptr;
+    const char* exportName = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--async-physics") == 0) asyncPhysics = true;
+    }
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace") == 0) {
+            trace::start(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--log") == 0) {
+            logging::setOutput(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--hitch-ms") == 0) {
+            hitchMs = static_cast<float>(std::atof(argv[i + 1]));
+        } else if (std::strcmp(argv[i], "--hitch-dir") == 0) {
+            hitchDir = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--capture") == 0) {
+            capturePath = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--export") == 0) {
+            exportName = argv[i + 1];
+        }
+    }
 
     XenonGame game;
     Engine engine(800, 600, "AGPT Project 1 - Xenon 2000", game);
 
     if (!engine.init()) {
+        trace::stop();
         return 1;
     }
 
+    engine.setAsyncPhysics(asyncPhysics);
+    engine.setHitchThreshold(hitchMs, hitchDir);
+    if (capturePath) engine.startCapture(capturePath);
+    if (exportName) engine.startExport(exportName);
     engine.run();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+// export_reader: follows the frames a game started with --export publishes
+//
+//     export_reader [--frames N] [--dump out.rgba] /xenon
+//
+// Once a second: frames read, frames the game published that were
+// skipped because the reader was busy, frames dropped as torn, the
+// mean brightness of the newest one and its game state. --dump
+// appends every frame read as raw RGBA. Stops after N frames or when
+// the game stops publishing.
+
+#include "Engine/SharedFrames.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto OPEN_TIMEOUT = std::chrono::seconds(10);   // for the game to start publishing
+constexpr auto POLL         = std::chrono::milliseconds(1);
+
+// Reads every pixel in place, as a consumer would
+double meanBrightness(const shm::FrameView& frame)
+{
+    uint64_t sum = 0;
+    for (int y = 0; y < frame.height; ++y) {
+        const uint8_t* row = frame.pixels + static_cast<size_t>(y) * frame.pitch;
+        for (int x = 0; x < frame.width; ++x) sum += row[x * 4] + row[x * 4 + 1] + row[x * 4 + 2];
+    }
+    const double pixels = static_cast<double>(frame.width) * frame.height;
+    return pixels > 0.0 ? sum / (pixels * 3.0) : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    uint64_t    limit    = 0;
+    const char* dumpPath = nullptr;
+    const char* name     = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            limit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dumpPath = argv[++i];
+        } else {
+            name = argv[i];
+        }
+    }
+
+    if (!name) {
+        std::fprintf(stderr, "usage: export_reader [--frames N] [--dump out.rgba] <name>\n");
+        return 2;
+    }
+
+    shm::Reader reader;
+    const Clock::time_point giveUp = Clock::now() + OPEN_TIMEOUT;
+    while (!reader.open(name)) {
+        if (Clock::now() > giveUp) {
+            std::fprintf(stderr, "%s: nothing published\n", name);
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::printf("%s: %dx%d frames\n", name, reader.width(), reader.height());
+
+    FILE* dump = dumpPath ? std::fopen(dumpPath, "wb") : nullptr;
+    if (dumpPath && !dump) {
+        std::fprintf(stderr, "%s: cannot write\n", dumpPath);
+        return 1;
+    }
+    std::vector<uint8_t> copy;
+
+    uint64_t read = 0, skipped = 0, torn = 0, last = 0;
+    uint64_t readBefore = 0;
+    Clock::time_point nextReport = Clock::now() + std::chrono::seconds(1);
+    shm::FrameView frame;
+    while (limit == 0 || read < limit) {
+        if (!reader.latest(frame, last)) {
+            if (reader.closed() && !reader.latest(frame, last)) break;
+            std::this_thread::sleep_for(POLL);
+            continue;
+        }
+        if (last != 0) skipped += frame.sequence - last - 1;
+        last = frame.sequence;
+
+        const double brightness = meanBrightness(frame);
+        if (dump) copy.assign(frame.pixels, frame.pixels + static_cast<size_t>(frame.pitch) * frame.height);
+        if (!reader.valid(frame)) {
+            ++torn;   // lapped while reading: what was read is a mix of frames
+            continue;
+        }
+        ++read;
+        if (dump) std::fwrite(copy.data(), 1, copy.size(), dump);
+
+        if (Clock::now() >= nextReport) {
+            const shm::GameState& s = frame.state;
+            std::printf("%6llu fps  frame %llu tick %llu  skipped %llu torn %llu  brightness %5.1f  "
+                        "phase %d score %d lives %d ship (%.0f, %.0f)  entities %u enemies %u bullets %u\n",
+                        static_cast<unsigned long long>(read - readBefore),
+                        static_cast<unsigned long long>(frame.frameIndex), static_cast<unsigned long long>(s.tick),
+                        static_cast<unsigned long long>(skipped), static_cast<unsigned long long>(torn), brightness,
+                        s.phase, s.score, s.lives, s.shipX, s.shipY, s.entities, s.enemies, s.bullets);
+            readBefore = read;
+            nextReport += std::chrono::seconds(1);
+        }
+    }
+
+    if (dump) std::fclose(dump);
+    std::printf("%s: %llu frames read, %llu skipped, %llu torn%s\n", name, static_cast<unsigned long long>(read),
+                static_cast<unsigned long long>(skipped), static_cast<unsigned long long>(torn),
+                reader.closed() ? ", game stopped" : "");
+    return 0;
+}
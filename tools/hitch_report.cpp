@@ -0,0 +1,170 @@
+// hitch_report: summarises the dumps written by flight::Recorder
+//
+//     hitch_report [--top N] hitch-1234.xfr [more.xfr ...]
+//
+// For each dump: the hitch frame's sections next to the median of the
+// frames before it, the engine and game counters likewise, the N
+// slowest frames, and the input events of the frames leading up to
+// the hitch.
+
+#include "Engine/FlightRecorder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t EVENT_FRAMES = 10;   // frames before the hitch whose input is listed
+
+double median(std::vector<double> values)
+{
+    if (values.empty()) return 0.0;
+    const size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    return values[mid];
+}
+
+// Median of 'field' over every frame but the hitch
+double baseline(const flight::Dump& dump, const std::function<double(const flight::FrameRecord&)>& field)
+{
+    std::vector<double> values;
+    values.reserve(dump.frames.size());
+    for (size_t i = 0; i + 1 < dump.frames.size(); ++i) values.push_back(field(dump.frames[i]));
+    return median(std::move(values));
+}
+
+void row(const char* name, double hitch, double typical, const char* unit)
+{
+    const double ratio = typical > 0.0 ? hitch / typical : 0.0;
+    if (ratio > 0.0) {
+        std::printf("  %-16s %12.2f %12.2f %-3s %7.1fx\n", name, hitch, typical, unit, ratio);
+    } else {
+        std::printf("  %-16s %12.2f %12.2f %-3s\n", name, hitch, typical, unit);
+    }
+}
+
+const char* eventName(uint32_t type)
+{
+    switch (type) {
+    case SDL_EVENT_KEY_DOWN:             return "key down";
+    case SDL_EVENT_KEY_UP:               return "key up";
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:    return "mouse down";
+    case SDL_EVENT_MOUSE_BUTTON_UP:      return "mouse up";
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:  return "pad down";
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:    return "pad up";
+    default:                             return "event";
+    }
+}
+
+void report(const char* path, const flight::Dump& dump, size_t top)
+{
+    if (dump.frames.empty()) {
+        std::printf("%s: no frames\n\n", path);
+        return;
+    }
+
+    const flight::FrameRecord& hitch = dump.frames.back();
+    std::printf("%s: frame %llu (tick %llu) took %.1f ms, threshold %.1f ms, %zu frames recorded\n", path,
+                static_cast<unsigned long long>(hitch.frameIndex), static_cast<unsigned long long>(hitch.tick),
+                hitch.totalMs, dump.header.thresholdMs, dump.frames.size());
+
+    std::printf("\n  %-16s %12s %12s %-3s %8s\n", "", "hitch", "median", "", "");
+    row("total", hitch.totalMs, baseline(dump, [](const flight::FrameRecord& f) { return f.totalMs; }), "ms");
+    for (size_t s = 0; s < flight::SECTION_COUNT; ++s) {
+        row(flight::sectionName(static_cast<flight::Section>(s)), hitch.sectionMs[s],
+            baseline(dump, [s](const flight::FrameRecord& f) { return f.sectionMs[s]; }), "ms");
+    }
+
+    std::printf("\n");
+    row("allocations", static_cast<double>(hitch.allocations),
+        baseline(dump, [](const flight::FrameRecord& f) { return static_cast<double>(f.allocations); }), "");
+    row("allocated KB", hitch.allocatedBytes / 1024.0,
+        baseline(dump, [](const flight::FrameRecord& f) { return f.allocatedBytes / 1024.0; }), "");
+    row("arena KB", hitch.arenaBytes / 1024.0,
+        baseline(dump, [](const flight::FrameRecord& f) { return f.arenaBytes / 1024.0; }), "");
+    row("draw calls", hitch.drawCalls,
+        baseline(dump, [](const flight::FrameRecord& f) { return static_cast<double>(f.drawCalls); }), "");
+    row("physics steps", hitch.physicsSteps,
+        baseline(dump, [](const flight::FrameRecord& f) { return static_cast<double>(f.physicsSteps); }), "");
+    row("quality", hitch.quality,
+        baseline(dump, [](const flight::FrameRecord& f) { return static_cast<double>(f.quality); }), "");
+    for (size_t c = 0; c < dump.counterNames.size(); ++c) {
+        row(dump.counterNames[c].c_str(), hitch.counters[c],
+            baseline(dump, [c](const flight::FrameRecord& f) { return static_cast<double>(f.counters[c]); }), "");
+    }
+
+    std::vector<const flight::FrameRecord*> slowest;
+    slowest.reserve(dump.frames.size());
+    for (const flight::FrameRecord& f : dump.frames) slowest.push_back(&f);
+    top = std::min(top, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + top, slowest.end(),
+                      [](const flight::FrameRecord* a, const flight::FrameRecord* b) { return a->totalMs > b->totalMs; });
+
+    std::printf("\n  slowest frames:\n");
+    for (size_t i = 0; i < top; ++i) {
+        const flight::FrameRecord& f = *slowest[i];
+        std::printf("  %8llu %8.2f ms  at %8.3f s  (", static_cast<unsigned long long>(f.frameIndex), f.totalMs,
+                    f.startUs / 1e6);
+        for (size_t s = 0; s < flight::SECTION_COUNT; ++s) {
+            std::printf("%s%s %.2f", s ? ", " : "", flight::sectionName(static_cast<flight::Section>(s)), f.sectionMs[s]);
+        }
+        std::printf(")\n");
+    }
+
+    std::printf("\n  input in the last %zu frames:\n", EVENT_FRAMES);
+    bool any = false;
+    const size_t first = dump.frames.size() > EVENT_FRAMES ? dump.frames.size() - EVENT_FRAMES : 0;
+    for (size_t i = first; i < dump.frames.size(); ++i) {
+        const flight::FrameRecord& f = dump.frames[i];
+        const size_t kept = std::min<size_t>(f.eventCount, flight::MAX_EVENTS);
+        for (size_t e = 0; e < kept; ++e) {
+            const flight::InputEvent& ev = f.events[e];
+            const bool key = ev.type == SDL_EVENT_KEY_DOWN || ev.type == SDL_EVENT_KEY_UP;
+            std::printf("  %8llu  %-10s %s\n", static_cast<unsigned long long>(f.frameIndex), eventName(ev.type),
+                        key ? SDL_GetKeyName(static_cast<SDL_Keycode>(ev.code)) : std::to_string(ev.code).c_str());
+            any = true;
+        }
+        if (f.eventCount > kept) {
+            std::printf("  %8llu  and %zu more\n", static_cast<unsigned long long>(f.frameIndex), f.eventCount - kept);
+        }
+    }
+    if (!any) std::printf("  none\n");
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t top = 5;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (paths.empty()) {
+        std::fprintf(stderr, "usage: hitch_report [--top N] <hitch-*.xfr>...\n");
+        return 2;
+    }
+
+    int failed = 0;
+    for (const char* path : paths) {
+        flight::Dump dump;
+        if (!flight::readDump(path, dump)) {
+            std::fprintf(stderr, "%s: not a hitch dump\n", path);
+            ++failed;
+            continue;
+        }
+        report(path, dump, top);
+    }
+    return failed ? 1 : 0;
+}